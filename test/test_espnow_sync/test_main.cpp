@@ -0,0 +1,152 @@
+/*
+ * WLEDMM host test for the ESP-NOW sync transport (wled00/espnow_sync.h)
+ *
+ * Sync notifications are split with espNowSplitMessage(), sent through EspNowLoopback and
+ * reassembled by EspNowReassembler - the same path a notification takes between two nodes before
+ * espnow_sync.cpp hands it to handleSyncPacket() / handleNotifierPacket() in udp.cpp.
+ *
+ * run with: pio test -e native -f test_espnow_sync
+ */
+#include <unity.h>
+#include "espnow_sync.h"
+
+static const uint8_t macA[6] = {0x02, 0, 0, 0, 0, 0xA1};
+static const uint8_t macB[6] = {0x02, 0, 0, 0, 0, 0xB2};
+
+// notifier packet as built by notify() in udp.cpp: 41 bytes header, then segments
+static size_t makeNotifierPacket(uint8_t* buf, uint8_t segments, uint8_t segSize, uint8_t bri) {
+  size_t len = 41 + size_t(segments) * segSize;
+  for (size_t i = 0; i < len; i++) buf[i] = uint8_t(i * 7 + bri);
+  buf[0]  = 0;   // protocol 0 = WLED notifier
+  buf[1]  = 1;   // call mode
+  buf[2]  = bri;
+  buf[11] = 13;  // compatibility version byte
+  buf[39] = segments;
+  buf[40] = segSize;
+  return len;
+}
+
+// what handleSyncPacket() checks before calling handleNotifierPacket()
+static bool acceptedAsNotifier(const uint8_t* data, size_t len) {
+  return len >= 41 && data[0] == 0 && len >= 41 + size_t(data[39]) * data[40];
+}
+
+static EspNowReassembler* rx;
+static int lastType;
+
+void setUp(void) { delete rx; rx = new EspNowReassembler(); lastType = -1; } // fresh receiver for each test
+void tearDown(void) {}
+
+static bool sendAll(EspNowLoopback& link, uint8_t type, uint16_t seq, const uint8_t* msg, size_t len) {
+  return espNowSplitMessage(type, seq, msg, len, [&](const uint8_t* p, size_t l) {
+    int t = link.send(p, l);
+    if (t >= 0) lastType = t;
+    return true;
+  });
+}
+
+void test_notifier_roundtrip(void) {
+  uint8_t msg[ESPNOW_MAX_MESSAGE];
+  size_t len = makeNotifierPacket(msg, 16, 36, 128); // 617 bytes = 3 chunks
+  EspNowLoopback link(*rx, macA);
+  TEST_ASSERT_TRUE(sendAll(link, ESPNOW_MSG_SYNC, 1, msg, len));
+  TEST_ASSERT_EQUAL_UINT32(3, link.sent());
+  TEST_ASSERT_EQUAL_INT(ESPNOW_MSG_SYNC, lastType);
+  TEST_ASSERT_EQUAL_UINT32(len, rx->length(ESPNOW_MSG_SYNC));
+  TEST_ASSERT_EQUAL_MEMORY(msg, rx->message(ESPNOW_MSG_SYNC), len);
+  TEST_ASSERT_EQUAL_MEMORY(macA, rx->sender(ESPNOW_MSG_SYNC), 6);
+  TEST_ASSERT_TRUE(acceptedAsNotifier(rx->message(ESPNOW_MSG_SYNC), rx->length(ESPNOW_MSG_SYNC)));
+}
+
+void test_largest_message(void) {
+  uint8_t msg[ESPNOW_MAX_MESSAGE];
+  for (size_t i = 0; i < sizeof(msg); i++) msg[i] = uint8_t(i ^ (i >> 8));
+  EspNowLoopback link(*rx, macA);
+  TEST_ASSERT_TRUE(sendAll(link, ESPNOW_MSG_PIXELS, 7, msg, sizeof(msg)));
+  TEST_ASSERT_EQUAL_UINT32(ESPNOW_MAX_CHUNKS, link.sent());
+  TEST_ASSERT_EQUAL_INT(ESPNOW_MSG_PIXELS, lastType);
+  TEST_ASSERT_EQUAL_MEMORY(msg, rx->message(ESPNOW_MSG_PIXELS), sizeof(msg));
+  TEST_ASSERT_FALSE(espNowSplitMessage(ESPNOW_MSG_PIXELS, 8, msg, sizeof(msg) + 1, [](const uint8_t*, size_t) { return true; }));
+}
+
+void test_lost_chunk_drops_message(void) {
+  uint8_t msg[ESPNOW_MAX_MESSAGE];
+  size_t len = makeNotifierPacket(msg, 16, 36, 10);
+  EspNowLoopback lossy(*rx, macA, 2); // every 2nd packet is lost
+  sendAll(lossy, ESPNOW_MSG_SYNC, 1, msg, len);
+  TEST_ASSERT_EQUAL_INT(-1, lastType);
+  TEST_ASSERT_EQUAL_UINT32(0, rx->complete());
+
+  // next notification replaces the incomplete one and arrives intact
+  EspNowLoopback link(*rx, macA);
+  len = makeNotifierPacket(msg, 16, 36, 20);
+  sendAll(link, ESPNOW_MSG_SYNC, 2, msg, len);
+  TEST_ASSERT_EQUAL_INT(ESPNOW_MSG_SYNC, lastType);
+  TEST_ASSERT_EQUAL_UINT32(1, rx->dropped());
+  TEST_ASSERT_EQUAL_UINT8(20, rx->message(ESPNOW_MSG_SYNC)[2]); // brightness of the second one
+}
+
+void test_out_of_order_and_duplicates(void) {
+  uint8_t msg[ESPNOW_MAX_MESSAGE];
+  size_t len = makeNotifierPacket(msg, 40, 36, 99); // 1481 bytes = 7 chunks
+  uint8_t packets[ESPNOW_MAX_CHUNKS][ESPNOW_MAX_PACKET];
+  size_t  lens[ESPNOW_MAX_CHUNKS];
+  unsigned n = 0;
+  espNowSplitMessage(ESPNOW_MSG_SYNC, 3, msg, len, [&](const uint8_t* p, size_t l) {
+    memcpy(packets[n], p, l); lens[n++] = l; return true;
+  });
+  TEST_ASSERT_EQUAL_UINT(7, n);
+  int done = -1;
+  for (int i = n - 1; i >= 0; i--) {
+    TEST_ASSERT_EQUAL_INT(-1, done);
+    done = rx->push(macA, packets[i], lens[i]);
+    if (i == 3) TEST_ASSERT_EQUAL_INT(-1, rx->push(macA, packets[i], lens[i])); // duplicate is ignored
+  }
+  TEST_ASSERT_EQUAL_INT(ESPNOW_MSG_SYNC, done);
+  TEST_ASSERT_EQUAL_MEMORY(msg, rx->message(ESPNOW_MSG_SYNC), len);
+}
+
+void test_interleaved_senders(void) {
+  uint8_t msgA[ESPNOW_MAX_MESSAGE], msgB[ESPNOW_MAX_MESSAGE];
+  size_t lenA = makeNotifierPacket(msgA, 16, 36, 1);
+  size_t lenB = makeNotifierPacket(msgB, 16, 36, 2);
+  uint8_t pa[2][ESPNOW_MAX_PACKET]; size_t la[2]; unsigned na = 0;
+  espNowSplitMessage(ESPNOW_MSG_SYNC, 5, msgA, lenA, [&](const uint8_t* p, size_t l) { if (na < 2) { memcpy(pa[na], p, l); la[na] = l; } na++; return true; });
+  rx->push(macA, pa[0], la[0]);
+  rx->push(macA, pa[1], la[1]);
+  // node B starts sending before A's last chunk - A's message is given up, B's is complete
+  EspNowLoopback linkB(*rx, macB);
+  sendAll(linkB, ESPNOW_MSG_SYNC, 5, msgB, lenB);
+  TEST_ASSERT_EQUAL_INT(ESPNOW_MSG_SYNC, lastType);
+  TEST_ASSERT_EQUAL_MEMORY(macB, rx->sender(ESPNOW_MSG_SYNC), 6);
+  TEST_ASSERT_EQUAL_MEMORY(msgB, rx->message(ESPNOW_MSG_SYNC), lenB);
+  TEST_ASSERT_EQUAL_UINT32(1, rx->dropped());
+}
+
+void test_rejects_foreign_and_malformed(void) {
+  uint8_t pkt[ESPNOW_MAX_PACKET] = {'W', 'N', ESPNOW_VERSION, ESPNOW_MSG_SYNC, 0, 0, 0, 1, 0, 0, 10, 0};
+  TEST_ASSERT_EQUAL_INT(-1, rx->push(macA, pkt, 11));                    // shorter than header
+  pkt[2] = ESPNOW_VERSION + 1;
+  TEST_ASSERT_EQUAL_INT(-1, rx->push(macA, pkt, ESPNOW_HEADER_LEN + 10)); // other version
+  pkt[2] = ESPNOW_VERSION;
+  pkt[3] = ESPNOW_MSG_TYPES;
+  TEST_ASSERT_EQUAL_INT(-1, rx->push(macA, pkt, ESPNOW_HEADER_LEN + 10)); // unknown type
+  pkt[3] = ESPNOW_MSG_SYNC;
+  pkt[8] = 1;
+  TEST_ASSERT_EQUAL_INT(-1, rx->push(macA, pkt, ESPNOW_HEADER_LEN + 10)); // payload beyond message length
+  pkt[8] = 0;
+  TEST_ASSERT_EQUAL_INT(ESPNOW_MSG_SYNC, rx->push(macA, pkt, ESPNOW_HEADER_LEN + 10));
+  TEST_ASSERT_FALSE(acceptedAsNotifier(rx->message(ESPNOW_MSG_SYNC), rx->length(ESPNOW_MSG_SYNC))); // too short for handleSyncPacket()
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_notifier_roundtrip);
+  RUN_TEST(test_largest_message);
+  RUN_TEST(test_lost_chunk_drops_message);
+  RUN_TEST(test_out_of_order_and_duplicates);
+  RUN_TEST(test_interleaved_senders);
+  RUN_TEST(test_rejects_foreign_and_malformed);
+  delete rx;
+  return UNITY_END();
+}
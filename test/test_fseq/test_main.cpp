@@ -0,0 +1,249 @@
+/*
+ * WLEDMM host test for the .fseq reader (wled00/fseq.h)
+ *
+ * Header and compression block table parsing, and - built with WLED_ENABLE_FSEQ_ZSTD - the block by block zstd
+ * decoder the player uses: frames are read in order, after jumps and across block ends, like fseqReadFrame()
+ * in fseq_player.cpp does.
+ *
+ * run with: pio test -e native -f test_fseq           (header and block table)
+ *           pio test -e native_zstd -f test_fseq      (also zstd, needs libzstd)
+ */
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include "fseq.h"
+
+#define CHANNELS 30
+#define FRAMES   40
+
+static void put32(uint8_t* p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+
+// fixed header plus block table; the block table has "slots" entries, the unused ones are 0
+static std::vector<uint8_t> makeHeader(uint8_t compression, unsigned slots) {
+  uint16_t dataOffset = FSEQ_FIXED_HEADER + slots * 8;
+  std::vector<uint8_t> h(dataOffset, 0);
+  memcpy(h.data(), "PSEQ", 4);
+  h[4] = dataOffset & 0xFF; h[5] = dataOffset >> 8;
+  h[6] = 0; h[7] = 2;
+  h[8] = dataOffset & 0xFF; h[9] = dataOffset >> 8;
+  put32(&h[10], CHANNELS);
+  put32(&h[14], FRAMES);
+  h[18] = 25;
+  h[20] = compression | ((slots >> 8) << 4);
+  h[21] = slots & 0xFF;
+  return h;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_header_compression(void) {
+  FseqHeader hdr;
+  std::vector<uint8_t> h = makeHeader(FSEQ_COMPRESS_NONE, 0);
+  TEST_ASSERT_NULL(hdr.parse(h.data(), h.size()));
+  TEST_ASSERT_EQUAL_UINT32(CHANNELS, hdr.channels);
+  TEST_ASSERT_EQUAL_UINT32(h.size() + 5 * CHANNELS, hdr.frameOffset(5));
+
+  h = makeHeader(FSEQ_COMPRESS_ZLIB, 2);
+  TEST_ASSERT_NOT_NULL(hdr.parse(h.data(), h.size()));
+
+  h = makeHeader(FSEQ_COMPRESS_ZSTD, 300); // block count > 255 uses the high bits in byte 20
+  #ifdef WLED_ENABLE_FSEQ_ZSTD
+  TEST_ASSERT_NULL(hdr.parse(h.data(), h.size()));
+  TEST_ASSERT_EQUAL_UINT16(300, hdr.blocks);
+  TEST_ASSERT_EQUAL(FSEQ_FIXED_HEADER + 300 * 8, hdr.rangeTableOffset());
+  h = makeHeader(FSEQ_COMPRESS_ZSTD, 0);
+  TEST_ASSERT_NOT_NULL(hdr.parse(h.data(), h.size())); // compressed without blocks
+  #else
+  TEST_ASSERT_NOT_NULL(hdr.parse(h.data(), h.size()));
+  #endif
+}
+
+void test_block_table(void) {
+  FseqHeader hdr;
+  std::vector<uint8_t> h = makeHeader(FSEQ_COMPRESS_NONE, 0);
+  TEST_ASSERT_NULL(hdr.parse(h.data(), h.size()));
+  hdr.dataOffset = 100;
+
+  const uint32_t entries[5][2] = {{0, 50}, {10, 70}, {25, 20}, {0, 0}, {0, 0}};
+  FseqBlock blocks[5];
+  size_t count = 0;
+  uint32_t next = hdr.dataOffset;
+  for (unsigned i = 0; i < 5; i++) {
+    uint8_t e[8];
+    put32(e, entries[i][0]); put32(e + 4, entries[i][1]);
+    if (hdr.parseBlock(e, blocks[count], next)) count++;
+  }
+  TEST_ASSERT_EQUAL(3, count);
+  TEST_ASSERT_EQUAL_UINT32(100, blocks[0].offset);
+  TEST_ASSERT_EQUAL_UINT32(150, blocks[1].offset);
+  TEST_ASSERT_EQUAL_UINT32(220, blocks[2].offset);
+  TEST_ASSERT_EQUAL_UINT32(240, next);
+  TEST_ASSERT_NULL(hdr.checkBlocks(blocks, count));
+
+  TEST_ASSERT_EQUAL(0, FseqHeader::findBlock(blocks, count, 0));
+  TEST_ASSERT_EQUAL(0, FseqHeader::findBlock(blocks, count, 9));
+  TEST_ASSERT_EQUAL(1, FseqHeader::findBlock(blocks, count, 10));
+  TEST_ASSERT_EQUAL(1, FseqHeader::findBlock(blocks, count, 24));
+  TEST_ASSERT_EQUAL(2, FseqHeader::findBlock(blocks, count, 25));
+  TEST_ASSERT_EQUAL(2, FseqHeader::findBlock(blocks, count, FRAMES - 1));
+
+  blocks[1].frame = 30; blocks[2].frame = 20; // not ascending
+  TEST_ASSERT_NOT_NULL(hdr.checkBlocks(blocks, count));
+  blocks[0].frame = 5;
+  TEST_ASSERT_NOT_NULL(hdr.checkBlocks(blocks, count));
+}
+
+#ifdef WLED_ENABLE_FSEQ_ZSTD
+static uint8_t channelValue(uint32_t frame, uint32_t ch) { return uint8_t(frame * 31 + ch * 7 + (frame * ch) / 5); }
+
+// in-memory fseq file: header, block table, one zstd frame per block
+struct ZstdFile {
+  std::vector<uint8_t> data;
+  FseqHeader hdr;
+  std::vector<FseqBlock> blocks;
+  size_t pos = 0;
+
+  ZstdFile(const std::vector<uint32_t>& firstFrames, unsigned slots) {
+    data = makeHeader(FSEQ_COMPRESS_ZSTD, slots);
+    for (size_t b = 0; b < firstFrames.size(); b++) {
+      uint32_t first = firstFrames[b];
+      uint32_t last  = (b + 1 < firstFrames.size()) ? firstFrames[b+1] : FRAMES;
+      std::vector<uint8_t> raw;
+      for (uint32_t f = first; f < last; f++) for (uint32_t c = 0; c < CHANNELS; c++) raw.push_back(channelValue(f, c));
+      std::vector<uint8_t> comp(ZSTD_compressBound(raw.size()));
+      size_t len = ZSTD_compress(comp.data(), comp.size(), raw.data(), raw.size(), 3);
+      TEST_ASSERT_FALSE(ZSTD_isError(len));
+      put32(&data[FSEQ_FIXED_HEADER + b * 8], first);
+      put32(&data[FSEQ_FIXED_HEADER + b * 8 + 4], len);
+      data.insert(data.end(), comp.begin(), comp.begin() + len);
+    }
+    TEST_ASSERT_NULL(hdr.parse(data.data(), data.size()));
+    uint32_t next = hdr.dataOffset;
+    for (unsigned i = 0; i < hdr.blocks; i++) {
+      FseqBlock blk;
+      if (hdr.parseBlock(&data[FSEQ_FIXED_HEADER + i * 8], blk, next)) blocks.push_back(blk);
+    }
+    TEST_ASSERT_NULL(hdr.checkBlocks(blocks.data(), blocks.size()));
+    TEST_ASSERT_EQUAL(data.size(), next);
+  }
+
+  size_t read(uint8_t* buf, size_t len) {
+    size_t n = std::min(len, data.size() - pos);
+    memcpy(buf, &data[pos], n);
+    pos += n;
+    return n;
+  }
+};
+
+static void* testAlloc(void*, size_t size) { return malloc(size); }
+static void  testFree(void*, void* ptr) { free(ptr); }
+
+// same frame selection as fseqReadFrame() in fseq_player.cpp
+struct ZstdReader {
+  ZstdFile& file;
+  FseqZstd dec;
+  size_t block = 0;
+  int32_t next = -1;
+  unsigned restarts = 0;
+
+  ZstdReader(ZstdFile& f) : file(f) {
+    ZSTD_customMem mem = {testAlloc, testFree, nullptr};
+    TEST_ASSERT_TRUE(dec.begin(mem, 20));
+  }
+
+  const char* frame(uint32_t f, uint8_t* out) {
+    size_t blk = FseqHeader::findBlock(file.blocks.data(), file.blocks.size(), f);
+    if (next < 0 || blk != block || uint32_t(next) > f) {
+      file.pos = file.blocks[blk].offset;
+      dec.restart(file.blocks[blk].len);
+      block = blk;
+      next = file.blocks[blk].frame;
+      restarts++;
+    }
+    while (uint32_t(next) <= f) {
+      const char* err = dec.read(out, CHANNELS, [this](uint8_t* buf, size_t len) { return file.read(buf, len); });
+      if (err) { next = -1; return err; }
+      next++;
+    }
+    return nullptr;
+  }
+};
+
+static void assertFrame(uint32_t f, const uint8_t* out) {
+  uint8_t expected[CHANNELS];
+  for (uint32_t c = 0; c < CHANNELS; c++) expected[c] = channelValue(f, c);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, CHANNELS);
+}
+
+void test_zstd_sequential(void) {
+  ZstdFile file({0, 3, 17, 30}, 6); // small first block like xLights writes it, two unused table entries
+  ZstdReader reader(file);
+  uint8_t out[CHANNELS];
+  for (uint32_t f = 0; f < FRAMES; f++) {
+    TEST_ASSERT_NULL(reader.frame(f, out));
+    assertFrame(f, out);
+  }
+  TEST_ASSERT_EQUAL(4, reader.restarts); // one per block, no re-reads
+}
+
+void test_zstd_jumps(void) {
+  ZstdFile file({0, 10, 20, 30}, 4);
+  ZstdReader reader(file);
+  uint8_t out[CHANNELS];
+  const uint32_t order[] = {5, 6, 14, 2, 39, 0, 25, 26, 29, 30, 19};
+  for (uint32_t f : order) {
+    TEST_ASSERT_NULL(reader.frame(f, out));
+    assertFrame(f, out);
+  }
+  // loop: back to the start after the last frame
+  TEST_ASSERT_NULL(reader.frame(FRAMES - 1, out));
+  TEST_ASSERT_NULL(reader.frame(0, out));
+  assertFrame(0, out);
+}
+
+void test_zstd_broken_block(void) {
+  ZstdFile file({0, 20}, 2);
+  file.blocks[0].len -= 8; // truncated zstd frame
+  ZstdReader reader(file);
+  uint8_t out[CHANNELS];
+  const char* err = nullptr;
+  for (uint32_t f = 0; f < 20 && !err; f++) err = reader.frame(f, out);
+  TEST_ASSERT_NOT_NULL(err);
+  TEST_ASSERT_NULL(reader.frame(25, out)); // next block still plays
+  assertFrame(25, out);
+
+  ZstdFile shorter({0, 20}, 2);
+  shorter.blocks[1].frame = 25; // block 0 holds fewer frames than the table claims
+  ZstdReader reader2(shorter);
+  TEST_ASSERT_NULL(reader2.frame(19, out));
+  TEST_ASSERT_NOT_NULL(reader2.frame(22, out));
+}
+
+void test_zstd_window_limit(void) {
+  ZstdFile file({0}, 1);
+  FseqZstd dec;
+  ZSTD_customMem mem = {testAlloc, testFree, nullptr};
+  TEST_ASSERT_TRUE(dec.begin(mem, 10)); // 1KB window, the single block needs 1.2KB
+  file.pos = file.blocks[0].offset;
+  dec.restart(file.blocks[0].len);
+  uint8_t out[CHANNELS];
+  const char* err = nullptr;
+  for (uint32_t f = 0; f < FRAMES && !err; f++) err = dec.read(out, CHANNELS, [&file](uint8_t* buf, size_t len) { return file.read(buf, len); });
+  TEST_ASSERT_NOT_NULL(err);
+}
+#endif
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_header_compression);
+  RUN_TEST(test_block_table);
+  #ifdef WLED_ENABLE_FSEQ_ZSTD
+  RUN_TEST(test_zstd_sequential);
+  RUN_TEST(test_zstd_jumps);
+  RUN_TEST(test_zstd_broken_block);
+  RUN_TEST(test_zstd_window_limit);
+  #endif
+  return UNITY_END();
+}
@@ -0,0 +1,213 @@
+/*
+ * WLEDMM host test for the realtime recording format (wled00/rt_record.h)
+ *
+ * Packets of several streams go through RtDeltaCodec::encode() and RtByteRing into a byte stream, the way
+ * rtRecorderPacket() and the writer in rt_recorder.cpp produce a .wrt file; reading it back with RtRecord::read()
+ * and RtDeltaCodec::decode() has to give the original packets.
+ *
+ * run with: pio test -e native -f test_rt_record
+ */
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+#include "rt_record.h"
+
+struct Packet {
+  uint32_t key;
+  std::vector<uint8_t> data;
+};
+
+static uint32_t rnd = 1;
+static uint32_t nextRandom() { rnd = rnd * 1103515245u + 12345u; return rnd >> 8; }
+
+// mostly static frames with a few changing pixels, sometimes a completely new frame or a different length
+static std::vector<Packet> makeStreams(unsigned streams, unsigned packets, uint16_t len) {
+  std::vector<std::vector<uint8_t>> last(streams, std::vector<uint8_t>(len, 0));
+  std::vector<Packet> out;
+  for (unsigned n = 0; n < packets; n++) {
+    unsigned s = nextRandom() % streams;
+    std::vector<uint8_t>& d = last[s];
+    unsigned kind = nextRandom() % 16;
+    if (kind == 0) for (auto& b : d) b = nextRandom();                  // new frame
+    else if (kind == 1) d.resize(16 + nextRandom() % (len - 16));       // other length
+    else if (kind == 2 && d.size() != len) d.resize(len);               // back to full length
+    else for (unsigned k = nextRandom() % 8; k > 0; k--) d[nextRandom() % d.size()] = nextRandom(); // a few bytes
+    out.push_back({0x1000u + s, d});
+  }
+  return out;
+}
+
+// file image: what the writer moves out of the ring
+struct Recording {
+  std::vector<uint8_t> file;
+  unsigned deltas = 0;
+  bool ok = true;      // every delta was smaller than its packet and fitted into the ring
+};
+
+static Recording record(const std::vector<Packet>& packets, unsigned slots) {
+  std::vector<uint8_t> codecMem(slots * RTREC_MAX_PACKET);
+  std::vector<uint8_t> ringMem(8192);
+  RtDeltaCodec codec;
+  RtByteRing ring;
+  codec.attach(codecMem.data(), slots);
+  ring.attach(ringMem.data(), ringMem.size());
+  Recording r;
+  r.file.resize(RTREC_FILE_HEADER);
+  RtRecord::writeFileHeader(r.file.data());
+  uint32_t t = 0;
+  for (const Packet& p : packets) {
+    RtRecord rec;
+    rec.time = t += 25;
+    rec.protocol = 4;
+    rec.ip = 0x0A000001;
+    uint8_t header[RTREC_REC_HEADER], payload[RTREC_MAX_PACKET];
+    codec.encode(p.key, p.data.data(), p.data.size(), payload, rec);
+    if (rec.payload > p.data.size()) r.ok = false;
+    if (rec.slot & RTREC_DELTA) r.deltas++;
+    rec.write(header);
+    if (!ring.push(header, sizeof(header), payload, rec.payload)) r.ok = false;
+    const uint8_t* data;
+    size_t len;
+    while ((len = ring.peek(&data)) > 0) { r.file.insert(r.file.end(), data, data + len); ring.consume(len); }
+  }
+  return r;
+}
+
+// replay side: returns the number of packets that matched
+static unsigned replay(const Recording& r, const std::vector<Packet>& packets, unsigned slots) {
+  std::vector<uint8_t> codecMem(slots * RTREC_MAX_PACKET);
+  RtDeltaCodec codec;
+  codec.attach(codecMem.data(), slots);
+  if (!RtRecord::checkFileHeader(r.file.data())) return 0;
+  size_t pos = RTREC_FILE_HEADER;
+  unsigned n = 0;
+  while (pos + RTREC_REC_HEADER <= r.file.size()) {
+    RtRecord rec;
+    if (!rec.read(&r.file[pos])) break;
+    pos += RTREC_REC_HEADER;
+    if (pos + rec.payload > r.file.size()) break;
+    uint8_t out[RTREC_MAX_PACKET];
+    if (!codec.decode(rec, &r.file[pos], out)) break;
+    pos += rec.payload;
+    if (n >= packets.size() || rec.length != packets[n].data.size() || memcmp(out, packets[n].data.data(), rec.length) != 0) break;
+    n++;
+  }
+  return n;
+}
+
+void setUp(void) { rnd = 1; }
+void tearDown(void) {}
+
+void test_roundtrip(void) {
+  std::vector<Packet> packets = makeStreams(4, 2000, 638); // E1.31: 125 + 513
+  Recording r = record(packets, 8);
+  TEST_ASSERT_TRUE(r.ok);
+  TEST_ASSERT_EQUAL_UINT(packets.size(), replay(r, packets, 8));
+  TEST_ASSERT_TRUE(r.deltas > packets.size() / 2);
+  size_t raw = 0;
+  for (const Packet& p : packets) raw += p.data.size();
+  TEST_ASSERT_TRUE(r.file.size() < raw / 4); // few changed bytes per frame
+}
+
+void test_more_streams_than_slots(void) {
+  std::vector<Packet> packets = makeStreams(7, 1500, 300);
+  Recording r = record(packets, 3); // streams keep pushing each other out of the slots
+  TEST_ASSERT_TRUE(r.ok);
+  TEST_ASSERT_EQUAL_UINT(packets.size(), replay(r, packets, 3));
+}
+
+void test_no_slots(void) {
+  std::vector<Packet> packets = makeStreams(2, 200, 200);
+  Recording r = record(packets, 0);
+  TEST_ASSERT_TRUE(r.ok);
+  TEST_ASSERT_EQUAL_UINT(0, r.deltas);
+  TEST_ASSERT_EQUAL_UINT(packets.size(), replay(r, packets, 0));
+}
+
+void test_identical_and_full_change(void) {
+  std::vector<uint8_t> a(RTREC_MAX_PACKET), b(RTREC_MAX_PACKET);
+  for (unsigned i = 0; i < a.size(); i++) { a[i] = i; b[i] = ~i; }
+  std::vector<Packet> packets = {{1, a}, {1, a}, {1, b}, {1, a}};
+  Recording r = record(packets, 2);
+  TEST_ASSERT_EQUAL_UINT(packets.size(), replay(r, packets, 2));
+  // identical packet: delta without spans
+  RtRecord rec;
+  TEST_ASSERT_TRUE(rec.read(&r.file[RTREC_FILE_HEADER + RTREC_REC_HEADER + a.size()]));
+  TEST_ASSERT_TRUE(rec.slot & RTREC_DELTA);
+  TEST_ASSERT_EQUAL_UINT(0, rec.payload);
+}
+
+void test_corrupt_records(void) {
+  std::vector<Packet> packets = makeStreams(1, 50, 100);
+  Recording r = record(packets, 2);
+  // replay that joins in the middle: first delta has no base packet
+  std::vector<uint8_t> mem(2 * RTREC_MAX_PACKET);
+  RtDeltaCodec codec;
+  codec.attach(mem.data(), 2);
+  size_t pos = RTREC_FILE_HEADER;
+  bool rejected = false;
+  while (pos + RTREC_REC_HEADER <= r.file.size()) {
+    RtRecord rec;
+    TEST_ASSERT_TRUE(rec.read(&r.file[pos]));
+    pos += RTREC_REC_HEADER;
+    if (rec.slot & RTREC_DELTA) {
+      uint8_t out[RTREC_MAX_PACKET];
+      rejected = !codec.decode(rec, &r.file[pos], out);
+      break;
+    }
+    pos += rec.payload;
+  }
+  TEST_ASSERT_TRUE(rejected);
+
+  // span that points past the packet
+  codec.attach(mem.data(), 2);
+  uint8_t pkt[100] = {0}, out[RTREC_MAX_PACKET];
+  RtRecord full = {0, 4, 0, 100, 0, 100};
+  TEST_ASSERT_TRUE(codec.decode(full, pkt, out));
+  uint8_t bad[6];
+  RtRecord::put16(bad, 98); RtRecord::put16(bad + 2, 2); bad[4] = bad[5] = 1;
+  RtRecord delta = {0, 4, 0 | RTREC_DELTA, 100, 0, 6};
+  TEST_ASSERT_TRUE(codec.decode(delta, bad, out));
+  RtRecord::put16(bad, 99);
+  TEST_ASSERT_FALSE(codec.decode(delta, bad, out));
+}
+
+// producer and consumer in different threads, like the network task and the writer task
+void test_ring_two_threads(void) {
+  std::vector<uint8_t> mem(1000);
+  RtByteRing ring;
+  ring.attach(mem.data(), mem.size());
+  const unsigned records = 20000;
+  std::vector<uint8_t> received;
+  std::thread consumer([&]() {
+    while (received.size() < records * 5) {
+      const uint8_t* data;
+      size_t len = ring.peek(&data);
+      received.insert(received.end(), data, data + len);
+      ring.consume(len);
+    }
+  });
+  for (unsigned n = 0; n < records; n++) {
+    uint8_t head[2] = {uint8_t(n), uint8_t(n >> 8)}, body[3] = {uint8_t(n * 3), uint8_t(n * 5), uint8_t(n * 7)};
+    while (!ring.push(head, 2, body, 3)) std::this_thread::yield(); // full - the recorder would drop instead
+  }
+  consumer.join();
+  for (unsigned n = 0; n < records; n++) {
+    const uint8_t* r = &received[n * 5];
+    uint8_t expected[5] = {uint8_t(n), uint8_t(n >> 8), uint8_t(n * 3), uint8_t(n * 5), uint8_t(n * 7)};
+    TEST_ASSERT_EQUAL_MEMORY(expected, r, 5);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_roundtrip);
+  RUN_TEST(test_more_streams_than_slots);
+  RUN_TEST(test_no_slots);
+  RUN_TEST(test_identical_and_full_change);
+  RUN_TEST(test_corrupt_records);
+  RUN_TEST(test_ring_two_threads);
+  return UNITY_END();
+}
@@ -175,7 +175,7 @@ float ARTI::arti_external_function(uint8_t function, float par1, float par2, flo
         return floatNull;
       }
       case F_circle2D: {
-        uint16_t circleLength = min(Segment::maxWidth, Segment::maxHeight);
+        uint16_t circleLength = min(uint16_t(Segment::maxWidth), Segment::maxHeight);
         uint16_t deltaWidth=0, deltaHeight=0;
 
         if (circleLength < Segment::maxHeight) //portrait
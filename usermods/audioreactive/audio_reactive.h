@@ -153,6 +153,10 @@ static float FFT_Magnitude = 0.0f;              // FFT: volume (magnitude) of pe
 static bool samplePeak = false;      // Boolean flag for peak - used in effects. Responding routine may reset this flag. Auto-reset after strip.getMinShowDelay()
 static bool udpSamplePeak = false;   // Boolean flag for peak. Set at the same time as samplePeak, but reset by transmitAudioData
 static unsigned long timeOfPeak = 0; // time of last sample peak detection.
+#ifdef ARDUINO_ARCH_ESP32
+static bool fftSamplePeak = false;          // WLEDMM peak found by the FFT task - effects get it through the audio frame
+static unsigned long fftTimeOfPeak = 0;     // FFT task only
+#endif
 volatile bool haveNewFFTResult = false; // flag to directly inform UDP sound sender when new FFT results are available (to reduce latency). Flag is reset at next UDP send
 
 static uint8_t fftResult[NUM_GEQ_CHANNELS]= {0};   // Our calculated freq. channel result table to be used by effects
@@ -161,6 +165,61 @@ static float   fftAvg[NUM_GEQ_CHANNELS] = {0.0f};  // Calculated frequency chann
 
 static uint16_t zeroCrossingCount = 0; // number of zero crossings in the current batch of 512 samples
 
+// WLEDMM beat and tempo tracking (FFT task, or received by sound sync)
+#include "beat_tracker.h"
+static BeatTracker beatTracker;
+static float   beatBpm = 0.0f;                 // tempo in BPM, 0 = no clear beat
+static uint8_t beatPhase = 0;                  // 0..255 position inside the current beat, 0 = on the beat
+static uint8_t beatConfidence = 0;             // 0..255
+static uint8_t beatCount = 0;                  // increments on every beat - effects compare it with their last value
+static void publishBeat(void) {
+  beatBpm = beatTracker.bpm;
+  beatPhase = beatTracker.phase;
+  beatConfidence = beatTracker.confidence;
+  beatCount = beatTracker.count;
+}
+
+// WLEDMM audio results for effects: complete frames go from the FFT task to the render loop through a lock-free
+// triple buffer, so effects never see a half updated fftResult[]. um_data points into fxFrame.
+#include "triple_buffer.h"
+typedef struct AudioFrame {
+  uint32_t seq;                          // frame number
+  uint32_t captureUs;                    // micros() when the samples (or the sound sync packet) arrived
+  uint8_t  fftResult[NUM_GEQ_CHANNELS];
+  float    majorPeak;
+  float    majorPeakSmth;
+  uint16_t zeroCrossingCount;
+  bool     samplePeak;
+  float    beatBpm;
+  uint8_t  beatPhase;
+  uint8_t  beatConfidence;
+  uint8_t  beatCount;
+} AudioFrame;
+static AudioFrame fxFrame = {};                // what effects see - only changed in the loop task
+static bool       fxFrameNew = false;          // not yet seen by an effect
+static float      audioLatency = 0.0f;         // ms from sample capture to the first effect that reads the frame (smoothed)
+static uint32_t   audioLatencyMax = 0;         // us, max in the last AUDIO_LATENCY_WINDOW ms
+static uint32_t   audioFramesSkipped = 0;      // frames that were replaced before any effect read them
+#define AUDIO_LATENCY_WINDOW 5000
+
+static void fillAudioFrame(AudioFrame &f, uint32_t captureUs, bool peak) {
+  f.captureUs = captureUs;
+  f.samplePeak = peak;
+  memcpy(f.fftResult, fftResult, sizeof(f.fftResult));
+  f.majorPeak = FFT_MajorPeak;
+  f.majorPeakSmth = FFT_MajorPeak;   // overwritten on ESP32
+  f.zeroCrossingCount = zeroCrossingCount;
+  f.beatBpm = beatBpm;
+  f.beatPhase = beatPhase;
+  f.beatConfidence = beatConfidence;
+  f.beatCount = beatCount;
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+static TripleBuffer<AudioFrame> audioFrames;   // FFT task -> loop task
+static uint32_t audioFrameSeq = 0;             // FFT task only
+#endif
+
 // TODO: probably best not used by receive nodes
 static float agcSensitivity = 128;            // AGC sensitivity estimation, based on agc gain (multAgc). calculated by getSensitivity(). range 0..255
 
@@ -590,6 +649,7 @@ void FFTcode(void * parameter)
 #else
     if (audioSource) audioSource->getSamples(vReal, samplesFFT);
 #endif
+    uint32_t captureUs = micros();    // WLEDMM newest sample has just arrived (for latency measurement)
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)|| defined(SR_STATS)
     // debug info in case that stack usage changes
@@ -879,6 +939,8 @@ void FFTcode(void * parameter)
     } }
 
       memcpy(lastFftCalc, fftCalc, sizeof(lastFftCalc)); // make a backup of last "good" channels
+      beatTracker.feed(fftCalc, millis());               // WLEDMM onset detection and tempo tracking
+      publishBeat();
 
     } else { // if second run skipped
       memcpy(fftCalc, lastFftCalc, sizeof(fftCalc)); // restore last "good" channels
@@ -904,9 +966,15 @@ void FFTcode(void * parameter)
 #endif
 
     // run peak detection
-    autoResetPeak();
     detectSamplePeak();
 
+    // WLEDMM hand the complete frame over to effects
+    AudioFrame &frame = audioFrames.back();
+    fillAudioFrame(frame, captureUs, fftSamplePeak);
+    frame.majorPeakSmth = FFT_MajPeakSmth;
+    frame.seq = ++audioFrameSeq;
+    audioFrames.publish();
+
     haveNewFFTResult = true;
     
     #if !defined(I2S_GRAB_ADC1_COMPLETELY)    
@@ -1062,14 +1130,17 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels, bool
 ////////////////////
 
 // peak detection is called from FFT task when vReal[] contains valid FFT results
+// WLEDMM the FFT task keeps its own peak flag (fftSamplePeak) - samplePeak belongs to the loop task
 static void detectSamplePeak(void) {
+  uint16_t MinShowDelay = MAX(50, strip.getMinShowDelay());
+  if (millis() - fftTimeOfPeak > MinShowDelay) fftSamplePeak = false; // auto-reset, same as autoResetPeak()
   bool havePeak = false;
 #if 1
   // softhack007: this code continuously triggers while volume in the selected bin is above a certain threshold. So it does not detect peaks - it detects volume in a frequency bin.
   // Poor man's beat detection by seeing if sample > Average + some value.
   // This goes through ALL of the 255 bins - but ignores stupid settings
   // Then we got a peak, else we don't. The peak has to time out on its own in order to support UDP sound sync.
-  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum] > maxVol) && ((millis() - timeOfPeak) > 100)) {
+  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum] > maxVol) && ((millis() - fftTimeOfPeak) > 100)) {
     havePeak = true;
   }
 #endif
@@ -1078,14 +1149,14 @@ static void detectSamplePeak(void) {
   // alternate detection, based on FFT_MajorPeak and FFT_Magnitude. Not much better...
   if ((binNum > 1)  && (maxVol > 8) && (binNum < 10) && (sampleAgc > 127) && 
       (FFT_MajorPeak > 50) && (FFT_MajorPeak < 250) && (FFT_Magnitude > (16.0f * (maxVol+42.0)) /*my_magnitude > 136.0f*16.0f*/) && 
-      (millis() - timeOfPeak > 80)) {
+      (millis() - fftTimeOfPeak > 80)) {
     havePeak = true;
   }
 #endif
 
   if (havePeak) {
-    samplePeak    = true;
-    timeOfPeak    = millis();
+    fftSamplePeak = true;
+    fftTimeOfPeak = millis();
     udpSamplePeak = true;
   }
 }
@@ -1171,6 +1242,17 @@ class AudioReactive : public Usermod {
       float  FFT_MajorPeak;   //  04 Bytes  offset 40 - frequency (Hz) of largest FFT result
     };
 
+    // WLEDMM beat packet - 14 Bytes, sent next to the V2 packet (older receivers ignore it, as the size does not match)
+    struct __attribute__ ((packed)) audioSyncBeatPacket {
+      char    header[6];      //  06 Bytes  offset 0  - "00002", same as V2
+      float   bpm;            //  04 Bytes  offset 6  - tempo, 0 = no clear beat
+      uint8_t phase;          //  01 Bytes  offset 10 - 0..255 position inside the current beat
+      uint8_t confidence;     //  01 Bytes  offset 11 - 0..255
+      uint8_t count;          //  01 Bytes  offset 12 - increments on every beat
+      uint8_t reserved;       //  01 Bytes  offset 13
+    };
+    #define AUDIOSYNC_BEAT_MS 200 // beat packets: on every beat, and at least this often
+
     // old "V1" audiosync struct - 83 Bytes payload, 88 bytes total - for backwards compatibility
     struct audioSyncPacket_v1 {
       char header[6];         //  06 Bytes
@@ -1193,6 +1275,7 @@ class AudioReactive : public Usermod {
     bool     enabled = false;
   #endif
     bool     initDone = false;
+    bool     networkAudioActive = false; // WLEDMM effects get their audio from sound sync, not from the FFT task
 
     // variables  for UDP sound sync
     WiFiUDP fftUdp;               // UDP object for sound sync (from WiFi UDP, not Async UDP!)
@@ -1729,6 +1812,25 @@ class AudioReactive : public Usermod {
       }
       
       frameCounter++;
+
+      // WLEDMM beat packet
+      static unsigned long lastBeatTime = 0;
+      static uint8_t lastBeatCount = 0;
+      if ((beatCount != lastBeatCount) || (millis() - lastBeatTime > AUDIOSYNC_BEAT_MS)) {
+        audioSyncBeatPacket beatData;
+        memset(reinterpret_cast<void *>(&beatData), 0, sizeof(beatData));
+        strncpy_P(beatData.header, PSTR(UDP_SYNC_HEADER), 6);
+        beatData.bpm = beatBpm;
+        beatData.phase = beatPhase;
+        beatData.confidence = beatConfidence;
+        beatData.count = beatCount;
+        if (fftUdp.beginMulticastPacket() != 0) {
+          fftUdp.write(reinterpret_cast<uint8_t *>(&beatData), sizeof(beatData));
+          fftUdp.endPacket();
+        }
+        lastBeatCount = beatCount;
+        lastBeatTime = millis();
+      }
     } // transmitAudioData()
 #endif
     static bool isValidUdpSyncVersion(const char *header) {
@@ -1871,6 +1973,11 @@ class AudioReactive : public Usermod {
           receivedFormat = 2;
           haveFreshData = decodeAudioData(packetSize, fftUdpBuffer);
           //DEBUGSR_PRINTLN("Finished parsing UDP Sync Packet v2");
+        } else if (packetSize == sizeof(audioSyncBeatPacket) && (isValidUdpSyncVersion((const char *)fftUdpBuffer))) {
+          audioSyncBeatPacket beatData;  // WLEDMM beat packet - no new samples
+          memcpy(&beatData, fftUdpBuffer, sizeof(beatData));
+          beatTracker.setFromSync(fmaxf(beatData.bpm, 0.0f), beatData.phase, beatData.confidence, beatData.count, millis());
+          publishBeat();
         } else {
           if (packetSize == sizeof(audioSyncPacket_v1) && (isValidUdpSyncVersion_v1((const char *)fftUdpBuffer))) {
             decodeAudioData_v1(packetSize, fftUdpBuffer);
@@ -1903,18 +2010,18 @@ class AudioReactive : public Usermod {
         // usermod exchangeable data
         // we will assign all usermod exportable data here as pointers to original variables or arrays and allocate memory for pointers
         um_data = new um_data_t;
-        um_data->u_size = 12;
+        um_data->u_size = 16;
         um_data->u_type = new um_types_t[um_data->u_size];
         um_data->u_data = new void*[um_data->u_size];
         um_data->u_data[0] = &volumeSmth;      //*used (New)
         um_data->u_type[0] = UMT_FLOAT;
         um_data->u_data[1] = &volumeRaw;       // used (New)
         um_data->u_type[1] = UMT_UINT16;
-        um_data->u_data[2] = fftResult;        //*used (Blurz, DJ Light, Noisemove, GEQ_base, 2D Funky Plank, Akemi)
+        um_data->u_data[2] = fxFrame.fftResult; //*used (Blurz, DJ Light, Noisemove, GEQ_base, 2D Funky Plank, Akemi)
         um_data->u_type[2] = UMT_BYTE_ARR;
-        um_data->u_data[3] = &samplePeak;      //*used (Puddlepeak, Ripplepeak, Waterfall)
+        um_data->u_data[3] = &fxFrame.samplePeak; //*used (Puddlepeak, Ripplepeak, Waterfall)
         um_data->u_type[3] = UMT_BYTE;
-        um_data->u_data[4] = &FFT_MajorPeak;   //*used (Ripplepeak, Freqmap, Freqmatrix, Freqpixels, Freqwave, Gravfreq, Rocktaves, Waterfall)
+        um_data->u_data[4] = &fxFrame.majorPeak; //*used (Ripplepeak, Freqmap, Freqmatrix, Freqpixels, Freqwave, Gravfreq, Rocktaves, Waterfall)
         um_data->u_type[4] = UMT_FLOAT;
         um_data->u_data[5] = &my_magnitude;    // used (New)
         um_data->u_type[5] = UMT_FLOAT;
@@ -1922,19 +2029,22 @@ class AudioReactive : public Usermod {
         um_data->u_type[6] = UMT_BYTE;
         um_data->u_data[7] = &binNum;          // assigned in effect function from UI element!!! (Puddlepeak, Ripplepeak, Waterfall)
         um_data->u_type[7] = UMT_BYTE;
-#ifdef ARDUINO_ARCH_ESP32
-        um_data->u_data[8] = &FFT_MajPeakSmth; // new
+        um_data->u_data[8] = &fxFrame.majorPeakSmth; // new (substitute FFT_MajorPeak on 8266)
         um_data->u_type[8] = UMT_FLOAT;
-#else
-        um_data->u_data[8] = &FFT_MajorPeak;   // substitute for 8266
-        um_data->u_type[8] = UMT_FLOAT;
-#endif
         um_data->u_data[9]  = &soundPressure;  // used (New)
         um_data->u_type[9]  = UMT_FLOAT;
         um_data->u_data[10] = &agcSensitivity; // used (New) - dummy value on 8266
         um_data->u_type[10] = UMT_FLOAT;
-        um_data->u_data[11] = &zeroCrossingCount; // for auto playlist usermod
+        um_data->u_data[11] = &fxFrame.zeroCrossingCount; // for auto playlist usermod
         um_data->u_type[11] = UMT_UINT16;
+        um_data->u_data[12] = &fxFrame.beatBpm;        // WLEDMM beat tracking: tempo (0 = no clear beat)
+        um_data->u_type[12] = UMT_FLOAT;
+        um_data->u_data[13] = &fxFrame.beatPhase;      // 0..255, 0 = on the beat
+        um_data->u_type[13] = UMT_BYTE;
+        um_data->u_data[14] = &fxFrame.beatConfidence; // 0..255
+        um_data->u_type[14] = UMT_BYTE;
+        um_data->u_data[15] = &fxFrame.beatCount;      // increments on every beat
+        um_data->u_type[15] = UMT_BYTE;
       }
 
 #ifdef ARDUINO_ARCH_ESP32
@@ -2335,7 +2445,15 @@ class AudioReactive : public Usermod {
             else volumeSmth = syncVolumeSmth;                   // restore originally received sample for next run of dynamics limiter
             limitSampleDynamics();                              // run dynamics limiter on received volumeSmth, to hide jumps and hickups
             limitGEQDynamics(have_new_sample);                  // WLEDMM experimental: smooth FFT (GEQ) samples
+            beatTracker.advance(millis());                      // WLEDMM keep beat phase running between beat packets
+            publishBeat();
+            fillAudioFrame(fxFrame, have_new_sample ? micros() : fxFrame.captureUs, samplePeak); // WLEDMM same task as effects - no handover needed
+            #ifdef ARDUINO_ARCH_ESP32
+            fxFrame.majorPeakSmth = FFT_MajPeakSmth;
+            #endif
+            if (have_new_sample) { fxFrame.seq++; fxFrameNew = true; }
           }
+          networkAudioActive = useNetworkAudio;
       } else {
           receivedFormat = 0;
       }
@@ -2355,6 +2473,9 @@ class AudioReactive : public Usermod {
 #ifdef ARDUINO_ARCH_ESP32
         multAgc = 1;
 #endif
+        fillAudioFrame(fxFrame, micros(), false); // WLEDMM effects should not keep the last received values
+        fxFrame.seq = 0;                     // local frames restart the count
+        networkAudioActive = false;
         DEBUGSR_PRINTLN(F("AR  loop(): UDP closed due to inactivity."));
       }
 
@@ -2407,9 +2528,35 @@ class AudioReactive : public Usermod {
     }
 #endif
 
+    // WLEDMM take the newest audio frame - once per LED frame, so all segments see the same audio
+    void refreshAudioFrame()
+    {
+      static uint32_t lastRefresh = 0;
+      if (strip.now == lastRefresh) return;
+      lastRefresh = strip.now;
+#ifdef ARDUINO_ARCH_ESP32
+      if (!networkAudioActive && audioFrames.update()) {
+        const AudioFrame &f = audioFrames.front();
+        if ((fxFrame.seq > 0) && (f.seq > fxFrame.seq + 1)) audioFramesSkipped += f.seq - fxFrame.seq - 1;
+        fxFrame = f;
+        fxFrameNew = true;
+      }
+      if (!networkAudioActive) fxFrame.samplePeak = audioFrames.front().samplePeak || samplePeak; // FFT task peak, or the volume peak from getSample()
+#endif
+      if (fxFrameNew) {
+        fxFrameNew = false;
+        static unsigned long latencyTimer = 0;
+        uint32_t latency = micros() - fxFrame.captureUs;
+        if (millis() - latencyTimer > AUDIO_LATENCY_WINDOW) { latencyTimer = millis(); audioLatencyMax = 0; }
+        if (latency > audioLatencyMax) audioLatencyMax = latency;
+        audioLatency = audioLatency + 0.05f * (latency / 1000.0f - audioLatency);
+      }
+    }
+
     bool getUMData(um_data_t **data)
     {
       if (!data || !enabled) return false; // no pointer provided by caller or not enabled -> exit
+      refreshAudioFrame();
       *data = um_data;
       return true;
     }
@@ -2649,6 +2796,23 @@ class AudioReactive : public Usermod {
           infoArr.add("x");
         }
 #endif
+        // WLEDMM beat tracking
+        infoArr = user.createNestedArray(F("Beat"));
+        if (beatBpm > 0.0f) {
+          infoArr.add(roundf(beatBpm*10.0f) / 10.0f);
+          infoArr.add(F(" BPM"));
+        } else infoArr.add(F("-"));
+        infoArr.add(String(F(" (confidence ")) + String(beatConfidence * 100 / 255) + F("%)"));
+
+        // WLEDMM time from sample capture (or sound sync packet) to effects
+        infoArr = user.createNestedArray(F("Audio Latency"));
+        infoArr.add(roundf(audioLatency * 10.0f) / 10.0f);
+        infoArr.add(String(F(" ms (max ")) + String(audioLatencyMax / 1000) + F(" ms)"));
+        if (audioFramesSkipped > 0) {
+          infoArr = user.createNestedArray(F("Audio Frames Skipped"));
+          infoArr.add(audioFramesSkipped);
+        }
+
         // UDP Sound Sync status
         infoArr = user.createNestedArray(F("UDP Sound Sync"));
         if (audioSyncEnabled) {
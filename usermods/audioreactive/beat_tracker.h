@@ -0,0 +1,206 @@
+#pragma once
+#ifndef WLED_BEAT_TRACKER_H
+#define WLED_BEAT_TRACKER_H
+
+/*
+ * WLEDMM beat and tempo tracker - runs in the FFT task, results are shared with effects through um_data
+ *
+ * feed() is called once per FFT run with the GEQ channels before post-processing (fftCalc[]).
+ *
+ * 1. onset strength: spectral flux of the log-compressed channels (only rising energy counts, bass counts double),
+ *    minus its running mean, resampled to a fixed BEAT_HOP_MS grid - FFT runs do not come at a fixed rate
+ * 2. tempo: autocorrelation of the last BEAT_ENV_LEN hops between BEAT_MIN_BPM and BEAT_MAX_BPM, weighted
+ *    around 120 BPM (avoids locking to half or double tempo); confidence = correlation at the beat period
+ * 3. phase: a comb over the envelope at the beat period finds where the beats are; the running beat phase is
+ *    pulled towards it, so beats keep coming through short breaks in the music
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define BEAT_HOP_MS      10      // onset envelope resolution
+#define BEAT_ENV_LEN     384     // 3.8 seconds of onset envelope
+#define BEAT_MIN_BPM     60
+#define BEAT_MAX_BPM     180
+#define BEAT_UPDATE_MS   250     // tempo and phase estimation interval
+#define BEAT_CHANNELS    16
+#define BEAT_MIN_CONF    0.25f   // below this, bpm is reported as 0
+
+class BeatTracker {
+  public:
+    float    bpm = 0.0f;         // 0 = no tempo found
+    uint8_t  phase = 0;          // 0..255 position inside the current beat, 0 = on the beat
+    uint8_t  confidence = 0;     // 0..255
+    uint8_t  count = 0;          // increments on every beat, never goes back
+
+    void reset() {
+      bpm = 0.0f; phase = confidence = 0;
+      _primed = false;
+      _filled = _head = 0;
+      _mean = _lastOnset = _conf = _periodMs = _phaseF = _candidate = 0.0f;
+      _candidateHits = 0;
+      _counted = false;
+      memset(_env, 0, sizeof(_env));
+    }
+
+    // new FFT result (channels = fftCalc[], before post-processing)
+    void feed(const float* channels, uint32_t nowMs) {
+      float flux = 0.0f;
+      for (unsigned i = 0; i < BEAT_CHANNELS; i++) {
+        float l = logf(1.0f + fmaxf(channels[i], 0.0f));
+        float rise = l - _prevLog[i];
+        if (rise > 0.0f) flux += (i < 4) ? 2.0f * rise : rise;
+        _prevLog[i] = l;
+      }
+      if (!_primed || nowMs - _frameMs > 1000) { // first frame, or audio was paused: restart the grid
+        _primed = true;
+        _frameMs = _hopMs = nowMs;
+        _mean = flux;
+        _lastOnset = 0.0f;
+        return;
+      }
+      _mean += 0.02f * (flux - _mean);
+      float onset = fmaxf(flux - _mean, 0.0f);
+
+      // linear interpolation between FFT runs onto the hop grid
+      while (nowMs - _hopMs >= BEAT_HOP_MS) {
+        _hopMs += BEAT_HOP_MS;
+        float t = (nowMs > _frameMs) ? float(_hopMs - _frameMs) / float(nowMs - _frameMs) : 1.0f;
+        _env[_head] = _lastOnset + t * (onset - _lastOnset);
+        _head = (_head + 1) % BEAT_ENV_LEN;
+        if (_filled < BEAT_ENV_LEN) _filled++;
+      }
+      _frameMs = nowMs;
+      _lastOnset = onset;
+
+      if (nowMs - _updateMs >= BEAT_UPDATE_MS && _filled >= BEAT_ENV_LEN / 2) {
+        _updateMs = nowMs;
+        estimateTempo();
+        if (_periodMs > 0.0f) estimatePhase(nowMs);
+      }
+      advance(nowMs);
+    }
+
+    // move the beat phase forward without new audio (also used by sound sync receivers)
+    void advance(uint32_t nowMs) {
+      if (_periodMs > 0.0f) {
+        _phaseF += float(nowMs - _phaseMs) / _periodMs;
+        while (_phaseF >= 1.0f) { _phaseF -= 1.0f; countBeat(); }
+      }
+      _phaseMs = nowMs;
+      phase = uint8_t(_phaseF * 255.0f);
+    }
+
+    // values from a sound sync sender
+    void setFromSync(float syncBpm, uint8_t syncPhase, uint8_t syncConfidence, uint8_t syncCount, uint32_t nowMs) {
+      bpm = syncBpm;
+      _periodMs = (syncBpm > 0.0f) ? 60000.0f / syncBpm : 0.0f;
+      _phaseF = syncPhase / 256.0f;
+      _phaseMs = nowMs;
+      phase = syncPhase;
+      confidence = syncConfidence;
+      count = syncCount;
+      _counted = false;
+    }
+
+  private:
+    static const unsigned MIN_LAG = 60000 / (BEAT_MAX_BPM * BEAT_HOP_MS);
+    static const unsigned MAX_LAG = 60000 / (BEAT_MIN_BPM * BEAT_HOP_MS);
+
+    float    _prevLog[BEAT_CHANNELS] = {0.0f};
+    float    _env[BEAT_ENV_LEN] = {0.0f};   // onset envelope, ring buffer
+    unsigned _head = 0, _filled = 0;
+    bool     _primed = false;
+    float    _mean = 0.0f, _lastOnset = 0.0f;
+    uint32_t _frameMs = 0, _hopMs = 0, _updateMs = 0, _phaseMs = 0;
+    float    _conf = 0.0f;
+    float    _periodMs = 0.0f;              // beat period, 0 = unknown
+    float    _phaseF = 0.0f;                // 0..1
+    float    _candidate = 0.0f;             // new tempo that has to be seen a few times before we switch
+    unsigned _candidateHits = 0;
+    bool     _counted = false;              // phase correction moved us back before a beat that was already counted
+
+    // k-th newest sample (0 = newest)
+    float env(unsigned k) const { return _env[(_head + BEAT_ENV_LEN - 1 - k) % BEAT_ENV_LEN]; }
+
+    void estimateTempo() {
+      const unsigned n = _filled;
+      float mean = 0.0f;
+      for (unsigned k = 0; k < n; k++) mean += env(k);
+      mean /= n;
+      float energy = 0.0f;
+      for (unsigned k = 0; k < n; k++) energy += (env(k) - mean) * (env(k) - mean);
+      energy /= n;
+      if (energy < 1e-6f) { _conf *= 0.7f; publish(); return; } // silence
+
+      float r[MAX_LAG - MIN_LAG + 3];   // lags MIN_LAG-1 .. MAX_LAG+1
+      unsigned best = 0;
+      float bestScore = 0.0f;
+      for (unsigned lag = MIN_LAG - 1; lag <= MAX_LAG + 1; lag++) {
+        float sum = 0.0f;
+        for (unsigned k = 0; k + lag < n; k++) sum += (env(k) - mean) * (env(k + lag) - mean);
+        float c = sum / (n - lag) / energy;
+        r[lag - MIN_LAG + 1] = c;
+        if (lag < MIN_LAG || lag > MAX_LAG) continue;
+        float octaves = log2f(lag * BEAT_HOP_MS / 500.0f);  // distance from 120 BPM
+        float score = c * expf(-0.5f * octaves * octaves);
+        if (score > bestScore) { bestScore = score; best = lag; }
+      }
+      if (best == 0) { _conf *= 0.7f; publish(); return; }
+
+      // parabolic interpolation around the best lag
+      float a = r[best - MIN_LAG], b = r[best - MIN_LAG + 1], c = r[best - MIN_LAG + 2];
+      float denom = a - 2.0f * b + c;
+      float d = (denom < 0.0f) ? 0.5f * (a - c) / denom : 0.0f;
+      if (d < -0.5f || d > 0.5f) d = 0.0f;
+      float period = (best + d) * BEAT_HOP_MS;
+
+      // small changes follow smoothly, a new tempo must be confirmed a few times
+      if (_periodMs <= 0.0f || fabsf(period / _periodMs - 1.0f) < 0.05f) {
+        _periodMs = (_periodMs > 0.0f) ? _periodMs + 0.3f * (period - _periodMs) : period;
+        _candidateHits = 0;
+      } else if (_candidate > 0.0f && fabsf(period / _candidate - 1.0f) < 0.05f) {
+        if (++_candidateHits >= 3) { _periodMs = period; _candidateHits = 0; }
+      } else {
+        _candidate = period;
+        _candidateHits = 1;
+      }
+      _conf += 0.3f * (fminf(fmaxf(b, 0.0f), 1.0f) - _conf);
+      publish();
+    }
+
+    // find the beat positions in the envelope and pull the running phase towards them
+    void estimatePhase(uint32_t nowMs) {
+      float p = _periodMs / BEAT_HOP_MS;
+      unsigned bestK = 0;
+      float bestSum = -1.0f;
+      for (unsigned k = 0; k < unsigned(p); k++) {
+        float sum = 0.0f, weight = 1.0f;
+        for (float pos = k; pos < _filled; pos += p, weight *= 0.85f) sum += weight * env(unsigned(pos));
+        if (sum > bestSum) { bestSum = sum; bestK = k; }
+      }
+      // newest sample is at _hopMs, the last beat was bestK hops before it
+      float sinceBeat = float(nowMs - (_hopMs - bestK * BEAT_HOP_MS));
+      float target = fmodf(sinceBeat / _periodMs, 1.0f);
+      advance(nowMs);
+      float diff = target - _phaseF;
+      if (diff > 0.5f) diff -= 1.0f;
+      if (diff < -0.5f) diff += 1.0f;
+      _phaseF += diff * (0.2f + 0.5f * _conf);   // trust the comb more when the tempo is clear
+      if (_phaseF < 0.0f) { _phaseF += 1.0f; _counted = (bpm > 0.0f); } // moved back before the last beat - it is not counted a second time
+      if (_phaseF >= 1.0f) { _phaseF -= 1.0f; countBeat(); }
+    }
+
+    void countBeat() {
+      if (_counted) _counted = false;
+      else if (bpm > 0.0f) count++;
+    }
+
+    void publish() {
+      confidence = uint8_t(fminf(_conf, 1.0f) * 255.0f);
+      bpm = (_periodMs > 0.0f && _conf >= BEAT_MIN_CONF) ? 60000.0f / _periodMs : 0.0f;
+    }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef WLED_TRIPLE_BUFFER_H
+#define WLED_TRIPLE_BUFFER_H
+
+/*
+ * WLEDMM lock-free triple buffer - hands complete results from one task (writer) to another (reader)
+ *
+ * The writer fills back() and calls publish(); the reader calls update() and then reads front().
+ * Neither side ever waits: the writer always has a buffer that the reader does not look at, and the reader
+ * keeps its front() buffer until it asks for a newer one. Frames published in between are skipped (latest wins).
+ * Exactly one writer task and one reader task.
+ */
+
+#include <stdint.h>
+
+template<typename T>
+class TripleBuffer {
+  private:
+    static const uint32_t FRESH = 0x80;   // middle buffer holds a frame the reader has not seen
+    T        _buf[3];
+    uint32_t _back = 0;                   // writer only
+    uint32_t _front = 1;                  // reader only
+    uint32_t _middle = 2;                 // shared: buffer index | FRESH
+
+  public:
+    // writer
+    T& back() { return _buf[_back]; }
+    void publish() {
+      _back = __atomic_exchange_n(&_middle, _back | FRESH, __ATOMIC_ACQ_REL) & 3;
+    }
+
+    // reader - returns true if front() changed
+    bool update() {
+      if (!(__atomic_load_n(&_middle, __ATOMIC_ACQUIRE) & FRESH)) return false;
+      _front = __atomic_exchange_n(&_middle, _front, __ATOMIC_ACQ_REL) & 3;
+      return true;
+    }
+    const T& front() const { return _buf[_front]; }
+};
+
+#endif
@@ -23,7 +23,7 @@
 #define PALETTE_SOLID_WRAP   (strip.paletteBlend == 1 || strip.paletteBlend == 3)
 #define PALETTE_MOVING_WRAP !(strip.paletteBlend == 2 || (strip.paletteBlend == 0 && SEGMENT.speed == 0))
 
-#define indexToVStrip(index, stripNr) ((index) | (int((stripNr)+1)<<16))
+#define indexToVStrip(index, stripNr) ((index) | (int((stripNr)+1)<<SEG_VSTRIP_SHIFT))
 
 #if 0 // for benchmarking - change to "#if 1" to use less accurate, but 30% faster FastLed sin8 and cos8 functions
 #define sin8_t sin8
@@ -9004,18 +9004,22 @@ void WS2812FX::addEffect(uint8_t id, mode_ptr mode_fn, const char *mode_name) {
     _mode.push_back(mode_fn);
     _modeData.push_back(mode_name);
     if (_modeCount < _mode.size()) _modeCount++;
+    id = _modeData.size() - 1;
   }
+  indexModeData(id); // WLEDMM
 }
 
 void WS2812FX::setupEffectData() {
   // Solid must be first! (assuming vector is empty upon call to setup)
   _mode.push_back(&mode_static);
   _modeData.push_back(_data_FX_MODE_STATIC);
+  indexModeData(0); // WLEDMM
   // fill reserved word in case there will be any gaps in the array
   for (size_t i=1; i<_modeCount; i++) {
     _mode.push_back(&mode_static);
     _modeData.push_back(_data_RESERVED);
   }
+  _modeMeta.resize(_modeData.size(), mode_meta_t{4, 0, 0, 0}); // WLEDMM "RSVD"
   // now replace all pre-allocated effects
   // --- 1D non-audio effects ---
   addEffect(FX_MODE_BLINK, &mode_blink, _data_FX_MODE_BLINK);
@@ -63,6 +63,22 @@ bool strip_uses_global_leds(void) __attribute__((pure));  // WLEDMM implemented
 #define MIN_SHOW_DELAY   (_frametime < 16 ? (_frametime <8? (_frametime <7? (_frametime <6 ? 2 :3) :4) : 8) : 15)    // WLEDMM support higher framerates (up to 250fps)
 #endif
 
+// WLEDMM 1D effects on 2D segments pass the virtual strip number (+1) in the upper bits of the pixel index
+#ifdef WLEDMM_PIXEL_INDEX_32
+#define SEG_VSTRIP_SHIFT 20  // up to 1M pixels per segment, 2047 virtual strips
+#else
+#define SEG_VSTRIP_SHIFT 16
+#endif
+#define SEG_VSTRIP_MASK ((1 << SEG_VSTRIP_SHIFT) - 1)
+#if MAX_LEDS > SEG_VSTRIP_MASK
+  #error MAX_LEDS is too large for the virtual strip encoding of segment pixel indices
+#endif
+#ifdef WLEDMM_FUSED_PIXELMAP
+#define LEDMAP_MEM_TIER WLED_MEM_COLD  // WLEDMM ledmap is only read while building the fused map
+#else
+#define LEDMAP_MEM_TIER WLED_MEM_WARM  // WLEDMM ledmap lookup for every pixel
+#endif
+
 /* each segment uses 52 bytes of SRAM memory, so if you're application fails because of
   insufficient memory, decreasing MAX_NUM_SEGMENTS may help */
 #ifdef ESP8266
@@ -133,6 +149,13 @@ bool strip_uses_global_leds(void) __attribute__((pure));  // WLEDMM implemented
 #define REVERSE      (uint16_t)0x0002
 #define SELECTED     (uint16_t)0x0001
 
+// WLEDMM effect metadata flags (4th section of effect data: "name@sliders;colors;palette;flags;defaults")
+#define FX_META_1D      0x01
+#define FX_META_2D      0x02
+#define FX_META_VOLUME  0x04  // audio reactive (volume)
+#define FX_META_FREQ    0x08  // audio reactive (frequency)
+#define FX_DEFAULT_KEYS 15    // number of keys in the defaults section that are indexed (sx,ix,c1,c2,c3,o1,o2,o3,m12,si,rev,mi,rY,mY,pal)
+
 #define FX_MODE_STATIC                   0
 #define FX_MODE_BLINK                    1
 #define FX_MODE_BREATH                   2
@@ -350,11 +373,26 @@ typedef enum mapping1D2D {
   M12_sPinwheel = 7 //WLEDMM Pinwheel
 } mapping1D2D_t;
 
+// WLEDMM segment blend modes for the layer compositor ("bm" - numbers follow upstream WLED where the mode exists)
+typedef enum segmentBlend {
+  SEG_BLEND_NORMAL   = 0,  // layer over lower layers, opacity = transparency
+  SEG_BLEND_ADD      = 2,
+  SEG_BLEND_MULTIPLY = 6,
+  SEG_BLEND_MAX      = 8,  // lighten
+  SEG_BLEND_SCREEN   = 10,
+  SEG_BLEND_LUMA     = 16  // alpha by luma - dark parts of the layer are transparent
+} segmentBlend_t;
+
+// WLEDMM compositor state (WS2812FX::_compositor)
+#define COMPOSITE_OFF    0   // pixels go straight to the busses
+#define COMPOSITE_RENDER 1   // effects draw into segment buffers only
+#define COMPOSITE_BLEND  2   // segment buffers are blended into the frame
+
 // segment, 72 bytes
 typedef struct Segment {
   public:
-    uint16_t start; // start index / start X coordinate 2D (left)
-    uint16_t stop;  // stop index / stop X coordinate 2D (right); segment is invalid if stop == 0
+    pixel_index_t start; // start index / start X coordinate 2D (left)
+    pixel_index_t stop;  // stop index / stop X coordinate 2D (right); segment is invalid if stop == 0
     uint16_t offset;
     uint8_t  speed;
     uint8_t  intensity;
@@ -381,6 +419,7 @@ typedef struct Segment {
     uint8_t  grouping, spacing;
     uint8_t  opacity;
     uint8_t  lastBri;             // WLEDMM optimization for black-to-black "transitions"
+    uint8_t  blendMode;           // WLEDMM segmentBlend_t, used by the layer compositor
     bool needsBlank;              // WLEDMM indicates that Segment needs to be blanked (due to change of mirror / reverse / transpose / spacing)
     uint32_t colors[NUM_COLORS];
     uint8_t  cct;                 //0==1900K, 255==10091K
@@ -405,7 +444,12 @@ typedef struct Segment {
     CRGB* ledsrgb = nullptr;     // local leds[] array (may be a pointer to global) //WLEDMM rename to ledsrgb to search on them (temp?), and initialize to nullptr
     size_t ledsrgbSize; //WLEDMM 
     static CRGB *_globalLeds;             // global leds[] array
-    static uint16_t maxWidth, maxHeight;  // these define matrix width & height (max. segment dimensions)
+#ifdef WLEDMM_COLOR_8DOT8
+    uint8_t* ledsfrac = nullptr;          // WLEDMM lower byte for each channel of ledsrgb[] -> 8.8 fixed point pixels (only with global leds[] array)
+    static uint8_t *_globalLedsFrac;      // WLEDMM global buffer for ledsfrac, same layout as _globalLeds
+#endif
+    static pixel_index_t maxWidth;        // these define matrix width & height (max. segment dimensions) - maxWidth is the strip length in 1D
+    static uint16_t maxHeight;
     void *jMap = nullptr; //WLEDMM jMap
 
   private:
@@ -421,6 +465,10 @@ typedef struct Segment {
     };
     size_t _dataLen;                   // WLEDMM uint16_t is too small
     static size_t _usedSegmentData;    // WLEDMM uint16_t is too small
+    // WLEDMM zeroed buffers for data[] and local ledsrgb[] - from the segment arena if WLEDMM_SEGMENT_ARENA, otherwise heap
+    static void* segAlloc(void* owner, size_t len);
+    static void  segFree(void* ptr);
+    static void  segRebind(void* ptr, void* owner);
     void setPixelColorXY_fast(int x, int y,uint32_t c, uint32_t scaled_col, int cols, int rows) const; // set relative pixel within segment with color - faster, but no error checking!!!
 
     bool _isSimpleSegment = false;      // simple = no grouping or spacing - mirror, transpose or reverse allowed
@@ -431,7 +479,7 @@ typedef struct Segment {
     uint8_t _brightness = 255; // final pixel brightness - including transitions and segment opacity
     uint16_t _2dWidth = 0;  // virtualWidth
     uint16_t _2dHeight = 0; // virtualHeight
-    uint16_t _virtuallength = 0; // virtualLength
+    pixel_index_t _virtuallength = 0; // virtualLength
 
     void setPixelColorXY_slow(int x, int y, uint32_t c); // set relative pixel within segment with color - full slow version
 #else
@@ -478,7 +526,7 @@ typedef struct Segment {
 
   public:
 
-    Segment(uint16_t sStart=0, uint16_t sStop=30) :
+    Segment(pixel_index_t sStart=0, pixel_index_t sStop=30) :
       start(sStart),
       stop(sStop),
       offset(0),
@@ -491,6 +539,7 @@ typedef struct Segment {
       spacing(0),
       opacity(255),
       lastBri(255),
+      blendMode(SEG_BLEND_NORMAL),
       needsBlank(false),
       colors{DEFAULT_COLOR,BLACK,BLACK},
       cct(127),
@@ -518,7 +567,7 @@ typedef struct Segment {
       //refreshLightCapabilities();
     }
 
-    Segment(uint16_t sStartX, uint16_t sStopX, uint16_t sStartY, uint16_t sStopY) : Segment(sStartX, sStopX) {
+    Segment(pixel_index_t sStartX, pixel_index_t sStopX, uint16_t sStartY, uint16_t sStopY) : Segment(sStartX, sStopX) {
       startY = sStartY;
       stopY  = sStopY;
     }
@@ -546,7 +595,7 @@ typedef struct Segment {
       strip_wait_until_idle("~Segment()");
       #endif
 
-      if ((Segment::_globalLeds == nullptr) && !strip_uses_global_leds() && (ledsrgb != nullptr)) {free(ledsrgb); ledsrgb = nullptr;}  // WLEDMM we need "!strip_uses_global_leds()" to avoid crashes (#104)
+      if ((Segment::_globalLeds == nullptr) && !strip_uses_global_leds() && (ledsrgb != nullptr)) {segFree(ledsrgb); ledsrgb = nullptr;}  // WLEDMM we need "!strip_uses_global_leds()" to avoid crashes (#104)
       if (name) { delete[] name; name = nullptr; }
       if (_t)   { transitional = false; delete _t; _t = nullptr; }
       deallocateData();
@@ -566,19 +615,24 @@ typedef struct Segment {
     inline bool     hasRGB(void)         const { return _isRGB; }
     inline bool     hasWhite(void)       const { return _hasW; }
     inline bool     isCCT(void)          const { return _isCCT; }
-    inline uint16_t width(void)          const { return (stop  > start)  ?  (stop - start)  : 0; } // segment width in physical pixels (length if 1D)
+    inline pixel_index_t width(void)     const { return (stop  > start)  ?  (stop - start)  : 0; } // segment width in physical pixels (length if 1D)
     inline uint16_t height(void)         const { return (stopY > startY) ? (stopY - startY) : 0; } // segment height (if 2D) in physical pixels // WLEDMM make sure its always > 0
-    inline uint16_t length(void)         const { return width() * height(); }     // segment length (count) in physical pixels // WLEDMM fishy ... need to double-check if this is correct
+    inline pixel_index_t length(void)    const { return width() * height(); }     // segment length (count) in physical pixels // WLEDMM fishy ... need to double-check if this is correct
     inline uint16_t groupLength(void)    const { return max(1, grouping + spacing); } // WLEDMM length = 0 could lead to div/0 in virtualWidth() and virtualHeight()
     inline uint8_t  getLightCapabilities(void) const { return _capabilities; }
 
     static size_t   getUsedSegmentData(void)    { return _usedSegmentData; } // WLEDMM size_t
     static void     addUsedSegmentData(int len) { _usedSegmentData += len; }
+#ifdef WLEDMM_SEGMENT_ARENA
+    static void     setUpArena(size_t capacity); // WLEDMM (re)size the segment arena
+    static void     compactArena(void);          // WLEDMM only while no effect is running; skipped while the JSON lock is taken or a reader is pinned
+#endif
+    static void     pinArena(bool pin);          // WLEDMM async readers that keep data/ledsrgb pointers: true while open, false when done
 
     void    allocLeds(); //WLEDMM
     inline static const CRGBPalette16 &getCurrentPalette(void) { return Segment::_currentPalette; }
 
-    void    setUp(uint16_t i1, uint16_t i2, uint8_t grp=1, uint8_t spc=0, uint16_t ofs=UINT16_MAX, uint16_t i1Y=0, uint16_t i2Y=1);
+    void    setUp(pixel_index_t i1, pixel_index_t i2, uint8_t grp=1, uint8_t spc=0, uint16_t ofs=UINT16_MAX, uint16_t i1Y=0, uint16_t i2Y=1);
     bool    setColor(uint8_t slot, uint32_t c); //returns true if changed
     void    setCCT(uint16_t k);
     void    setOpacity(uint8_t o);
@@ -632,11 +686,11 @@ typedef struct Segment {
     void     setCurrentPalette(void);
 
     // 1D strip
-    uint16_t calc_virtualLength(void) const;
+    pixel_index_t calc_virtualLength(void) const;
 #ifndef WLEDMM_FASTPATH
-    inline uint16_t virtualLength(void) const {return calc_virtualLength();}
+    inline pixel_index_t virtualLength(void) const {return calc_virtualLength();}
 #else
-    inline uint16_t virtualLength(void) const {return _virtuallength;}
+    inline pixel_index_t virtualLength(void) const {return _virtuallength;}
 #endif
     void setPixelColor(int n, uint32_t c); // set relative pixel within segment with color
     inline void setPixelColor(int n, byte r, byte g, byte b, byte w = 0) { setPixelColor(n, RGBW32(r,g,b,w)); } // automatically inline
@@ -645,6 +699,17 @@ typedef struct Segment {
     inline void setPixelColor(float i, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0, bool aa = true) { setPixelColor(i, RGBW32(r,g,b,w), aa); }
     inline void setPixelColor(float i, CRGB c, bool aa = true)                                         { setPixelColor(i, RGBW32(c.r,c.g,c.b,0), aa); }
     uint32_t __attribute__((pure)) getPixelColor(int i) const;  // WLEDMM attribute added
+#ifdef WLEDMM_COLOR_8DOT8
+    // WLEDMM 8.8 fixed point access to ledsrgb[i]/ledsfrac[i] (i = index into ledsrgb). No range checks - caller must make sure that ledsrgb and ledsfrac exist.
+    inline uint64_t getLeds16(unsigned i) const {
+      return RGBW64((ledsrgb[i].r << 8) | ledsfrac[3*i], (ledsrgb[i].g << 8) | ledsfrac[3*i+1], (ledsrgb[i].b << 8) | ledsfrac[3*i+2], 0);
+    }
+    // stores the lower bytes, returns the 8bit color that still needs to be drawn with setPixelColor()
+    inline uint32_t setLedsFrac(unsigned i, uint64_t c) {
+      ledsfrac[3*i] = R16(c) & 0xFF; ledsfrac[3*i+1] = G16(c) & 0xFF; ledsfrac[3*i+2] = B16(c) & 0xFF;
+      return COLOR16TO8(c);
+    }
+#endif
     // 1D support functions (some implement 2D as well)
     void blur(uint8_t, bool smear = false);
     void fill(uint32_t c);
@@ -834,6 +899,13 @@ class WS2812FX {  // 96 bytes
     const char *_data; // mode (effect) name and its UI control data
     ModeData(uint8_t id, uint16_t (*fcn)(void), const char *data) : _id(id), _fcn(fcn), _data(data) {}
   } mode_data_t;
+  // WLEDMM effect metadata - parsed once from the effect data string when the effect is added
+  typedef struct ModeMeta {
+    uint8_t  nameLen;   // length of effect name (up to '@')
+    uint8_t  flags;     // FX_META_* from the flags section
+    uint16_t defMask;   // bit n set: default for key n (see FX_DEFAULT_KEYS) is present
+    uint16_t defOffset; // index of first default value in _modeDefaults
+  } mode_meta_t;
 
   static WS2812FX* instance;
 
@@ -883,6 +955,7 @@ class WS2812FX {  // 96 bytes
       WS2812FX::instance = this;
       _mode.reserve(_modeCount);     // allocate memory to prevent initial fragmentation (does not increase size())
       _modeData.reserve(_modeCount); // allocate memory to prevent initial fragmentation (does not increase size())
+      _modeMeta.reserve(_modeCount); // WLEDMM
       if (_mode.capacity() <= 1 || _modeData.capacity() <= 1) _modeCount = 1; // memory allocation failed only show Solid
       else setupEffectData();
     }
@@ -892,14 +965,25 @@ class WS2812FX {  // 96 bytes
       if (Serial) Serial.println(F("~WS2812FX destroying strip.")); // WLEDMM can't use DEBUG_PRINTLN here
       #endif
       if (customMappingTable) delete[] customMappingTable;
+      #ifdef WLEDMM_FUSED_PIXELMAP
+      if (_fusedMap) free(_fusedMap);
+      #endif
+      #ifdef WLEDMM_LAYER_COMPOSITOR
+      if (_layerFrame) free(_layerFrame);
+      #endif
       _mode.clear();
       _modeData.clear();
+      _modeMeta.clear();
+      _modeDefaults.clear();
       _segments.clear();
 #ifndef WLED_DISABLE_2D
       panel.clear();
 #endif
       customPalettes.clear();
       if (useLedsArray && Segment::_globalLeds) free(Segment::_globalLeds);
+      #ifdef WLEDMM_COLOR_8DOT8
+      if (Segment::_globalLedsFrac) free(Segment::_globalLedsFrac);
+      #endif
     }
 
     static WS2812FX* getInstance(void) { return instance; }
@@ -907,6 +991,9 @@ class WS2812FX {  // 96 bytes
     void
 #ifdef WLED_DEBUG
       printSize(),
+#endif
+#ifdef WLEDMM_PIXEL_BENCHMARK
+      benchmarkPixelPath(void), // WLEDMM
 #endif
       finalizeInit(),
       waitUntilIdle(void),   // WLEDMM
@@ -930,9 +1017,10 @@ class WS2812FX {  // 96 bytes
       enumerateLedmaps(); //WLEDMM (from fcn_declare)
 
     void setColor(uint8_t slot, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) { setColor(slot, RGBW32(r,g,b,w)); }
-    void fill(uint32_t c) { for (int i = 0; i < getLengthTotal(); i++) setPixelColor(i, c); } // fill whole strip with color (inline)
+    void fill(uint32_t c) { for (unsigned i = 0; i < getLengthTotal(); i++) setPixelColor(i, c); } // fill whole strip with color (inline)
     void addEffect(uint8_t id, mode_ptr mode_fn, const char *mode_name); // add effect to the list; defined in FX.cpp
     void setupEffectData(void); // add default effects to the list; defined in FX.cpp
+    void indexModeData(uint8_t id); // WLEDMM parse effect data string into _modeMeta
 
     // outsmart the compiler :) by correctly overloading
     inline void setPixelColor(int n, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) { setPixelColor(n, RGBW32(r,g,b,w)); }
@@ -980,19 +1068,20 @@ class WS2812FX {  // 96 bytes
       currentMilliamps,
       getLengthPhysical(void) const,
       getLengthPhysical2(void) const, // WLEDMM total length including HUB75, network busses excluded
-      __attribute__((pure)) getLengthTotal(void) const, // will include virtual/nonexistent pixels in matrix //WLEDMM attribute added
       getFps() const;
+    pixel_index_t __attribute__((pure)) getLengthTotal(void) const; // will include virtual/nonexistent pixels in matrix //WLEDMM attribute added
 
     inline uint16_t getFrameTime(void)  const { return _frametime; }
     inline uint16_t getMinShowDelay(void)  const { return MIN_SHOW_DELAY; }
-    inline uint16_t getLength(void)  const { return _length; } // 2D matrix may have less pixels than W*H
+    inline pixel_index_t getLength(void)  const { return _length; } // 2D matrix may have less pixels than W*H
     inline uint16_t getTransition(void)  const { return _transitionDur; }
 
     uint32_t
       now,
       timebase;
-    uint32_t __attribute__((pure)) getPixelColor(uint_fast16_t)  const;   // WLEDMM attribute pure = does not have side-effects
-    uint32_t __attribute__((pure)) getPixelColorRestored(uint_fast16_t i)  const;// WLEDMM gets the original color from the driver (without downscaling by _bri)
+    uint32_t __attribute__((pure)) getPixelColor(unsigned)  const;   // WLEDMM attribute pure = does not have side-effects
+    uint32_t __attribute__((pure)) getPixelColorRestored(unsigned i)  const;// WLEDMM gets the original color from the driver (without downscaling by _bri)
+    void getPixelColorsRestored(unsigned first, unsigned count, uint32_t* out) const; // WLEDMM same for count pixels, bus search once per bus
 
     inline uint32_t getLastShow(void)  const { return _lastShow; }
     inline uint32_t segColor(uint8_t i)  const { return _colors_t[i]; }
@@ -1003,6 +1092,11 @@ class WS2812FX {  // 96 bytes
     const char **
       getModeDataSrc(void) { return &(_modeData[0]); } // vectors use arrays for underlying data
 
+    // WLEDMM precomputed effect metadata
+    inline uint8_t getModeNameLen(uint8_t id) const { return (id<_modeCount && id<_modeMeta.size()) ? _modeMeta[id].nameLen : (id == 0 ? 5 : 0); } // 0 = no such effect, "Solid" always exists
+    inline uint8_t getModeFlags(uint8_t id)   const { return (id<_modeCount && id<_modeMeta.size()) ? _modeMeta[id].flags : 0; }
+    int16_t getModeDefault(uint8_t id, const char *key) const; // -1 if effect has no default for key, -2 if key is not indexed
+
     Segment&        getSegment(uint8_t id) __attribute__((pure));
     inline Segment& getFirstSelectedSeg(void) { return _segments[getFirstSelectedSegId()]; }
     inline Segment& getMainSegment(void)      { return _segments[getMainSegmentId()]; }
@@ -1080,7 +1174,7 @@ class WS2812FX {  // 96 bytes
     // using public variables to reduce code size increase due to inline function getSegment() (with bounds checking)
     // and color transitions
     uint32_t _colors_t[3]; // color used for effect (includes transition)
-    uint16_t _virtualSegmentLength;
+    uint16_t _virtualSegmentLength; // SEGLEN for effects - stays 16bit, longer segments are clamped
 #ifdef WLEDMM_FASTPATH
     segment* _currentSeg = nullptr;  // WLEDMM speed up SEGMENT access
 #endif
@@ -1091,7 +1185,7 @@ class WS2812FX {  // 96 bytes
     uint32_t getPixelColorXYRestored(uint16_t x, uint16_t y)  const;  // WLEDMM gets the original color from the driver (without downscaling by _bri)
 
   private:
-    uint16_t _length;
+    pixel_index_t _length;
     uint8_t  _brightness;
     uint16_t _transitionDur;
 
@@ -1114,12 +1208,45 @@ class WS2812FX {  // 96 bytes
     uint8_t                  _modeCount;
     std::vector<mode_ptr>    _mode;     // SRAM footprint: 4 bytes per element
     std::vector<const char*> _modeData; // mode (effect) name and its slider control data array
+    std::vector<mode_meta_t> _modeMeta; // WLEDMM parsed _modeData, 6 bytes per element
+    std::vector<uint8_t>     _modeDefaults; // WLEDMM default values referenced by _modeMeta
 
     show_callback _callback;
 
-    uint16_t* customMappingTable;
-    uint16_t  customMappingTableSize; //WLEDMM
-    uint16_t  customMappingSize;
+    pixel_index_t* customMappingTable;     // WLEDMM ledmap, logical -> physical pixel (PIXEL_INDEX_NONE = no pixel)
+    pixel_index_t  customMappingTableSize; //WLEDMM
+    pixel_index_t  customMappingSize;
+
+#ifdef WLEDMM_FUSED_PIXELMAP
+    // WLEDMM fused map: logical pixel -> (bus number << 16) | position inside the bus, resolves ledmap and bus search in one load.
+    // Rebuilt by service() after the matrix, ledmap or busses have changed.
+    uint32_t* _fusedMap = nullptr;
+    unsigned  _fusedMapSize = 0;
+    uint8_t   _fusedMapGen = 0;      // busses.getGeneration() at build time
+    bool      _fusedMapDirty = true;
+    bool      _fusedMapReady = false;
+    void buildFusedMap(void);
+    inline void invalidateFusedMap(void) { _fusedMapReady = false; _fusedMapDirty = true; }
+#endif
+
+#ifdef WLEDMM_LAYER_COMPOSITOR
+    // WLEDMM layer compositor: while a segment uses a blend mode, effects only draw into segment buffers (ledsrgb),
+    // and compositeLayers() blends all segments into _layerFrame (logical pixels) before it goes to the busses.
+    uint32_t* _layerFrame = nullptr;
+    unsigned  _layerFrameSize = 0;
+    uint8_t   _compositor = COMPOSITE_OFF;
+    uint8_t   _layerMode = SEG_BLEND_NORMAL;  // blend mode and opacity of the segment being composited
+    uint8_t   _layerOpacity = 255;
+    bool      _layersActive = false;
+    #ifdef WLEDMM_LAYER_TIMER
+    uint32_t  _layerTime = 0;                 // accumulated compositing time (micros)
+    uint32_t  _layerCount = 0;
+    uint16_t  _layerFrames = 0;
+    #endif
+    bool prepareLayers(void);
+    void compositeLayers(void);
+    void compositePixel(unsigned i, uint32_t col);
+#endif
 
     /*uint32_t*/ unsigned long _lastShow; // WLEDMM avoid losing precision
     unsigned long _lastServiceShow;       // WLEDMM last call of strip.show (timestamp)
@@ -15,6 +15,9 @@
 // but ledmap takes care of that. ledmap is constructed upon initialization
 // so matrix should disable regular ledmap processing
 void WS2812FX::setUpMatrix() {
+#ifdef WLEDMM_FUSED_PIXELMAP
+  invalidateFusedMap();
+#endif
 #ifndef WLED_DISABLE_2D
   // isMatrix is set in cfg.cpp or set.cpp
   if (isMatrix) {
@@ -72,11 +75,11 @@ void WS2812FX::setUpMatrix() {
 
       // don't use new / delete
       if ((size > 0) && (customMappingTable != nullptr)) {  // resize
-        customMappingTable = (uint16_t*) reallocf(customMappingTable, sizeof(uint16_t) * size); // reallocf will free memory if it cannot resize
+        customMappingTable = (pixel_index_t*) tieredRealloc(customMappingTable, sizeof(pixel_index_t) * size, LEDMAP_MEM_TIER, "ledmap"); // will free memory if it cannot resize
       }
       if ((size > 0) && (customMappingTable == nullptr)) { // second try
         DEBUG_PRINTLN("setUpMatrix: trying to get fresh memory block.");
-        customMappingTable = (uint16_t*) calloc(size, sizeof(uint16_t));
+        customMappingTable = (pixel_index_t*) tieredCalloc(size, sizeof(pixel_index_t), LEDMAP_MEM_TIER, "ledmap");
         if (customMappingTable == nullptr) { 
           USER_PRINTLN("setUpMatrix: alloc failed");
           errorFlag = ERR_LOW_MEM; // WLEDMM raise errorflag
@@ -91,7 +94,7 @@ void WS2812FX::setUpMatrix() {
 
       // fill with empty in case we don't fill the entire matrix
       for (size_t i = 0; i< customMappingTableSize; i++) { //WLEDMM use customMappingTableSize
-        customMappingTable[i] = (uint16_t)-1;
+        customMappingTable[i] = PIXEL_INDEX_NONE;
       }
 
       // we will try to load a "gap" array (a JSON file)
@@ -152,7 +155,7 @@ void WS2812FX::setUpMatrix() {
 
       #ifdef WLED_DEBUG_MAPS
       DEBUG_PRINTF("Matrix ledmap: \n");
-      for (uint16_t i=0; i<customMappingSize; i++) {
+      for (unsigned i=0; i<customMappingSize; i++) {
         if (!(i%Segment::maxWidth)) DEBUG_PRINTLN();
         DEBUG_PRINTF("%4d,", customMappingTable[i]);
       }
@@ -177,11 +180,11 @@ void WS2812FX::setUpMatrix() {
   if (customMappingTable != nullptr && customMappingTableSize > 0) {
     bool isIdentity = true;
     for (size_t i = 0; (i< customMappingSize) && isIdentity; i++) { //WLEDMM use customMappingTableSize
-      if (customMappingTable[i] != (uint16_t)i ) isIdentity = false;
+      if (customMappingTable[i] != (pixel_index_t)i ) isIdentity = false;
     }
     if (isIdentity) {
       free(customMappingTable); customMappingTable = nullptr;      
-      USER_PRINTF("!setupmatrix: customMappingTable is not needed. Dropping %d bytes.\n", customMappingTableSize * sizeof(uint16_t));
+      USER_PRINTF("!setupmatrix: customMappingTable is not needed. Dropping %d bytes.\n", customMappingTableSize * sizeof(pixel_index_t));
       customMappingTableSize = 0;
       customMappingSize = 0;
       loadedLedmap = 0; //WLEDMM
@@ -197,7 +200,13 @@ void WS2812FX::setUpMatrix() {
 // absolute matrix version of setPixelColor(), without error checking
 void IRAM_ATTR __attribute__((hot)) WS2812FX::setPixelColorXY_fast(int x, int y, uint32_t col) //WLEDMM: IRAM_ATTR conditionally
 {
-  uint_fast16_t index = y * Segment::maxWidth + x;
+  unsigned index = y * Segment::maxWidth + x;
+#ifdef WLEDMM_LAYER_COMPOSITOR
+  if (_compositor != COMPOSITE_OFF) { if (_compositor == COMPOSITE_BLEND) compositePixel(index, col); return; } // only segment buffers while rendering layers
+#endif
+#ifdef WLEDMM_FUSED_PIXELMAP
+  if (busses.setPixelColorFused(_fusedMapReady ? _fusedMap : nullptr, _fusedMapSize, _fusedMapGen, index, col)) return;
+#endif
   if (index < customMappingSize) index = customMappingTable[index];
   if (index >= _length) return;
   busses.setPixelColor(index, col);
@@ -208,9 +217,15 @@ void IRAM_ATTR_YN WS2812FX::setPixelColorXY(int x, int y, uint32_t col) //WLEDMM
 {
 #ifndef WLED_DISABLE_2D
   if (!isMatrix) return; // not a matrix set-up
-  uint_fast16_t index = y * Segment::maxWidth + x;
+  unsigned index = y * Segment::maxWidth + x;
 #else
-  uint16_t index = x;
+  unsigned index = x;
+#endif
+#ifdef WLEDMM_LAYER_COMPOSITOR
+  if (_compositor != COMPOSITE_OFF) { if (_compositor == COMPOSITE_BLEND) compositePixel(index, col); return; } // only segment buffers while rendering layers
+#endif
+#ifdef WLEDMM_FUSED_PIXELMAP
+  if (busses.setPixelColorFused(_fusedMapReady ? _fusedMap : nullptr, _fusedMapSize, _fusedMapGen, index, col)) return;
 #endif
   if (index < customMappingSize) index = customMappingTable[index];
   if (index >= _length) return;
@@ -220,9 +235,9 @@ void IRAM_ATTR_YN WS2812FX::setPixelColorXY(int x, int y, uint32_t col) //WLEDMM
 // returns RGBW values of pixel
 uint32_t __attribute__((hot)) WS2812FX::getPixelColorXY(uint16_t x, uint16_t y) const {
 #ifndef WLED_DISABLE_2D
-  uint_fast16_t index = (y * Segment::maxWidth + x); //WLEDMM: use fast types
+  unsigned index = (y * Segment::maxWidth + x); //WLEDMM: use fast types
 #else
-  uint16_t index = x;
+  unsigned index = x;
 #endif
   if (index < customMappingSize) index = customMappingTable[index];
   if (index >= _length) return 0;
@@ -231,9 +246,9 @@ uint32_t __attribute__((hot)) WS2812FX::getPixelColorXY(uint16_t x, uint16_t y)
 
 uint32_t __attribute__((hot)) WS2812FX::getPixelColorXYRestored(uint16_t x, uint16_t y)  const {  // WLEDMM gets the original color from the driver (without downscaling by _bri)
   #ifndef WLED_DISABLE_2D
-    uint_fast16_t index = (y * Segment::maxWidth + x); //WLEDMM: use fast types
+    unsigned index = (y * Segment::maxWidth + x); //WLEDMM: use fast types
   #else
-    uint16_t index = x;
+    unsigned index = x;
   #endif
   if (index < customMappingSize) index = customMappingTable[index];
   if (index >= _length) return 0;
@@ -362,7 +377,7 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col) //WLEDMM:
   }
 
   const uint_fast16_t glen_ = groupLength(); // WLEDMM optimization
-  const uint_fast16_t wid_ = max(uint16_t(1), width());
+  const uint_fast16_t wid_ = max(pixel_index_t(1), width());
   const uint_fast16_t hei_ = max(uint16_t(1), height());
 
   x *= glen_; // expand to physical pixels
@@ -481,6 +496,12 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColorXY_slow(int x, int y) const { // WLE
 // Blends the specified color with the existing pixel color.
 void Segment::blendPixelColorXY(uint16_t x, uint16_t y, uint32_t color, uint8_t blend) {
   if (blend == UINT8_MAX) setPixelColorXY(x, y, color);
+#ifdef WLEDMM_COLOR_8DOT8
+  else if (ledsrgb && ledsfrac && (x < virtualWidth()) && (y < virtualHeight())) { // WLEDMM blend in 8.8 fixed point
+    unsigned i = XY(x, y);
+    setPixelColorXY(int(x), int(y), setLedsFrac(i, color_blend16(getLeds16(i), COLOR8TO16(color), blend * 257U)));
+  }
+#endif
   else setPixelColorXY(x, y, color_blend(getPixelColorXY(x,y), color, blend));
 }
 
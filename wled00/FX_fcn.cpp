@@ -10,6 +10,9 @@
 #ifdef ARDUINO_ARCH_ESP32
 #include <esp_timer.h>     // WLEDMM to get esp_timer_get_time() 
 #endif
+#ifdef WLEDMM_SEGMENT_ARENA
+#include "seg_arena.h"
+#endif
 
 /*
   Custom per-LED mapping has moved!
@@ -73,7 +76,10 @@ bool strip_uses_global_leds(void) {
 ///////////////////////////////////////////////////////////////////////////////
 size_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
 CRGB    *Segment::_globalLeds = nullptr;
-uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
+#ifdef WLEDMM_COLOR_8DOT8
+uint8_t *Segment::_globalLedsFrac = nullptr;
+#endif
+pixel_index_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
 
 CRGBPalette16 Segment::_currentPalette    = CRGBPalette16(CRGB::Black);
@@ -108,13 +114,13 @@ void Segment::allocLeds() {
     DEBUG_PRINTF("allocLeds warning: size == %u !!\n", size);
     if (ledsrgb && (ledsrgbSize == 0)) {
       USER_PRINTLN("allocLeds warning: ledsrgbSize == 0 but ledsrgb!=NULL");
-      free(ledsrgb); ledsrgb=nullptr;
+      segFree(ledsrgb); ledsrgb=nullptr;
     } // softhack007 clean up buffer
   }
   if ((size > 0) && (!ledsrgb || size > ledsrgbSize)) {    //softhack dont allocate zero bytes
     USER_PRINTF("allocLeds (%d,%d to %d,%d), %u from %u\n", start, startY, stop, stopY, size, ledsrgb?ledsrgbSize:0);
-    if (ledsrgb) free(ledsrgb);   // we need a bigger buffer, so free the old one first
-    ledsrgb = (CRGB*)calloc(size, 1);
+    if (ledsrgb) segFree(ledsrgb);   // we need a bigger buffer, so free the old one first
+    ledsrgb = (CRGB*)segAlloc(&ledsrgb, size);
     ledsrgbSize = ledsrgb?size:0;
     if (ledsrgb == nullptr) {
       USER_PRINTLN("allocLeds failed!!");
@@ -135,6 +141,8 @@ Segment::Segment(Segment &&orig) noexcept {
   orig._isSuperSimpleSegment = false;
 
   memcpy((void*)this, (void*)&orig, sizeof(Segment));
+  segRebind(data, &data);       // WLEDMM buffers now belong to this
+  segRebind(ledsrgb, &ledsrgb);
   orig.transitional = false; // old segment cannot be in transition any more
 #ifdef WLEDMM_FASTPATH
   // WLEDMM prevent any draw calls to old segment
@@ -159,7 +167,7 @@ Segment& Segment::operator= (const Segment &orig) {
     if (_t)   delete _t;
     CRGB* oldLeds = ledsrgb;
     size_t oldLedsSize = ledsrgbSize;
-    if (ledsrgb && !Segment::_globalLeds) free(ledsrgb);
+    if (ledsrgb && !Segment::_globalLeds) segFree(ledsrgb);
     deallocateData();
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
@@ -196,13 +204,15 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (name) { delete[] name; name = nullptr; } // free old name
     deallocateData(); // free old runtime data
     if (_t) { delete _t; _t = nullptr; }
-    if (ledsrgb && !Segment::_globalLeds) free(ledsrgb); //WLEDMM: not needed anymore as we will use leds from copy. no need to nullify ledsrgb as it gets new value in memcpy
+    if (ledsrgb && !Segment::_globalLeds) segFree(ledsrgb); //WLEDMM: not needed anymore as we will use leds from copy. no need to nullify ledsrgb as it gets new value in memcpy
 
     // WLEDMM temporarily prevent any fast draw calls to old and new segment
     orig._isSimpleSegment = false;
     orig._isSuperSimpleSegment = false;
 
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
+    segRebind(data, &data);       // WLEDMM buffers now belong to this
+    segRebind(ledsrgb, &ledsrgb);
 #ifdef WLEDMM_FASTPATH
     // WLEDMM temporarily prevent any draw calls to old segment
     orig._isValid2D = false;
@@ -238,7 +248,7 @@ bool Segment::allocateData(size_t len) {
   //  data = (byte*) ps_malloc(len);
   //else
   //#endif
-    data = (byte*) malloc(len);
+    data = (byte*) segAlloc(&data, len); // WLEDMM zero-initialized
   if (!data) {
       _dataLen = 0; // WLEDMM reset dataLen
       errorFlag = ERR_LOW_MEM; // WLEDMM raise errorflag
@@ -248,20 +258,139 @@ bool Segment::allocateData(size_t len) {
   } //allocation failed
   Segment::addUsedSegmentData(len);
   _dataLen = len;
-  memset(data, 0, len);
   if (errorFlag == ERR_LOW_SEG_MEM) errorFlag = ERR_NONE; // WLEDMM reset errorflag on success
   return true;
 }
 
 void Segment::deallocateData() {
   if (!data) {_dataLen = 0; return;}  // WLEDMM reset dataLen
-  free(data);
+  segFree(data);
   data = nullptr;
   //USER_PRINTF("Segment::deallocateData: free'd   %d bytes.\n", _dataLen);
   Segment::addUsedSegmentData(-_dataLen);
   _dataLen = 0;
 }
 
+#ifdef WLEDMM_SEGMENT_ARENA
+// WLEDMM segment arena: data[] and local ledsrgb[] of all segments share one block of internal RAM (see seg_arena.h).
+// Buffers that don't fit go to the heap - or to PSRAM with WLEDMM_SEGMENT_ARENA_PSRAM, as they are the "cold" overflow.
+static SegmentArena segArena;
+static uint32_t segArenaSpills = 0;     // buffers that did not fit into the arena
+static bool     segArenaHoles = false;  // resetIfRequired() freed buffers below the top
+static uint8_t  segArenaPins = 0;       // async readers that cache data/ledsrgb pointers (guarded by the arena lock)
+#ifdef ARDUINO_ARCH_ESP32
+static StaticSemaphore_t segArenaMuxBuffer;
+static SemaphoreHandle_t segArenaMux = nullptr;  // web server and strip may allocate at the same time
+#define SEG_ARENA_LOCK()   if (segArenaMux) xSemaphoreTake(segArenaMux, portMAX_DELAY)
+#define SEG_ARENA_UNLOCK() if (segArenaMux) xSemaphoreGive(segArenaMux)
+#else
+#define SEG_ARENA_LOCK()
+#define SEG_ARENA_UNLOCK()
+#endif
+
+void* Segment::segAlloc(void* owner, size_t len) {
+  SEG_ARENA_LOCK();
+  void* ptr = segArena.alloc(owner, len);
+  SEG_ARENA_UNLOCK();
+  if (ptr || len == 0) return ptr;
+  segArenaSpills++;
+  #ifdef WLEDMM_SEGMENT_ARENA_PSRAM
+  return tieredCalloc(len, 1, WLED_MEM_COLD, "segment spill");
+  #else
+  return tieredCalloc(len, 1, WLED_MEM_HOT, "segment spill");
+  #endif
+}
+
+void Segment::segFree(void* ptr) {
+  if (ptr == nullptr) return;
+  SEG_ARENA_LOCK();
+  bool inArena = segArena.contains(ptr);
+  if (inArena) segArena.release(ptr);
+  SEG_ARENA_UNLOCK();
+  if (!inArena) free(ptr);
+}
+
+void Segment::segRebind(void* ptr, void* owner) {
+  if (ptr == nullptr) return;
+  SEG_ARENA_LOCK();
+  segArena.rebind(ptr, owner);
+  SEG_ARENA_UNLOCK();
+}
+
+void Segment::pinArena(bool pin) {
+  SEG_ARENA_LOCK();
+  if (pin) segArenaPins++;
+  else if (segArenaPins) segArenaPins--;
+  SEG_ARENA_UNLOCK();
+}
+
+// Compaction moves data[] and ledsrgb[] of every segment, so nobody else may look at them meanwhile:
+// effects are not running (called from service() before drawing), the JSON lock keeps out async requests that
+// copy segments (deserializeSegment) and no pinned reader (live stream) is open. Otherwise we try again next frame.
+void Segment::compactArena(void) {
+  if (!segArenaHoles) return;
+  if (!tryJSONBufferLock(25)) return; // 24 is the sequencer
+  SEG_ARENA_LOCK();
+  size_t reclaimed = 0;
+  if (segArenaPins == 0) {
+    reclaimed = segArena.compact();
+    segArenaHoles = false;
+  }
+  SEG_ARENA_UNLOCK();
+  releaseJSONBufferLock();
+  if (reclaimed) DEBUG_PRINTF("Segment arena: compacted, %u bytes reclaimed.\n", unsigned(reclaimed));
+}
+
+// called from finalizeInit(). Live buffers move along; without enough RAM the old arena stays.
+void Segment::setUpArena(size_t capacity) {
+  #ifdef ARDUINO_ARCH_ESP32
+  if (segArenaMux == nullptr) segArenaMux = xSemaphoreCreateMutexStatic(&segArenaMuxBuffer);
+  #endif
+  capacity = (capacity + SEG_ARENA_ALIGN - 1) & ~size_t(SEG_ARENA_ALIGN - 1);
+  if (capacity == segArena.capacity()) return;
+
+  SEG_ARENA_LOCK();
+  if (segArena.empty()) {
+    free(segArena.base());
+    segArena.attach(nullptr, 0);
+  }
+  void* mem = nullptr;
+  if (capacity + 32768 < ESP.getFreeHeap()) {  // leave room for everybody else
+    mem = tieredMalloc(capacity, WLED_MEM_HOT, "segment arena"); // plain malloc() might put large blocks into PSRAM
+  }
+  if (mem && segArena.empty()) segArena.attach(mem, capacity);
+  else if (mem) {
+    void* old = segArena.moveTo(mem, capacity);
+    if (old) free(old);
+    else { free(mem); mem = nullptr; } // live buffers don't fit
+  }
+  SEG_ARENA_UNLOCK();
+  if (mem) USER_PRINTF("Segment arena: %u bytes.\n", unsigned(segArena.capacity()));
+  else USER_PRINTF("Segment arena: not enough memory for %u bytes, using heap.\n", unsigned(capacity));
+}
+
+void serializeSegmentArena(JsonObject root) {
+  SEG_ARENA_LOCK();
+  SegmentArena::Stats st = segArena.stats();
+  SEG_ARENA_UNLOCK();
+  root[F("size")]  = st.capacity;
+  root[F("used")]  = st.used;
+  root[F("free")]  = st.free;
+  root[F("maxfree")] = st.largestNow;
+  root[F("frag")]  = SegmentArena::fragmentation(st); // percent of free bytes sitting in holes
+  root[F("bufs")]  = st.buffers;
+  root[F("compact")] = st.compactions;
+  root[F("spill")] = segArenaSpills;
+  root[F("segdata")] = Segment::getUsedSegmentData();
+  root[F("segmax")] = MAX_SEGMENT_DATA;
+}
+#else
+void* Segment::segAlloc(void* owner, size_t len) { return tieredCalloc(len, 1, WLED_MEM_HOT, "segment"); }
+void  Segment::segFree(void* ptr) { free(ptr); }
+void  Segment::segRebind(void* ptr, void* owner) {}
+void  Segment::pinArena(bool pin) {}
+#endif
+
 /**
   * If reset of this segment was requested, clears runtime
   * settings of this segment.
@@ -271,9 +400,12 @@ void Segment::deallocateData() {
   */
 void Segment::resetIfRequired() {
   if (reset) {
-    if (ledsrgb && !Segment::_globalLeds) { free(ledsrgb); ledsrgb = nullptr; ledsrgbSize=0;} // WLEDMM segment has changed, so we need a fresh buffer.
+    if (ledsrgb && !Segment::_globalLeds) { segFree(ledsrgb); ledsrgb = nullptr; ledsrgbSize=0;} // WLEDMM segment has changed, so we need a fresh buffer.
     if (transitional && _t) { transitional = false; delete _t; _t = nullptr; }
     deallocateData();
+    #ifdef WLEDMM_SEGMENT_ARENA
+    segArenaHoles = true; // WLEDMM a freed block at the top is trimmed right away, holes wait for compactArena()
+    #endif
     next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0;
     reset = false; // setOption(SEG_OPTION_RESET, false);
     startFrame();   // WLEDMM update cached propoerties
@@ -300,6 +432,9 @@ void Segment::setUpLeds() {
     ledsrgb = &Segment::_globalLeds[start];
     ledsrgbSize = length() * sizeof(CRGB); // also set this when using global leds.
     #endif
+    #ifdef WLEDMM_COLOR_8DOT8
+    ledsfrac = Segment::_globalLedsFrac ? Segment::_globalLedsFrac + (ledsrgb - Segment::_globalLeds) * 3 : nullptr; // same offset as ledsrgb
+    #endif
   } else if (length() > 0) { //WLEDMM we always want a new buffer //softhack007 quickfix - avoid malloc(0) which is undefined behaviour (should not happen, but i've seen it)
     //#if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM) && defined(WLED_USE_PSRAM)
     //if (psramFound())
@@ -307,6 +442,9 @@ void Segment::setUpLeds() {
     //else
     //#endif
     allocLeds(); //WLEDMM
+    #ifdef WLEDMM_COLOR_8DOT8
+    ledsfrac = nullptr; // WLEDMM 8.8 pixels only supported with global leds[]
+    #endif
     //USER_PRINTF("\nsetUpLeds() local LEDs: startX=%d stopx=%d startY=%d stopy=%d maxwidth=%d; length=%d, size=%d\n\n", start, stop, startY, stopY, Segment::maxWidth, length(), ledsrgbSize/3);
   }
 }
@@ -510,7 +648,7 @@ void Segment::handleTransition() {
   }
 }
 
-void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t ofs, uint16_t i1Y, uint16_t i2Y) {
+void Segment::setUp(pixel_index_t i1, pixel_index_t i2, uint8_t grp, uint8_t spc, uint16_t ofs, uint16_t i1Y, uint16_t i2Y) {
   //return if neither bounds nor grouping have changed
   bool boundsUnchanged = (start == i1 && stop == i2);
   #ifndef WLED_DISABLE_2D
@@ -529,7 +667,7 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
     return;
   }
   if (i1 < Segment::maxWidth || (i1 >= Segment::maxWidth*Segment::maxHeight && i1 < strip.getLengthTotal())) start = i1; // Segment::maxWidth equals strip.getLengthTotal() for 1D
-  stop = i2 > Segment::maxWidth*Segment::maxHeight ? min(i2,strip.getLengthTotal()) : (i2 > Segment::maxWidth ? Segment::maxWidth : max((uint16_t)1,i2));  // WLEDMM: use native min/max
+  stop = i2 > Segment::maxWidth*Segment::maxHeight ? min(i2, strip.getLengthTotal()) : (i2 > Segment::maxWidth ? Segment::maxWidth : max(pixel_index_t(1), i2));  // WLEDMM: use native min/max
   startY = 0;
   stopY  = 1;
   #ifndef WLED_DISABLE_2D
@@ -684,7 +822,7 @@ class JMapC {
       if (jVectorMap.size() > 0) {
         DEBUG_PRINTLN("delete jVectorMap");
         for (size_t i=0; i<jVectorMap.size(); i++)
-          if (jVectorMap[i].array) { delete[] jVectorMap[i].array; jVectorMap[i].array = nullptr; } // softhack007 quickfix for memory leak
+          if (jVectorMap[i].array) { free(jVectorMap[i].array); jVectorMap[i].array = nullptr; } // softhack007 quickfix for memory leak
         jVectorMap.clear();
       }
     }
@@ -758,7 +896,8 @@ class JMapC {
             ArrayAndSize arrayAndSize;
             arrayAndSize.size = 0;
             if (arrayChunk[0].is<JsonArray>()) { //if array of arrays
-              arrayAndSize.array = new(std::nothrow) XandY[arrayChunk.size()];
+              arrayAndSize.array = (XandY*) tieredMalloc(sizeof(XandY) * arrayChunk.size(), WLED_MEM_WARM, "jMap");
+              if (!arrayAndSize.array) continue;
               for (JsonVariant arrayElement: arrayChunk) {
                 maxWidth = max((uint16_t)maxWidth, arrayElement[0].as<uint16_t>());       // WLEDMM use native min/max
                 maxHeight = max((uint16_t)maxHeight, arrayElement[1].as<uint16_t>());     // WLEDMM
@@ -769,7 +908,8 @@ class JMapC {
               }
             }
             else { // if array (of x and y)
-              arrayAndSize.array = new(std::nothrow) XandY[1];
+              arrayAndSize.array = (XandY*) tieredMalloc(sizeof(XandY), WLED_MEM_WARM, "jMap");
+              if (!arrayAndSize.array) continue;
               maxWidth = max((uint16_t)maxWidth, arrayChunk[0].as<uint16_t>());         // WLEDMM use native min/max
               maxHeight = max((uint16_t)maxHeight, arrayChunk[1].as<uint16_t>());       // WLEDMM
               arrayAndSize.array[arrayAndSize.size].x = arrayChunk[0].as<uint8_t>();
@@ -862,7 +1002,7 @@ static int getPinwheelLength(int vW, int vH) {
 #endif
 
 // 1D strip
-uint16_t Segment::calc_virtualLength() const {
+pixel_index_t Segment::calc_virtualLength() const {
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
     uint16_t vW = calc_virtualWidth();
@@ -904,7 +1044,7 @@ uint16_t Segment::calc_virtualLength() const {
   }
 #endif
   uint16_t groupLen = groupLength();
-  uint16_t vLength = (length() + groupLen - 1) / groupLen;
+  pixel_index_t vLength = (length() + groupLen - 1) / groupLen;
   if (mirror && width() > 1) vLength = (vLength + 1) /2;  // divide by 2 if mirror, leave at least a single LED // WLEDMM bugfix for pseudo 2d strips
   return vLength;
 }
@@ -939,9 +1079,9 @@ void IRAM_ATTR_YN __attribute__((hot)) Segment::setPixelColor(int i, uint32_t co
 {
   if (!isActive()) return; // not active
 #ifndef WLED_DISABLE_2D
-  int vStrip = i>>16; // hack to allow running on virtual strips (2D segment columns/rows)
+  int vStrip = i>>SEG_VSTRIP_SHIFT; // hack to allow running on virtual strips (2D segment columns/rows)
 #endif
-  i &= 0xFFFF;
+  i &= SEG_VSTRIP_MASK;
 
   if (i >= virtualLength() || i<0) return;  // if pixel would fall out of segment just exit
 
@@ -1187,25 +1327,25 @@ void Segment::setPixelColor(float i, uint32_t col, bool aa)
 
   float fC = i * (virtualLength()-1);
   if (aa) {
-    uint16_t iL = roundf(fC-0.49f);
-    uint16_t iR = roundf(fC+0.49f);
+    pixel_index_t iL = roundf(fC-0.49f);
+    pixel_index_t iR = roundf(fC+0.49f);
     float    dL = (fC - iL)*(fC - iL);
     float    dR = (iR - fC)*(iR - fC);
-    uint32_t cIL = getPixelColor(iL | (vStrip<<16));
-    uint32_t cIR = getPixelColor(iR | (vStrip<<16));
+    uint32_t cIL = getPixelColor(iL | (vStrip<<SEG_VSTRIP_SHIFT));
+    uint32_t cIR = getPixelColor(iR | (vStrip<<SEG_VSTRIP_SHIFT));
     if (iR!=iL) {
       // blend L pixel
       cIL = color_blend(col, cIL, uint8_t(dL*255.0f));
-      setPixelColor(iL | (vStrip<<16), cIL);
+      setPixelColor(iL | (vStrip<<SEG_VSTRIP_SHIFT), cIL);
       // blend R pixel
       cIR = color_blend(col, cIR, uint8_t(dR*255.0f));
-      setPixelColor(iR | (vStrip<<16), cIR);
+      setPixelColor(iR | (vStrip<<SEG_VSTRIP_SHIFT), cIR);
     } else {
       // exact match (x & y land on a pixel)
-      setPixelColor(iL | (vStrip<<16), col);
+      setPixelColor(iL | (vStrip<<SEG_VSTRIP_SHIFT), col);
     }
   } else {
-    setPixelColor(uint16_t(roundf(fC)) | (vStrip<<16), col);
+    setPixelColor(pixel_index_t(roundf(fC)) | (vStrip<<SEG_VSTRIP_SHIFT), col);
   }
 }
 
@@ -1213,9 +1353,9 @@ uint32_t __attribute__((hot)) Segment::getPixelColor(int i) const
 {
   if (!isActive()) return 0; // not active
 #ifndef WLED_DISABLE_2D
-  int vStrip = i>>16;
+  int vStrip = i>>SEG_VSTRIP_SHIFT;
 #endif
-  i &= 0xFFFF;
+  i &= SEG_VSTRIP_MASK;
 
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
@@ -1338,6 +1478,7 @@ uint8_t Segment::differs(Segment& b) const {
   if (custom3 != b.custom3)     d |= SEG_DIFFERS_FX;
   if (startY != b.startY)       d |= SEG_DIFFERS_BOUNDS;
   if (stopY != b.stopY)         d |= SEG_DIFFERS_BOUNDS;
+  if (blendMode != b.blendMode) d |= SEG_DIFFERS_OPT;     // WLEDMM layer compositor
 
   //bit pattern: (msb first) set:2, sound:1, mapping:3, transposed, mirrorY, reverseY, [transitional, reset,] paused, mirrored, on, reverse, [selected]
   if ((options & 0b1111111110011110U) != (b.options & 0b1111111110011110U)) d |= SEG_DIFFERS_OPT;
@@ -1349,8 +1490,8 @@ uint8_t Segment::differs(Segment& b) const {
 
 void Segment::refreshLightCapabilities() {
   uint8_t capabilities = 0;
-  uint16_t segStartIdx = 0xFFFFU;
-  uint16_t segStopIdx  = 0;
+  pixel_index_t segStartIdx = PIXEL_INDEX_NONE;
+  pixel_index_t segStopIdx  = 0;
 
   if (!isActive()) {
     _capabilities = 0;
@@ -1360,9 +1501,9 @@ void Segment::refreshLightCapabilities() {
   if (start < Segment::maxWidth * Segment::maxHeight) {
     // we are withing 2D matrix (includes 1D segments)
     for (int y = startY; y < stopY; y++) for (int x = start; x < stop; x++) {
-      uint16_t index = x + Segment::maxWidth * y;
+      unsigned index = x + Segment::maxWidth * y;
       if (index < strip.customMappingSize) index = strip.customMappingTable[index]; // convert logical address to physical
-      if (index < 0xFFFFU) {
+      if (index < PIXEL_INDEX_NONE) {
         if (segStartIdx > index) segStartIdx = index;
         if (segStopIdx  < index) segStopIdx  = index;
       }
@@ -1428,6 +1569,10 @@ void __attribute__((hot)) Segment::fill(uint32_t c) {
 // Blends the specified color with the existing pixel color.
 void Segment::blendPixelColor(int n, uint32_t color, uint8_t blend) {
   if (blend == UINT8_MAX) setPixelColor(n, color); 
+#ifdef WLEDMM_COLOR_8DOT8
+  else if (ledsrgb && ledsfrac && !is2D() && (unsigned(n) < virtualLength())) // WLEDMM blend in 8.8 fixed point
+    setPixelColor(n, setLedsFrac(n, color_blend16(getLeds16(n), COLOR8TO16(color), blend * 257U)));
+#endif
   else setPixelColor(n, color_blend(getPixelColor(n), color, blend));
 }
 
@@ -1508,6 +1653,18 @@ void __attribute__((hot)) Segment::fadeToBlackBy(uint8_t fadeBy) {
   const uint_fast16_t rows = virtualHeight(); // will be 1 for 1D
   const uint_fast8_t scaledown = 255-fadeBy;  // WLEDMM faster to pre-compute this
 
+#ifdef WLEDMM_COLOR_8DOT8
+  if (ledsrgb && ledsfrac) { // WLEDMM fade in 8.8 fixed point - slow fades don't get stuck at 8bit rounding steps
+    const uint16_t scaledown16 = scaledown * 257U;
+    for (unsigned y = 0; y < rows; y++) for (unsigned x = 0; x < cols; x++) {
+      unsigned i = x + y * cols; // same index as used for ledsrgb[]
+      uint32_t cc2 = setLedsFrac(i, color_fade16(getLeds16(i), scaledown16));
+      if (is2D()) setPixelColorXY(int(x), int(y), cc2);
+      else        setPixelColor(int(x), cc2);
+    }
+    return;
+  }
+#endif
   // WLEDMM minor optimization
   if(is2D()) {
     for (unsigned y = 0; y < rows; y++) for (unsigned x = 0; x < cols; x++) {
@@ -1766,6 +1923,9 @@ void WS2812FX::finalizeInit(void)
 {
   //reset segment runtimes
   suspendStripService = true; // WLEDMM avoid running effects on an incomplete strip
+  #ifdef WLEDMM_FUSED_PIXELMAP
+  invalidateFusedMap();       // WLEDMM busses and strip length may have changed
+  #endif
   for (segment &seg : _segments) {
     seg.markForReset();
     seg.resetIfRequired();
@@ -1785,10 +1945,10 @@ void WS2812FX::finalizeInit(void)
     const uint16_t defCounts[] = {PIXEL_COUNTS};
     const uint8_t defNumBusses = ((sizeof defDataPins) / (sizeof defDataPins[0]));
     const uint8_t defNumCounts = ((sizeof defCounts)   / (sizeof defCounts[0]));
-    uint16_t prevLen = 0;
+    pixel_index_t prevLen = 0;
     for (uint8_t i = 0; i < defNumBusses && i < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; i++) {
       uint8_t defPin[] = {defDataPins[i]};
-      uint16_t start = prevLen;
+      pixel_index_t start = prevLen;
       uint16_t count = defCounts[(i < defNumCounts) ? i : defNumCounts -1];
       prevLen += count;
       BusConfig defCfg = BusConfig(DEFAULT_LED_TYPE, defPin, start, count, DEFAULT_LED_COLOR_ORDER, false, 0, RGBW_MODE_MANUAL_ONLY);
@@ -1808,7 +1968,7 @@ void WS2812FX::finalizeInit(void)
     _hasWhiteChannel |= bus->hasWhite();
     //refresh is required to remain off if at least one of the strips requires the refresh.
     _isOffRefreshRequired |= bus->isOffRefreshRequired();
-    uint16_t busEnd = bus->getStart() + bus->getLength();
+    pixel_index_t busEnd = bus->getStart() + bus->getLength();
     if (busEnd > _length) _length = busEnd;
     #ifdef ESP8266
     if ((!IS_DIGITAL(bus->getType()) || IS_2PIN(bus->getType()))) continue;
@@ -1829,6 +1989,10 @@ void WS2812FX::finalizeInit(void)
   if (Segment::_globalLeds) {
     free(Segment::_globalLeds);
     Segment::_globalLeds = nullptr;
+    #ifdef WLEDMM_COLOR_8DOT8
+    if (Segment::_globalLedsFrac) free(Segment::_globalLedsFrac);
+    Segment::_globalLedsFrac = nullptr;
+    #endif
     purgeSegments(true);   // WLEDMM moved here, because it seems to improve stability.
   }
   if (useLedsArray && getLengthTotal()>0) { // WLEDMM avoid malloc(0)
@@ -1839,16 +2003,31 @@ void WS2812FX::finalizeInit(void)
     //  Segment::_globalLeds = (CRGB*) ps_malloc(arrSize);
     //else
     //#endif
-      if (arrSize > 0) Segment::_globalLeds = (CRGB*) malloc(arrSize); // WLEDMM avoid malloc(0)
+      if (arrSize > 0) Segment::_globalLeds = (CRGB*) tieredMalloc(arrSize, WLED_MEM_HOT, "leds"); // WLEDMM avoid malloc(0)
     if ((Segment::_globalLeds != nullptr) && (arrSize > 0)) memset(Segment::_globalLeds, 0, arrSize); // WLEDMM avoid dereferencing nullptr
     if ((Segment::_globalLeds == nullptr) && (arrSize > 0)) errorFlag = ERR_LOW_MEM; // WLEDMM raise errorflag
+    #ifdef WLEDMM_COLOR_8DOT8
+    // WLEDMM lower bytes for 8.8 pixels - optional, segments fall back to 8bit processing when this fails
+    if (Segment::_globalLeds != nullptr) Segment::_globalLedsFrac = (uint8_t*) tieredCalloc(arrSize, 1, WLED_MEM_HOT, "leds 8.8");
+    if ((Segment::_globalLeds != nullptr) && (Segment::_globalLedsFrac == nullptr)) USER_PRINTLN(F("finalizeInit(): not enough memory for 8.8 pixels."));
+    #ifdef WLEDMM_COLOR_BENCHMARK
+    benchmarkColorKernels();
+    #endif
+    #endif
   }
+  #ifdef WLEDMM_SEGMENT_ARENA
+  // WLEDMM segment data quota, plus local leds[] for the whole strip when there are no global leds (and some headers)
+  Segment::setUpArena(MAX_SEGMENT_DATA + (useLedsArray ? 0 : sizeof(CRGB) * getLengthTotal()) + MAX_NUM_SEGMENTS * 64);
+  #endif
 
   //segments are created in makeAutoSegments();
   DEBUG_PRINTLN(F("Loading custom palettes"));
   loadCustomPalettes(); // (re)load all custom palettes
   DEBUG_PRINTLN(F("Loading custom ledmaps"));
   deserializeMap();     // (re)load default ledmap
+  #ifdef WLEDMM_PIXEL_BENCHMARK
+  benchmarkPixelPath();
+  #endif
   _isServicing = false;        // WLEDMM
   suspendStripService = false; // WLEDMM ready, run !
 }
@@ -1872,12 +2051,88 @@ void WS2812FX::waitUntilIdle(void) {
 #endif
 }
 
+// WLEDMM keys of the defaults section that are indexed, bit n of mode_meta_t.defMask
+static const char _fxDefaultKeys[FX_DEFAULT_KEYS][4] PROGMEM = { "sx", "ix", "c1", "c2", "c3", "o1", "o2", "o3", "m12", "si", "rev", "mi", "rY", "mY", "pal" };
+
+// parse effect data string once (name length, flags, defaults), so UI requests and setMode() don't need to scan PROGMEM strings
+void WS2812FX::indexModeData(uint8_t id) {
+  if (id >= _modeData.size()) return;
+  if (_modeMeta.size() <= id) _modeMeta.resize(id+1, mode_meta_t{0, 0, 0, 0});
+  mode_meta_t &meta = _modeMeta[id];
+  if (meta.defMask) {
+    // re-index: drop the old defaults of this effect, so _modeDefaults does not grow
+    unsigned oldCount = __builtin_popcount(meta.defMask);
+    unsigned oldOffset = min(unsigned(meta.defOffset), unsigned(_modeDefaults.size()));
+    _modeDefaults.erase(_modeDefaults.begin() + oldOffset, _modeDefaults.begin() + min(oldOffset + oldCount, unsigned(_modeDefaults.size())));
+    for (auto &m : _modeMeta) if (m.defMask && m.defOffset > oldOffset) m.defOffset -= oldCount;
+  }
+  meta = mode_meta_t{0, 0, 0, 0};
+
+  char lineBuffer[256];
+  strncpy_P(lineBuffer, _modeData[id], sizeof(lineBuffer)-1);
+  lineBuffer[sizeof(lineBuffer)-1] = '\0';
+
+  char *dataPtr = strchr(lineBuffer, '@');
+  meta.nameLen = dataPtr ? (dataPtr - lineBuffer) : strlen(lineBuffer);
+  if (dataPtr) {
+    // flags are the 4th section after '@'
+    char *flagPtr = dataPtr;
+    for (int s = 0; s < 3 && flagPtr; s++) flagPtr = strchr(flagPtr+1, ';');
+    if (flagPtr) for (flagPtr++; *flagPtr && *flagPtr != ';'; flagPtr++) {
+      switch (*flagPtr) {
+        case '1': meta.flags |= FX_META_1D;     break;
+        case '2': meta.flags |= FX_META_2D;     break;
+        case 'v': meta.flags |= FX_META_VOLUME; break;
+        case 'f': meta.flags |= FX_META_FREQ;   break;
+      }
+    }
+  }
+
+  // defaults are in the last section (e.g. "Juggle@!,Trail;!,!,;!;sx=16,ix=240,1d")
+  char *defPtr = strrchr(lineBuffer, ';');
+  if (!defPtr) return;
+  int16_t values[FX_DEFAULT_KEYS];
+  char *savePtr = nullptr;
+  for (char *token = strtok_r(defPtr+1, ",", &savePtr); token; token = strtok_r(nullptr, ",", &savePtr)) {
+    char *eq = strchr(token, '=');
+    if (!eq) continue;
+    *eq = '\0';
+    for (unsigned k = 0; k < FX_DEFAULT_KEYS; k++) {
+      if (strcmp_P(token, _fxDefaultKeys[k]) == 0) { meta.defMask |= (1 << k); values[k] = constrain(atoi(eq+1), 0, 255); break; }
+    }
+  }
+  meta.defOffset = _modeDefaults.size();
+  for (unsigned k = 0; k < FX_DEFAULT_KEYS; k++) if (meta.defMask & (1 << k)) _modeDefaults.push_back(values[k]);
+}
+
+int16_t WS2812FX::getModeDefault(uint8_t id, const char *key) const {
+  if (id >= _modeCount || id >= _modeMeta.size()) return -1;
+  const mode_meta_t &meta = _modeMeta[id];
+  for (unsigned k = 0; k < FX_DEFAULT_KEYS; k++) {
+    if (strcmp_P(key, _fxDefaultKeys[k]) != 0) continue;
+    if (!(meta.defMask & (1 << k))) return -1;
+    unsigned idx = meta.defOffset + __builtin_popcount(meta.defMask & ((1 << k) - 1));
+    return (idx < _modeDefaults.size()) ? _modeDefaults[idx] : -1;
+  }
+  return -2; // not an indexed key
+}
+
 void WS2812FX::service() {
   unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days // WLEDMM avoid losing precision
   if (OTAisRunning) return; // WLEDMM avoid flickering during OTA
 
   now = nowUp + timebase;
   unsigned long elapsed = nowUp - _lastServiceShow;
+  bool frameLocked = false;
+  #ifdef WLED_ENABLE_FRAMESYNC
+  // WLEDMM frame sync: render on the shared tick, with the same effect time as all other controllers
+  unsigned long effectTime = now;
+  int fsState = frameSyncPoll(effectTime);
+  if (fsState == 0) return;
+  if (fsState > 0) { now = effectTime; frameLocked = true; }
+  if (!frameLocked)
+  #endif
+  {
   #if defined(ARDUINO_ARCH_ESP32) && defined(WLEDMM_FASTPATH)   // WLEDMM go faster on ESP32
   //if (_suspend) return;
   if (elapsed < 2) return;                                                       // keep wifi alive
@@ -1891,11 +2146,27 @@ void WS2812FX::service() {
   #else  // legacy
   if (elapsed < _frametime) return;
   #endif
+  }
+
+  #ifdef WLED_ENABLE_SEQUENCER
+  sequencerService(); // WLEDMM fire due show cues on this tick, before effects draw
+  #endif
 
   bool doShow = false;
   unsigned speedLimit = (_targetFps != FPS_UNLIMITED) && (_targetFps != FPS_UNLIMITED_AC) ? (0.85f * FRAMETIME) : 1;      // WLEDMM minimum for effect frametime
 
+  #ifdef WLEDMM_FUSED_PIXELMAP
+  if (_fusedMapDirty || (_fusedMapGen != busses.getGeneration())) buildFusedMap(); // before effects start drawing
+  #endif
+
+  #ifdef WLEDMM_SEGMENT_ARENA
+  Segment::compactArena(); // WLEDMM no effect is drawing yet
+  #endif
+
   _isServicing = true;
+  #ifdef WLEDMM_LAYER_COMPOSITOR
+  bool layered = prepareLayers();
+  #endif
   _segment_index = 0;
   for (segment &seg : _segments) {
 #ifdef WLEDMM_FASTPATH
@@ -1908,14 +2179,14 @@ void WS2812FX::service() {
     if (!seg.on && !seg.transitional) continue;    // WLEDMM skip disabled segments, unless a crossfade is ongoing
 
     // last condition ensures all solid segments are updated at the same time
-    if(nowUp >= seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))  // WLEDMM ">=" instead of ">"
+    if(nowUp >= seg.next_time || _triggered || frameLocked || (doShow && seg.mode == FX_MODE_STATIC))  // WLEDMM ">=" instead of ">"; frameLocked: all segments render on the shared tick
     {
       if (seg.grouping == 0) seg.grouping = 1; //sanity check
       if (!seg.freeze) doShow = true;
       uint16_t frameDelay = FRAMETIME;    // WLEDMM avoid name clash with "delay" function
 
       if (!seg.freeze) { //only run effect function if not frozen
-        _virtualSegmentLength = seg.calc_virtualLength();
+        _virtualSegmentLength = min(seg.calc_virtualLength(), pixel_index_t(UINT16_MAX));
         _colors_t[0] = seg.currentColor(0, seg.colors[0]);
         _colors_t[1] = seg.currentColor(1, seg.colors[1]);
         _colors_t[2] = seg.currentColor(2, seg.colors[2]);
@@ -1949,6 +2220,12 @@ void WS2812FX::service() {
   }
   _virtualSegmentLength = 0;
   busses.setSegmentCCT(-1);
+  #ifdef WLEDMM_LAYER_COMPOSITOR
+  if (layered) {
+    if (doShow) compositeLayers();
+    _compositor = COMPOSITE_OFF;
+  }
+  #endif
   if(doShow) {
 #if 0 && defined(ARDUINO_ARCH_ESP32)      // EXPERIMENTAL - enabled this to enforce stricter frametime limits
     static unsigned long lastTimeShow = 0;
@@ -1968,25 +2245,202 @@ void WS2812FX::service() {
 
 void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
 {
-  if (i < customMappingSize) i = customMappingTable[i];
-  if (i >= _length) return;
+#ifdef WLEDMM_LAYER_COMPOSITOR
+  if (_compositor != COMPOSITE_OFF) { if (_compositor == COMPOSITE_BLEND) compositePixel(i, col); return; } // only segment buffers while rendering layers
+#endif
+#ifdef WLEDMM_FUSED_PIXELMAP
+  // map is only used while the busses it was built for exist - after removeAll()/add() the bus numbers are stale
+  if (busses.setPixelColorFused(_fusedMapReady ? _fusedMap : nullptr, _fusedMapSize, _fusedMapGen, unsigned(i), col)) return;
+#endif
+  if (unsigned(i) < customMappingSize) i = customMappingTable[i];
+  if (unsigned(i) >= _length) return; // also catches i < 0
   busses.setPixelColor(i, col);
 }
 
-uint32_t WS2812FX::getPixelColor(uint_fast16_t i) const // WLEDMM fast int types
+uint32_t WS2812FX::getPixelColor(unsigned i) const // WLEDMM fast int types
 {
   if (i < customMappingSize) i = customMappingTable[i];
   if (i >= _length) return 0;
   return busses.getPixelColor(i);
 }
 
-uint32_t WS2812FX::getPixelColorRestored(uint_fast16_t i)  const  // WLEDMM gets the original color from the driver (without downscaling by _bri)
+uint32_t WS2812FX::getPixelColorRestored(unsigned i)  const  // WLEDMM gets the original color from the driver (without downscaling by _bri)
 {
   if (i < customMappingSize) i = customMappingTable[i];
   if (i >= _length) return 0;
   return busses.getPixelColorRestored(i);
 }
 
+void WS2812FX::getPixelColorsRestored(unsigned first, unsigned count, uint32_t* out) const
+{
+  if (first < customMappingSize) { // ledmap - pixels are not contiguous
+    for (unsigned i = 0; i < count; i++) out[i] = getPixelColorRestored(first + i);
+    return;
+  }
+  if (first >= _length) count = 0;
+  else if (first + count > _length) { memset(out + (_length - first), 0, (first + count - _length) * sizeof(uint32_t)); count = _length - first; }
+  busses.getPixelColorsRestored(first, count, out);
+}
+
+#ifdef WLEDMM_FUSED_PIXELMAP
+// WLEDMM resolve ledmap and bus search once for every logical pixel. Reverse, skip and color order stay inside the bus.
+void WS2812FX::buildFusedMap(void) {
+  _fusedMapReady = false;
+  _fusedMapDirty = false;
+  _fusedMapGen = busses.getGeneration();
+  unsigned size = getLengthTotal();
+  if (size != _fusedMapSize) {
+    if (_fusedMap) free(_fusedMap);
+    _fusedMap = nullptr;
+    _fusedMapSize = 0;
+    // this is a cache - don't take memory that others need more urgently
+    if ((size == 0) || (size * sizeof(uint32_t) + 32768 > ESP.getFreeHeap())) {
+      if (size > 0) USER_PRINTF("Fused pixel map: not enough memory for %u pixels.\n", size);
+      return;
+    }
+    _fusedMap = (uint32_t*) tieredMalloc(size * sizeof(uint32_t), WLED_MEM_HOT, "fused map"); // internal RAM - this is the hot path
+    if (_fusedMap == nullptr) return;
+    _fusedMapSize = size;
+  }
+
+  unsigned unused = 0;
+  for (unsigned i = 0; i < size; i++) {
+    unsigned pix = (i < customMappingSize) ? customMappingTable[i] : i;
+    uint8_t  busNr;
+    uint16_t offset;
+    if ((pix < _length) && busses.locatePixel(pix, busNr, offset)) _fusedMap[i] = (uint32_t(busNr) << 16) | offset;
+    else { _fusedMap[i] = FUSED_PIXEL_NONE; unused++; }
+  }
+  _fusedMapReady = true;
+  DEBUG_PRINTF("Fused pixel map: %u pixels (%u without LED), %u bytes.\n", size, unused, size * sizeof(uint32_t));
+}
+#endif
+
+#ifdef WLEDMM_LAYER_COMPOSITOR
+void IRAM_ATTR_YN WS2812FX::compositePixel(unsigned i, uint32_t col) {
+  if (i < _layerFrameSize) _layerFrame[i] = color_composite(_layerFrame[i], col, _layerMode, _layerOpacity);
+}
+
+// WLEDMM called by service() before effects run - returns true if this frame is rendered as layers
+bool WS2812FX::prepareLayers(void) {
+  _compositor = COMPOSITE_OFF;
+  bool blended = false;
+  for (const segment &seg : _segments)
+    if (seg.isActive() && (seg.on || seg.transitional) && (seg.blendMode != SEG_BLEND_NORMAL)) { blended = true; break; }
+  // segments share the global leds[] buffer, so they cannot keep separate layers
+  if (!blended || useLedsArray) {
+    if (_layerFrame) { free(_layerFrame); _layerFrame = nullptr; _layerFrameSize = 0; }
+    _layersActive = false;
+    return false;
+  }
+
+  unsigned size = getLengthTotal();
+  if (size != _layerFrameSize) {
+    if (_layerFrame) free(_layerFrame);
+    _layerFrame = (uint32_t*) tieredMalloc(size * sizeof(uint32_t), WLED_MEM_HOT, "layers");
+    _layerFrameSize = _layerFrame ? size : 0;
+    if (!_layerFrame) { USER_PRINTLN(F("Layer compositor: not enough memory for frame buffer.")); _layersActive = false; return false; }
+  }
+  // each layer needs its own buffer - draw directly as before if one is missing
+  for (segment &seg : _segments) {
+    if (!seg.isActive() || (!seg.on && !seg.transitional)) continue;
+    if (!seg.ledsrgb) seg.setUpLeds();
+    if (!seg.ledsrgb) { _layersActive = false; return false; }
+  }
+  if (!_layersActive) _triggered = true; // first layered frame: all segments must fill their (new) buffers
+  _layersActive = true;
+  _compositor = COMPOSITE_RENDER;
+  return true;
+}
+
+// WLEDMM blend all segment buffers bottom to top (segment order), then send the frame to the busses
+void WS2812FX::compositeLayers(void) {
+  #ifdef WLEDMM_LAYER_TIMER
+  unsigned long t0 = micros();
+  #endif
+  memset(_layerFrame, 0, _layerFrameSize * sizeof(uint32_t));
+  _compositor = COMPOSITE_BLEND;
+  unsigned layers = 0;
+  _segment_index = 0;
+  for (segment &seg : _segments) {
+    if (seg.isActive() && (seg.on || seg.transitional) && seg.ledsrgb) {
+#ifdef WLEDMM_FASTPATH
+      _currentSeg = &seg;
+#endif
+      _virtualSegmentLength = min(seg.calc_virtualLength(), pixel_index_t(UINT16_MAX));
+      seg.startFrame();
+      _layerMode = seg.blendMode;
+      _layerOpacity = seg.currentBri(seg.on ? seg.opacity : 0);
+      // replay the layer through the segment mapping (grouping, mirror, reverse, transpose); opacity is applied on the way
+      if (seg.is2D()) {
+        int cols = seg.virtualWidth(), rows = seg.virtualHeight();
+        for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) seg.setPixelColorXY(x, y, seg.getPixelColorXY(x, y));
+      } else {
+        int len = seg.virtualLength();
+        for (int i = 0; i < len; i++) seg.setPixelColor(i, seg.getPixelColor(i));
+      }
+      layers++;
+    }
+    _segment_index++;
+  }
+  _virtualSegmentLength = 0;
+  _compositor = COMPOSITE_OFF;
+  for (unsigned i = 0; i < _layerFrameSize; i++) setPixelColor(i, _layerFrame[i]);
+
+  #ifdef WLEDMM_LAYER_TIMER
+  _layerTime += micros() - t0;
+  _layerCount += layers;
+  if (++_layerFrames >= 500) {
+    USER_PRINTF("Layer compositor: %u micros/frame, %u micros/layer (%u pixels, avg of %u frames).\n",
+                unsigned(_layerTime / _layerFrames), unsigned(_layerCount ? _layerTime / _layerCount : 0), _layerFrameSize, _layerFrames);
+    _layerTime = 0;
+    _layerCount = 0;
+    _layerFrames = 0;
+  }
+  #endif
+}
+#endif
+
+#ifdef WLEDMM_PIXEL_BENCHMARK
+// WLEDMM time the strip-level pixel path (ledmap lookup + bus search) - prints results to the serial console.
+// Run the same setup with and without WLEDMM_PIXEL_INDEX_32 to compare the compact 16bit table against 32bit indices.
+void WS2812FX::benchmarkPixelPath(void) {
+  const unsigned passes = 20;
+  unsigned len = getLengthTotal();
+  if (len == 0) return;
+  volatile uint32_t sink = 0;   // volatile - prevent the compiler from optimizing away the loops
+  bool fused = false;
+#ifdef WLEDMM_FUSED_PIXELMAP
+  if (_fusedMapDirty) buildFusedMap();
+  fused = _fusedMapReady;
+#endif
+
+  unsigned long t0 = micros();
+  for (unsigned p = 0; p < passes; p++) for (unsigned i = 0; i < len; i++) setPixelColor(i, RGBW32(p, i & 0xFF, 0, 0));
+  unsigned long tSet = micros() - t0;
+  t0 = micros();
+  for (unsigned p = 0; p < passes; p++) for (unsigned i = 0; i < len; i++) sink = getPixelColor(i);
+  unsigned long tGet = micros() - t0;
+  unsigned long tSetXY = 0;
+  unsigned callsXY = 1;
+#ifndef WLED_DISABLE_2D
+  if (isMatrix) {
+    t0 = micros();
+    for (unsigned p = 0; p < passes; p++) for (int y = 0; y < Segment::maxHeight; y++) for (int x = 0; x < Segment::maxWidth; x++) setPixelColorXY_fast(x, y, RGBW32(0, p, x & 0xFF, 0));
+    tSetXY = micros() - t0;
+    callsXY = passes * Segment::maxWidth * Segment::maxHeight;
+  }
+#endif
+  (void)sink;
+  fill(BLACK);
+
+  unsigned calls = passes * len;
+  USER_PRINTF("Pixel path (%ubit index, ledmap %u bytes,%s %u calls): set %lu ns, get %lu ns, setXY %lu ns per pixel\n",
+              unsigned(sizeof(pixel_index_t) * 8), unsigned(customMappingTableSize * sizeof(pixel_index_t)), fused ? " fused map," : "", calls,
+              (unsigned long)(tSet * 1000ULL / calls), (unsigned long)(tGet * 1000ULL / calls), (unsigned long)(tSetXY * 1000ULL / callsXY));
+}
+#endif
+
 //DISCLAIMER
 //The following function attemps to calculate the current LED power usage,
 //and will limit the brightness to stay below a set amperage threshold.
@@ -2232,8 +2686,8 @@ uint8_t WS2812FX::getActiveSegmentsNum(void) const {
   return c;
 }
 
-uint16_t WS2812FX::getLengthTotal(void) const {  // WLEDMM fast int types
-  uint_fast16_t len = Segment::maxWidth * Segment::maxHeight; // will be _length for 1D (see finalizeInit()) but should cover whole matrix for 2D
+pixel_index_t WS2812FX::getLengthTotal(void) const {  // WLEDMM fast int types
+  unsigned len = Segment::maxWidth * Segment::maxHeight; // will be _length for 1D (see finalizeInit()) but should cover whole matrix for 2D
   if (isMatrix && _length > len) len = _length; // for 2D with trailing strip
   return len;
 }
@@ -2475,7 +2929,7 @@ uint8_t WS2812FX::setPixelSegment(uint8_t n) {
   uint8_t prevSegId = _segment_index;
   if (n < _segments.size()) {
     _segment_index = n;
-    _virtualSegmentLength = _segments[_segment_index].calc_virtualLength();
+    _virtualSegmentLength = min(_segments[_segment_index].calc_virtualLength(), pixel_index_t(UINT16_MAX));
   }
   return prevSegId;
 }
@@ -2501,7 +2955,7 @@ void WS2812FX::printSize() {
   DEBUG_PRINTF("Segments: %d -> %uB\n", _segments.size(), size);
   DEBUG_PRINTF("Modes: %d*%d=%uB\n", sizeof(mode_ptr), _mode.size(), (_mode.capacity()*sizeof(mode_ptr)));
   DEBUG_PRINTF("Data: %d*%d=%uB\n", sizeof(const char *), _modeData.size(), (_modeData.capacity()*sizeof(const char *)));
-  DEBUG_PRINTF("Map: %d*%d=%uB\n", sizeof(uint16_t), (int)customMappingSize, customMappingSize*sizeof(uint16_t));
+  DEBUG_PRINTF("Map: %d*%d=%uB\n", sizeof(pixel_index_t), (int)customMappingSize, customMappingSize*sizeof(pixel_index_t));
   size = getLengthTotal();
   if (useLedsArray) DEBUG_PRINTF("Buffer: %d*%u=%uB\n", sizeof(CRGB), size, size*sizeof(CRGB));
 }
@@ -2559,6 +3013,9 @@ void WS2812FX::loadCustomPalettes() {
 //load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
 bool WS2812FX::deserializeMap(uint8_t n) {
   // 2D support creates its own ledmap (on the fly) if a ledmap.json exists it will overwrite built one.
+  #ifdef WLEDMM_FUSED_PIXELMAP
+  invalidateFusedMap();
+  #endif
 
   char fileName[32] = {'\0'};
   //WLEDMM: als support segment name ledmaps
@@ -2647,11 +3104,11 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 
     // don't use new / delete
     if ((size > 0) && (customMappingTable != nullptr)) {
-      customMappingTable = (uint16_t*) reallocf(customMappingTable, sizeof(uint16_t) * size);  // reallocf will free memory if it cannot resize
+      customMappingTable = (pixel_index_t*) tieredRealloc(customMappingTable, sizeof(pixel_index_t) * size, LEDMAP_MEM_TIER, "ledmap");  // will free memory if it cannot resize
     }
     if ((size > 0) && (customMappingTable == nullptr)) { // second try
       DEBUG_PRINTLN("deserializeMap: trying to get fresh memory block.");
-      customMappingTable = (uint16_t*) calloc(size, sizeof(uint16_t));
+      customMappingTable = (pixel_index_t*) tieredCalloc(size, sizeof(pixel_index_t), LEDMAP_MEM_TIER, "ledmap");
       if (customMappingTable == nullptr) { 
         DEBUG_PRINTLN("deserializeMap: alloc failed!");
         errorFlag = ERR_LOW_MEM; // WLEDMM raise errorflag
@@ -2668,11 +3125,11 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 
     //WLEDMM: find the map values
     f.find("\"map\":[");
-    uint16_t i=0;
+    unsigned i=0;
     do { //for each element in the array
       int mapi = f.readStringUntil(',').toInt();
       // USER_PRINTF(", %d(%d)", mapi, i);
-      if (i < customMappingSize) customMappingTable[i++] = (uint16_t) (mapi<0 ? 0xFFFFU : mapi);  // WLEDMM do not write past array bounds
+      if (i < customMappingSize) customMappingTable[i++] = (pixel_index_t) (mapi<0 ? PIXEL_INDEX_NONE : mapi);  // WLEDMM do not write past array bounds
     } while (f.available());
 
     loadedLedmap = n;
@@ -2680,7 +3137,7 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 
     USER_PRINTF("Custom ledmap: %d size=%d\n", loadedLedmap, customMappingSize);
     #ifdef WLED_DEBUG_MAPS
-      for (uint16_t j=0; j<customMappingSize; j++) { // fixing a minor warning: declaration of 'i' shadows a previous local
+      for (unsigned j=0; j<customMappingSize; j++) { // fixing a minor warning: declaration of 'i' shadows a previous local
         if (!(j%Segment::maxWidth)) DEBUG_PRINTLN();
         DEBUG_PRINTF("%4d,", customMappingTable[j]);
       }
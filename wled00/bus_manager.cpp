@@ -39,6 +39,55 @@ void setBitArray(uint8_t* byteArray, size_t numBits, bool value) {  // set all b
   else memset(byteArray, 0x00, len);
 }
 
+// WLEDMM whole-buffer output pass (brightness and ABL in one go)
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(WLEDMM_NO_S3_PIE)
+extern "C" {
+  void s3_scale8_pattern(uint8_t* dst, const uint8_t* src, uint32_t numBlocks, const uint8_t* pattern); // s3_scale8_pattern.S
+}
+#endif
+
+void __attribute__((hot)) scaleBufferChannels(uint8_t* dst, const uint8_t* src, size_t numBytes, uint8_t factor) {
+  size_t i = 0;
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(WLEDMM_NO_S3_PIE)
+  static uint8_t pattern[SCALE_PATTERN_LEN] __attribute__((aligned(16)));
+  if (pattern[0] != factor) memset(pattern, factor, sizeof(pattern));
+  size_t numBlocks = numBytes / SCALE_PATTERN_LEN;
+  if (numBlocks > 0) s3_scale8_pattern(dst, src, numBlocks, pattern); // PIE SIMD: 16 bytes per instruction
+  i = numBlocks * SCALE_PATTERN_LEN;
+#else
+  // two channels per 32-bit multiply: 8-bit lanes are spread into 16-bit lanes, so products cannot carry into the neighbour
+  const uint32_t* s32 = reinterpret_cast<const uint32_t*>(src);
+  uint32_t* d32 = reinterpret_cast<uint32_t*>(dst);
+  for (size_t w = 0; w < numBytes / 4; w++) {
+    uint32_t v = s32[w];
+    uint32_t even = (((v & 0x00FF00FF) * factor) >> 8) & 0x00FF00FF;
+    uint32_t odd  = (((v >> 8) & 0x00FF00FF) * factor) & 0xFF00FF00;
+    d32[w] = even | odd;
+  }
+  i = numBytes & ~size_t(3);
+#endif
+  for (; i < numBytes; i++) dst[i] = (uint16_t(src[i]) * factor) >> 8; // remaining bytes
+}
+
+#ifdef WLED_ENABLE_DITHERING
+// WLEDMM temporal dithering: the exact 16-bit linear value (channel * brightness, 8.8 fixed point) plus the error
+// left over from the last frame is rounded to the nearest 8-bit output; the new signed error is kept for the next
+// frame. At low brightness a channel that would be truncated to "0" or "1" now toggles between neighbouring values,
+// so its average over a few frames matches the 16-bit value. With gamma correction on, buffers already hold linear
+// PWM duty values (gamma is applied before rendering), so no conversion is needed.
+// The error always stays within -128..127; no cross-pixel dependencies -> the loop streams like the plain pass.
+static inline uint8_t __attribute__((always_inline)) ditherChannel(uint8_t value, uint8_t factor, int16_t &err) {
+  int32_t target = int32_t(value) * factor + err;  // -128 .. 65152
+  int32_t out = (target + 128) >> 8;               // nearest, 0 .. 255
+  err = target - (out << 8);
+  return out;
+}
+
+void __attribute__((hot)) scaleBufferChannelsDither(uint8_t* dst, const uint8_t* src, int16_t* err, size_t numBytes, uint8_t factor) {
+  for (size_t i = 0; i < numBytes; i++) dst[i] = ditherChannel(src[i], factor, err[i]);
+}
+#endif
+
 //WLEDMM: #define DEBUGOUT(x) netDebugEnabled?NetDebug.print(x):Serial.print(x) not supported in this file as netDebugEnabled not in scope
 #if 0
 //colors.cpp
@@ -80,7 +129,7 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte
 #endif
 
 
-void ColorOrderMap::add(uint16_t start, uint16_t len, uint8_t colorOrder) {
+void ColorOrderMap::add(pixel_index_t start, uint16_t len, uint8_t colorOrder) {
   if (_count >= WLED_MAX_COLOR_ORDER_MAPPINGS) {
     return;
   }
@@ -96,7 +145,7 @@ void ColorOrderMap::add(uint16_t start, uint16_t len, uint8_t colorOrder) {
   _count++;
 }
 
-uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder) const {
+uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(pixel_index_t pix, uint8_t defaultColorOrder) const {
   if (_count == 0) return defaultColorOrder;
   // upper nibble contains W swap information
   uint8_t swapW = defaultColorOrder >> 4;
@@ -149,6 +198,14 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com) : Bu
   _busPtr = PolyBus::create(_iType, _pins, lenToCreate, nr, _frequencykHz);
   _valid = (_busPtr != nullptr);
   _colorOrder = bc.colorOrder;
+  #ifdef WLED_ENABLE_DITHERING
+  // WLEDMM dithering needs the undimmed colors: the driver then runs at full luminance, brightness is applied in show()
+  if (_valid && (bc.type != TYPE_WS2812_1CH_X3)) {
+    _ditherSrc = (uint32_t*) tieredCalloc(_len, sizeof(uint32_t) + 4 * sizeof(int16_t), WLED_MEM_HOT, "dither"); // dithering is optional - bus still works without it
+    if (_ditherSrc) _ditherErr = (int16_t*) (_ditherSrc + _len);
+    else USER_PRINTLN(F("Not enough memory for dithering."));
+  }
+  #endif
   if (_pins[1] != 255) {  // WLEDMM USER_PRINTF
     USER_PRINTF("%successfully inited strip %u (len %u) with type %u and pins %u,%u (itype %u)", _valid?"S":"Uns", nr, _len, bc.type, _pins[0],_pins[1],_iType);
     if (bc.frequency > 999) USER_PRINTF(", %d MHz", bc.frequency/1000);
@@ -158,7 +215,30 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com) : Bu
   }
 }
 
+// WLEDMM the whole-buffer output pass (scaleBufferChannels) is not used here: NeoPixelBusLg already applies
+// brightness while a pixel is written into the driver buffer, and that buffer is owned by the driver.
 void BusDigital::show() {
+  #ifdef WLED_ENABLE_DITHERING
+  if (_ditherSrc) {
+    #ifdef BUS_OUTPUT_TIMER
+    unsigned long timer = micros();
+    #endif
+    for (unsigned pix = _skip; pix < _len; pix++) {
+      uint32_t c = _ditherSrc[pix];
+      int16_t* err = _ditherErr + 4 * pix;
+      c = RGBW32(ditherChannel(R(c), _bri, err[0]), ditherChannel(G(c), _bri, err[1]), ditherChannel(B(c), _bri, err[2]), ditherChannel(W(c), _bri, err[3]));
+      PolyBus::setPixelColor(_busPtr, _iType, pix, c, _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder));
+    }
+    #ifdef BUS_OUTPUT_TIMER
+    _passTime += micros() - timer;
+    if (++_passFrames >= 500) {
+      USER_PRINTF("Bus dithering pass for %u pixels: %u micros/frame (avg of %u frames).\n", _len - _skip, unsigned(_passTime / _passFrames), _passFrames);
+      _passTime = 0;
+      _passFrames = 0;
+    }
+    #endif
+  }
+  #endif
   PolyBus::show(_busPtr, _iType);
 }
 
@@ -174,6 +254,9 @@ void BusDigital::setBrightness(uint8_t b, bool immediate) {
   }
   #endif
   Bus::setBrightness(b, immediate);
+  #ifdef WLED_ENABLE_DITHERING
+  if (_ditherSrc) b = 255; // WLEDMM brightness is applied in show()
+  #endif
   PolyBus::setBrightness(_busPtr, _iType, b, immediate);
 }
 
@@ -202,12 +285,18 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
       case 2: c = RGBW32(R(cOld), G(cOld), W(c)   , 0); break;
     }
   }
+  #ifdef WLED_ENABLE_DITHERING
+  if (_ditherSrc) { _ditherSrc[pix] = c; return; } // WLEDMM written to the driver in show()
+  #endif
   PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
 }
 
 uint32_t IRAM_ATTR_YN BusDigital::getPixelColor(uint16_t pix) const {
   if (reversed) pix = _len - pix -1;
   else pix += _skip;
+  #ifdef WLED_ENABLE_DITHERING
+  if (_ditherSrc) return color_fade(_ditherSrc[pix], _bri); // same as the driver would return: scaled by brightness
+  #endif
   uint8_t co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
   if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
     uint16_t pOld = pix;
@@ -223,6 +312,15 @@ uint32_t IRAM_ATTR_YN BusDigital::getPixelColor(uint16_t pix) const {
   return PolyBus::getPixelColor(_busPtr, _iType, pix, co);
 }
 
+#ifdef WLED_ENABLE_DITHERING
+uint32_t IRAM_ATTR_YN BusDigital::getPixelColorRestored(uint16_t pix) const {
+  if (!_ditherSrc) return Bus::getPixelColorRestored(pix);
+  if (reversed) pix = _len - pix -1;
+  else pix += _skip;
+  return _ditherSrc[pix];  // WLEDMM lossless
+}
+#endif
+
 uint8_t BusDigital::getPins(uint8_t* pinArray) const {
   uint8_t numPins = IS_2PIN(_type) ? 2 : 1;
   for (uint8_t i = 0; i < numPins; i++) pinArray[i] = _pins[i];
@@ -242,6 +340,11 @@ void BusDigital::reinit() {
 void BusDigital::cleanup() {
   DEBUG_PRINTLN(F("Digital Cleanup."));
   PolyBus::cleanup(_busPtr, _iType);
+  #ifdef WLED_ENABLE_DITHERING
+  if (_ditherSrc) free(_ditherSrc);
+  _ditherSrc = nullptr;
+  _ditherErr = nullptr;
+  #endif
   _iType = I_NONE;
   _valid = false;
   _busPtr = nullptr;
@@ -474,12 +577,25 @@ BusNetwork::BusNetwork(BusConfig &bc, const ColorOrderMap &com) : Bus(bc.type, b
       break;
   }
   _UDPchannels = _rgbw ? 4 : 3;
-  #ifdef ESP32
-  _data = (byte*) heap_caps_calloc_prefer((bc.count * _UDPchannels)+15, sizeof(byte), 3, MALLOC_CAP_DEFAULT, MALLOC_CAP_SPIRAM);
+  #if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(WLEDMM_NO_S3_PIE)
+  // WLEDMM PIE vector loads/stores need 16-byte aligned buffers
+  _data  = (byte*) tieredAlignedCalloc(16, (bc.count * _UDPchannels)+15, sizeof(byte), WLED_MEM_HOT, "network bus");
+  _frame = (byte*) tieredAlignedCalloc(16, (bc.count * _UDPchannels)+15, sizeof(byte), WLED_MEM_HOT, "network bus");
   #else
-  _data = (byte*) calloc((bc.count * _UDPchannels)+15, sizeof(byte));
+  _data  = (byte*) tieredCalloc((bc.count * _UDPchannels)+15, sizeof(byte), WLED_MEM_HOT, "network bus");
+  _frame = (byte*) tieredCalloc((bc.count * _UDPchannels)+15, sizeof(byte), WLED_MEM_HOT, "network bus");
+  #endif
+  if ((_data == nullptr) || (_frame == nullptr)) {
+    if (_data) free(_data);
+    if (_frame) free(_frame);
+    _data = _frame = nullptr;
+    USER_PRINTLN(F(" not enough memory]"));
+    return;
+  }
+  #ifdef WLED_ENABLE_DITHERING
+  _ditherErr = (int16_t*) tieredCalloc((bc.count * _UDPchannels)+15, sizeof(int16_t), WLED_MEM_HOT, "dither"); // dithering is optional - bus still works without it
+  if (_ditherErr == nullptr) USER_PRINT(F(" (no memory for dithering)"));
   #endif
-  if (_data == nullptr) return;
   _len = bc.count;
   _colorOrder = bc.colorOrder;
   _client = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
@@ -494,7 +610,7 @@ BusNetwork::BusNetwork(BusConfig &bc, const ColorOrderMap &com) : Bus(bc.type, b
 void IRAM_ATTR_YN BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
     if (pix >= _len) return;
     if (_rgbw) c = autoWhiteCalc(c);
-    if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); // color correction from CCT
+    if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); // color correction from CCT - per segment, so it cannot move into show()
 
     uint16_t offset = pix * _UDPchannels;
     uint8_t co = _colorOrderMap.getPixelColorOrder(pix + _start, _colorOrder);
@@ -551,7 +667,35 @@ uint32_t IRAM_ATTR_YN BusNetwork::getPixelColor(uint16_t pix) const {
 void BusNetwork::show() {
   if (!_valid || !canShow()) return;
   _broadcastLock = true;
-  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw, _artnet_outputs, _artnet_leds_per_output, _artnet_fps_limit);
+
+  // WLEDMM scale by brightness (already includes ABL). White balance is not part of the pass:
+  // it depends on the segment CCT, so it is applied per pixel in setPixelColor().
+  byte* outBuffer = _data;
+  if (_bri != 255) { // full brightness -> send _data as-is
+    #ifdef BUS_OUTPUT_TIMER
+    unsigned long timer = micros();
+    #endif
+    #ifdef WLED_ENABLE_DITHERING
+    if (_ditherErr) scaleBufferChannelsDither(_frame, _data, _ditherErr, _len * _UDPchannels, _bri);
+    else
+    #endif
+    scaleBufferChannels(_frame, _data, _len * _UDPchannels, _bri);
+    outBuffer = _frame;
+    #ifdef BUS_OUTPUT_TIMER
+    _passTime += micros() - timer;
+    if (++_passFrames >= 500) {
+      #ifdef WLED_ENABLE_DITHERING
+      const char* mode = _ditherErr ? " with dithering" : "";
+      #else
+      const char* mode = "";
+      #endif
+      USER_PRINTF("Bus output pass for %u pixels: %u micros/frame (avg of %u frames)%s.\n", _len, unsigned(_passTime / _passFrames), _passFrames, mode);
+      _passTime = 0;
+      _passFrames = 0;
+    }
+    #endif
+  }
+  realtimeBroadcast(_UDPtype, _client, _len, outBuffer, 255, _rgbw, _artnet_outputs, _artnet_leds_per_output, _artnet_fps_limit);
   _broadcastLock = false;
 }
 
@@ -566,7 +710,13 @@ void BusNetwork::cleanup() {
   _type = I_NONE;
   _valid = false;
   if (_data != nullptr) free(_data);
+  if (_frame != nullptr) free(_frame);
   _data = nullptr;
+  _frame = nullptr;
+  #ifdef WLED_ENABLE_DITHERING
+  if (_ditherErr != nullptr) free(_ditherErr);
+  _ditherErr = nullptr;
+  #endif
   _len = 0;
 }
 
@@ -980,18 +1130,10 @@ BusHub75Matrix::BusHub75Matrix(BusConfig &bc) : Bus(bc.type, bc.start, bc.autoWh
     if (_ledBuffer) free(_ledBuffer);                 // should not happen
     if (_ledsDirty) free(_ledsDirty);                 // should not happen
 
-    _ledsDirty = (byte*) malloc(getBitArrayBytes(_len));  // create LEDs dirty bits
+    _ledsDirty = (byte*) tieredMalloc(getBitArrayBytes(_len), WLED_MEM_HOT, "HUB75");  // create LEDs dirty bits
     if (_ledsDirty) setBitArray(_ledsDirty, _len, false); // reset dirty bits
 
-    #if defined(CONFIG_IDF_TARGET_ESP32S3) && CONFIG_SPIRAM_MODE_OCT && defined(BOARD_HAS_PSRAM) && (defined(WLED_USE_PSRAM) || defined(WLED_USE_PSRAM_JSON))
-      if (psramFound()) {
-        _ledBuffer = (CRGB*) ps_calloc(_len, sizeof(CRGB));  // create LEDs buffer (initialized to BLACK)
-      } else {
-        _ledBuffer = (CRGB*) calloc(_len, sizeof(CRGB));  // create LEDs buffer (initialized to BLACK)
-      }
-    #else
-      _ledBuffer = (CRGB*) calloc(_len, sizeof(CRGB));  // create LEDs buffer (initialized to BLACK)
-    #endif
+    _ledBuffer = (CRGB*) tieredCalloc(_len, sizeof(CRGB), WLED_MEM_HOT, "HUB75");  // create LEDs buffer (initialized to BLACK) - WLEDMM PSRAM only when internal RAM runs short
   }
 
   if ((_ledBuffer == nullptr) || (_ledsDirty == nullptr)) {
@@ -1245,6 +1387,7 @@ int BusManager::add(BusConfig &bc) {
   laststart = 0;
   lastBus = nullptr;
   slowMode = false;
+  generation++;
 
   DEBUG_PRINTF("BusManager::add(bc.type=%u)\n", bc.type);
   if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) {
@@ -1284,6 +1427,7 @@ void BusManager::removeAll() {
   laststart = 0;
   lastend = 0;
   slowMode = false;
+  generation++;
 }
 
 void __attribute__((hot)) BusManager::show() {
@@ -1303,7 +1447,7 @@ void BusManager::setStatusPixel(uint32_t c) {
   }
 }
 
-void IRAM_ATTR __attribute__((hot)) BusManager::setPixelColor(uint16_t pix, uint32_t c, int16_t cct) {
+void IRAM_ATTR __attribute__((hot)) BusManager::setPixelColor(pixel_index_t pix, uint32_t c, int16_t cct) {
   if (!slowMode && (pix >= laststart) && (pix < lastend ) && lastBus->isOk()) {
     // WLEDMM same bus as last time - no need to search again
     lastBus->setPixelColor(pix - laststart, c);
@@ -1313,7 +1457,7 @@ void IRAM_ATTR __attribute__((hot)) BusManager::setPixelColor(uint16_t pix, uint
   for (uint_fast8_t i = 0; i < numBusses; i++) {    // WLEDMM use fast native types
     Bus* b = busses[i];
     if (b->isOk() == false) continue;  // WLEDMM ignore invalid (=not ready) busses
-    uint_fast16_t bstart = b->getStart();
+    unsigned bstart = b->getStart();
     if (pix < bstart || pix >= bstart + b->getLength()) continue;
     else {
       if (!slowMode) {
@@ -1343,7 +1487,7 @@ void __attribute__((cold)) BusManager::setSegmentCCT(int16_t cct, bool allowWBCo
   Bus::setCCT(cct);
 }
 
-uint32_t IRAM_ATTR  __attribute__((hot)) BusManager::getPixelColor(uint_fast16_t pix) {     // WLEDMM use fast native types, IRAM_ATTR
+uint32_t IRAM_ATTR  __attribute__((hot)) BusManager::getPixelColor(pixel_index_t pix) {     // WLEDMM use fast native types, IRAM_ATTR
   if ((pix >= laststart) && (pix < lastend ) && (lastBus != nullptr) && lastBus->isOk()) {
     // WLEDMM same bus as last time - no need to search again
     return lastBus->getPixelColor(pix - laststart);
@@ -1352,7 +1496,7 @@ uint32_t IRAM_ATTR  __attribute__((hot)) BusManager::getPixelColor(uint_fast16_t
   for (uint_fast8_t i = 0; i < numBusses; i++) {
     Bus* b = busses[i];
     if (b->isOk() == false) continue;  // WLEDMM ignore invalid (=not ready) busses
-    uint_fast16_t bstart = b->getStart();
+    unsigned bstart = b->getStart();
     if (pix < bstart || pix >= bstart + b->getLength()) continue;
     else {
       if (!slowMode) {
@@ -1367,7 +1511,7 @@ uint32_t IRAM_ATTR  __attribute__((hot)) BusManager::getPixelColor(uint_fast16_t
   return 0;
 }
 
-uint32_t IRAM_ATTR  __attribute__((hot)) BusManager::getPixelColorRestored(uint_fast16_t pix) {     // WLEDMM uses bus::getPixelColorRestored()
+uint32_t IRAM_ATTR  __attribute__((hot)) BusManager::getPixelColorRestored(pixel_index_t pix) {     // WLEDMM uses bus::getPixelColorRestored()
   if ((pix >= laststart) && (pix < lastend ) && (lastBus != nullptr) && lastBus->isOk()) {
     // WLEDMM same bus as last time - no need to search again
     return lastBus->getPixelColorRestored(pix - laststart);
@@ -1376,7 +1520,7 @@ uint32_t IRAM_ATTR  __attribute__((hot)) BusManager::getPixelColorRestored(uint_
   for (uint_fast8_t i = 0; i < numBusses; i++) {
     Bus* b = busses[i];
     if (b->isOk() == false) continue;  // WLEDMM ignore invalid (=not ready) busses
-    uint_fast16_t bstart = b->getStart();
+    unsigned bstart = b->getStart();
     if (pix < bstart || pix >= bstart + b->getLength()) continue;
     else {
       if (!slowMode) {
@@ -1391,6 +1535,17 @@ uint32_t IRAM_ATTR  __attribute__((hot)) BusManager::getPixelColorRestored(uint_
   return 0;
 }
 
+void BusManager::getPixelColorsRestored(pixel_index_t pix, uint16_t count, uint32_t* out) const {
+  memset(out, 0, count * sizeof(uint32_t));
+  for (uint_fast8_t i = 0; i < numBusses; i++) {
+    Bus* b = busses[i];
+    if (b->isOk() == false) continue;
+    uint32_t bstart = b->getStart();
+    uint32_t from = max(uint32_t(pix), bstart), to = min(uint32_t(pix) + count, bstart + b->getLength());
+    for (uint32_t p = from; p < to; p++) out[p - pix] = b->getPixelColorRestored(p - bstart);
+  }
+}
+
 bool BusManager::canAllShow() const {
   for (uint8_t i = 0; i < numBusses; i++) {
     if (!busses[i]->canShow()) return false;
@@ -1403,9 +1558,22 @@ Bus* BusManager::getBus(uint8_t busNr) const {
   return busses[busNr];
 }
 
+bool BusManager::locatePixel(pixel_index_t pix, uint8_t &busNr, uint16_t &offset) const {
+  for (uint_fast8_t i = 0; i < numBusses; i++) {
+    const Bus* b = busses[i];
+    if (b->isOk() == false) continue;  // WLEDMM ignore invalid (=not ready) busses
+    unsigned bstart = b->getStart();
+    if (pix < bstart || pix >= bstart + b->getLength()) continue;
+    busNr = i;
+    offset = pix - bstart;
+    return true;
+  }
+  return false;
+}
+
 //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
-uint16_t BusManager::getTotalLength() const {
-  uint_fast16_t len = 0;
+pixel_index_t BusManager::getTotalLength() const {
+  unsigned len = 0;
   for (uint_fast8_t i=0; i<numBusses; i++) len += busses[i]->getLength();      // WLEDMM use fast native types
   return len;
 }
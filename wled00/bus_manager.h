@@ -32,6 +32,14 @@ bool getBitFromArray(const uint8_t* byteArray, size_t position)  __attribute__((
 size_t getBitArrayBytes(size_t num_bits) __attribute__((const)); // number of bytes needed for an array with num_bits bits
 void setBitArray(uint8_t* byteArray, size_t numBits, bool value);  // set all bits to same value
 
+// WLEDMM whole-buffer output pass: dst[i] = (src[i] * factor) >> 8, factor = brightness * ABL
+#define SCALE_PATTERN_LEN 48   // -S3 PIE kernel block size
+void scaleBufferChannels(uint8_t* dst, const uint8_t* src, size_t numBytes, uint8_t factor); // pointers must be 4-byte aligned (16 on -S3)
+#ifdef WLED_ENABLE_DITHERING
+// WLEDMM same as scaleBufferChannels(), but rounds the 16-bit result and carries the error in err[] into the next frame (temporal dithering)
+void scaleBufferChannelsDither(uint8_t* dst, const uint8_t* src, int16_t* err, size_t numBytes, uint8_t factor);
+#endif
+
 
 #define GET_BIT(var,bit)    (((var)>>(bit))&0x01)
 #define SET_BIT(var,bit)    ((var)|=(uint16_t)(0x0001<<(bit)))
@@ -48,7 +56,7 @@ void setBitArray(uint8_t* byteArray, size_t numBits, bool value);  // set all bi
 struct BusConfig {
   uint8_t type;
   uint16_t count;
-  uint16_t start;
+  pixel_index_t start;
   uint8_t colorOrder;
   bool reversed;
   uint8_t skipAmount;
@@ -59,7 +67,7 @@ struct BusConfig {
 
   uint8_t pins[5] = {LEDPIN, 255, 255, 255, 255}; // WLEDMM warning: this means that BusConfig cannot handle nore than 5 pins per bus!
   uint16_t frequency;
-  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, uint8_t art_o=1, uint16_t art_l=1, uint8_t art_f=30) {
+  BusConfig(uint8_t busType, uint8_t* ppins, pixel_index_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, uint8_t art_o=1, uint16_t art_l=1, uint8_t art_f=30) {
     refreshReq = (bool) GET_BIT(busType,7);
     type = busType & 0x7F;  // bit 7 may be/is hacked to include refresh info (1=refresh in off state, 0=no refresh)
     count = len; start = pstart; colorOrder = pcolorOrder; reversed = rev; skipAmount = skip; autoWhite = aw; frequency = clock_kHz;
@@ -87,13 +95,13 @@ struct BusConfig {
 
 // Defines an LED Strip and its color ordering.
 struct ColorOrderMapEntry {
-  uint16_t start;
+  pixel_index_t start;
   uint16_t len;
   uint8_t colorOrder;
 };
 
 struct ColorOrderMap {
-    void add(uint16_t start, uint16_t len, uint8_t colorOrder);
+    void add(pixel_index_t start, uint16_t len, uint8_t colorOrder);
 
     uint8_t count() const {
       return _count;
@@ -111,7 +119,7 @@ struct ColorOrderMap {
       return &(_mappings[n]);
     }
 
-    uint8_t getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder) const;
+    uint8_t getPixelColorOrder(pixel_index_t pix, uint8_t defaultColorOrder) const;
 
   private:
     uint8_t _count;
@@ -121,7 +129,7 @@ struct ColorOrderMap {
 //parent class of BusDigital, BusPwm, and BusNetwork
 class Bus {
   public:
-    Bus(uint8_t type, uint16_t start, uint8_t aw)
+    Bus(uint8_t type, pixel_index_t start, uint8_t aw)
     : _bri(255)
     , _len(1)
     , _valid(false)
@@ -151,8 +159,8 @@ class Bus {
     virtual uint8_t  get_artnet_fps_limit() const { return 0; }
     virtual uint8_t  get_artnet_outputs() const { return 0; }
     virtual uint16_t get_artnet_leds_per_output() const { return 0; }
-    inline  uint16_t getStart() const { return _start; }
-    inline  void     setStart(uint16_t start) { _start = start; }
+    inline  pixel_index_t getStart() const { return _start; }
+    inline  void     setStart(pixel_index_t start) { _start = start; }
     inline  uint8_t  getType() const { return _type; }
     inline  bool     isOk() const { return _valid; }
     inline  bool     isOffRefreshRequired() const { return _needsRefresh; }
@@ -207,7 +215,7 @@ class Bus {
   protected:
     uint8_t  _type;
     uint8_t  _bri;
-    uint16_t _start;
+    pixel_index_t _start;
     uint16_t _len;
     bool     _valid;
     bool     _needsRefresh;
@@ -235,6 +243,9 @@ class BusDigital : public Bus {
     void setPixelColor(uint16_t pix, uint32_t c);
 
     uint32_t getPixelColor(uint16_t pix) const override;
+    #ifdef WLED_ENABLE_DITHERING
+    uint32_t getPixelColorRestored(uint16_t pix) const override;
+    #endif
 
     uint8_t getColorOrder() const {
       return _colorOrder;
@@ -270,6 +281,14 @@ class BusDigital : public Bus {
     uint16_t _frequencykHz = 0U;
     void * _busPtr = nullptr;
     const ColorOrderMap &_colorOrderMap;
+    #ifdef WLED_ENABLE_DITHERING
+    uint32_t *_ditherSrc = nullptr;  // WLEDMM undimmed colors, by driver pixel index
+    int16_t  *_ditherErr = nullptr;  // WLEDMM 4 channels per pixel, same allocation as _ditherSrc
+    #endif
+    #ifdef BUS_OUTPUT_TIMER
+    uint32_t _passTime = 0;          // WLEDMM accumulated dithering pass time (micros)
+    uint16_t _passFrames = 0;
+    #endif
 };
 
 
@@ -392,6 +411,14 @@ class BusNetwork : public Bus {
     bool                _rgbw;
     bool                _broadcastLock;
     byte                *_data;
+    byte                *_frame = nullptr;  // WLEDMM output buffer, holds _data scaled by brightness/ABL
+    #ifdef WLED_ENABLE_DITHERING
+    int16_t             *_ditherErr = nullptr; // WLEDMM per-channel error (8.8 fixed point) carried into the next frame
+    #endif
+    #ifdef BUS_OUTPUT_TIMER
+    uint32_t            _passTime = 0;      // WLEDMM accumulated output pass time (micros)
+    uint16_t            _passFrames = 0;
+    #endif
     uint8_t             _colorOrder = COL_ORDER_RGB;
     uint8_t             _artnet_fps_limit;
     uint8_t             _artnet_outputs;
@@ -469,21 +496,39 @@ class BusManager {
 
     void setStatusPixel(uint32_t c);
 
-    void setPixelColor(uint16_t pix, uint32_t c, int16_t cct=-1);
+    void setPixelColor(pixel_index_t pix, uint32_t c, int16_t cct=-1);
 
     void setBrightness(uint8_t b, bool immediate=false);          // immediate=true is for use in ABL, it applies brightness immediately (warning: inefficient)
 
     void setSegmentCCT(int16_t cct, bool allowWBCorrection = false);
 
-    uint32_t __attribute__((pure)) getPixelColor(uint_fast16_t pix); // WLEDMM attribute added
-    uint32_t __attribute__((pure)) getPixelColorRestored(uint_fast16_t pix);  // WLEDMM
+    uint32_t __attribute__((pure)) getPixelColor(pixel_index_t pix); // WLEDMM attribute added
+    uint32_t __attribute__((pure)) getPixelColorRestored(pixel_index_t pix);  // WLEDMM
+    void getPixelColorsRestored(pixel_index_t pix, uint16_t count, uint32_t* out) const; // WLEDMM count pixels from pix on, 0 where there is no bus
 
     bool canAllShow() const;
 
     Bus* getBus(uint8_t busNr) const;
 
+    // WLEDMM resolve a strip position to (bus number, position inside the bus) - same rules as setPixelColor()
+    bool locatePixel(pixel_index_t pix, uint8_t &busNr, uint16_t &offset) const;
+    inline uint8_t getGeneration() const { return generation; } // changes whenever busses are added or removed
+    inline bool isSlowMode() const { return slowMode; }
+
+    // WLEDMM write through the fused pixel map of WS2812FX - entries are (bus number << 16) | position inside the bus.
+    // Returns false when the map cannot be used (not built, built for other busses, slow mode), then the caller takes the normal path.
+    inline bool setPixelColorFused(const uint32_t* map, unsigned mapSize, uint8_t mapGen, unsigned pix, uint32_t c) {
+      if (!map || (pix >= mapSize) || (mapGen != generation) || slowMode) return false;
+      uint32_t entry = map[pix];
+      if (entry != FUSED_PIXEL_NONE) {
+        Bus* b = busses[entry >> 16];
+        if (b->isOk()) b->setPixelColor(entry & 0xFFFF, c);
+      }
+      return true;
+    }
+
     //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
-    uint16_t getTotalLength() const;
+    pixel_index_t getTotalLength() const;
 
     inline void updateColorOrderMap(const ColorOrderMap &com) {
       memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap));
@@ -503,9 +548,10 @@ class BusManager {
     ColorOrderMap colorOrderMap;
     // WLEDMM cache last used Bus -> 20% to 30% speedup when using many LED pins
     Bus *lastBus = nullptr;
-    unsigned laststart = 0;
-    unsigned lastend = 0;
+    pixel_index_t laststart = 0;
+    unsigned      lastend = 0;     // one past the end - may be 65536 with 16bit indices
     bool slowMode = false; // WLEDMM not sure why we need this. But its necessary.
+    uint8_t generation = 0; // WLEDMM lets the fused pixel map detect stale bus numbers
 
     inline uint8_t getNumVirtualBusses() const {
       int j = 0;
@@ -186,7 +186,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       uint16_t length = elm["len"] | 1;
       uint8_t colorOrder = (int)elm[F("order")]; // contains white channel swap option in upper nibble
       uint8_t skipFirst = elm[F("skip")];
-      uint16_t start = elm["start"] | 0;
+      pixel_index_t start = elm["start"] | 0;
       if (length==0 || start + length > MAX_LEDS) continue; // zero length or we reached max. number of LEDs, just stop
       uint8_t ledType = elm["type"] | TYPE_WS2812_RGB;
       bool reversed = elm["rev"];
@@ -419,6 +419,17 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_sync = interfaces["sync"];
   CJSON(udpPort, if_sync[F("port0")]); // 21324
   CJSON(udpPort2, if_sync[F("port1")]); // 65506
+#ifdef WLED_ENABLE_FRAMESYNC
+  CJSON(frameSyncMode, if_sync[F("fsm")]);
+  CJSON(frameSyncPort, if_sync[F("fsport")]); // 21330
+  if (frameSyncMode > FRAMESYNC_FOLLOWER) frameSyncMode = FRAMESYNC_OFF;
+#endif
+#ifdef WLED_ENABLE_ESPNOW_SYNC
+  CJSON(espNowSyncMode, if_sync[F("espnow")]);
+#endif
+#ifdef WLED_ENABLE_SEQUENCER
+  CJSON(seqPort, if_sync[F("seqport")]); // 21331
+#endif
 
   JsonObject if_sync_recv = if_sync["recv"];
   CJSON(receiveNotificationBrightness, if_sync_recv["bri"]);
@@ -441,6 +452,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(syncGroups, if_sync_send["grp"]);
   if (if_sync_send[F("twice")]) udpNumRetries = 1; // import setting from 0.13 and earlier
   CJSON(udpNumRetries, if_sync_send["ret"]);
+  CJSON(syncDelta, if_sync_send[F("delta")]);
 
   JsonObject if_nodes = interfaces["nodes"];
   CJSON(nodeListEnabled, if_nodes[F("list")]);
@@ -462,6 +474,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   if (DMXSegmentSpacing > 150) DMXSegmentSpacing = 0;
   CJSON(e131Priority, if_live_dmx[F("e131prio")]);
   if (e131Priority > 200) e131Priority = 200;
+  CJSON(e131MergeMode, if_live_dmx[F("merge")]);
+  if (e131MergeMode > DMX_MERGE_LTP) e131MergeMode = DMX_MERGE_OFF;
   CJSON(DMXMode, if_live_dmx["mode"]);
 
   tdd = if_live[F("timeout")] | -1;
@@ -926,6 +940,16 @@ void serializeConfig() {
   JsonObject if_sync = interfaces.createNestedObject("sync");
   if_sync[F("port0")] = udpPort;
   if_sync[F("port1")] = udpPort2;
+#ifdef WLED_ENABLE_FRAMESYNC
+  if_sync[F("fsm")] = frameSyncMode;
+  if_sync[F("fsport")] = frameSyncPort;
+#endif
+#ifdef WLED_ENABLE_ESPNOW_SYNC
+  if_sync[F("espnow")] = espNowSyncMode;
+#endif
+#ifdef WLED_ENABLE_SEQUENCER
+  if_sync[F("seqport")] = seqPort;
+#endif
 
   JsonObject if_sync_recv = if_sync.createNestedObject("recv");
   if_sync_recv["bri"] = receiveNotificationBrightness;
@@ -943,6 +967,7 @@ void serializeConfig() {
   if_sync_send["macro"] = notifyMacro;
   if_sync_send["grp"] = syncGroups;
   if_sync_send["ret"] = udpNumRetries;
+  if_sync_send[F("delta")] = syncDelta;
 
   JsonObject if_nodes = interfaces.createNestedObject("nodes");
   if_nodes[F("list")] = nodeListEnabled;
@@ -958,6 +983,7 @@ void serializeConfig() {
   if_live_dmx[F("uni")] = e131Universe;
   if_live_dmx[F("seqskip")] = e131SkipOutOfSequence;
   if_live_dmx[F("e131prio")] = e131Priority;
+  if_live_dmx[F("merge")] = e131MergeMode;
   if_live_dmx[F("addr")] = DMXAddress;
   if_live_dmx[F("dss")] = DMXSegmentSpacing;
   if_live_dmx["mode"] = DMXMode;
@@ -109,8 +109,37 @@ IRAM_ATTR_YN __attribute__((hot)) uint32_t color_fade(uint32_t c1, uint8_t amoun
     return scaledcolor;
   }
 }
+
 #endif
 
+/*
+ * WLEDMM blend one layer pixel over the pixels below it (see segmentBlend_t in FX.h).
+ * "layer" arrives already scaled by opacity, so most modes can work on it directly:
+ * normal = below * (1-opacity) + layer; multiply = mix(below, below*layer, opacity) = below * (1 - opacity + layer)
+ */
+IRAM_ATTR_YN __attribute__((hot)) uint32_t color_composite(uint32_t below, uint32_t layer, uint8_t mode, uint8_t opacity)
+{
+  if (mode == SEG_BLEND_LUMA) {
+    unsigned alpha = (54 * R(layer) + 183 * G(layer) + 19 * B(layer)) >> 8;  // Rec.709 luma
+    return color_blend(below, layer, alpha);
+  }
+  uint32_t result = 0;
+  for (unsigned shift = 0; shift < 32; shift += 8) {
+    unsigned d = (below >> shift) & 0xFF;
+    unsigned c = (layer >> shift) & 0xFF;
+    unsigned r;
+    switch (mode) {
+      case SEG_BLEND_ADD:      r = d + c; break;
+      case SEG_BLEND_MULTIPLY: r = (d * (255 - opacity + c)) / 255; break;
+      case SEG_BLEND_MAX:      r = (d > c) ? d : c; break;
+      case SEG_BLEND_SCREEN:   r = d + c - (d * c) / 255; break;
+      default:                 r = (d * (255 - opacity)) / 255 + c; break; // SEG_BLEND_NORMAL
+    }
+    result |= ((r > 255) ? 255 : r) << shift;
+  }
+  return result;
+}
+
 void setRandomColor(byte* rgb)
 {
   lastRandomIndex = strip.getMainSegment().get_random_wheel_index(lastRandomIndex);
@@ -325,6 +354,80 @@ uint32_t __attribute__((hot)) IRAM_ATTR_YN colorBalanceFromKelvin(uint16_t kelvi
   return RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]);
 }
 
+#ifdef WLEDMM_COLOR_8DOT8
+/*
+ * WLEDMM 16bit per channel (8.8 fixed point) versions of color_blend, color_add and color_fade.
+ * Used by segment fade / blend functions, so that long fade and blend chains don't accumulate 8bit rounding errors.
+ */
+uint64_t IRAM_ATTR_YN __attribute__((hot)) color_blend16(uint64_t color1, uint64_t color2, uint16_t blend) {
+  if ((color1 == color2) || (blend == 0)) return color1;
+  if (blend == 0xFFFF) return color2;
+  const uint32_t blend2 = 0xFFFF - blend;
+  uint32_t w3 = (uint32_t(W16(color2)) * blend + uint32_t(W16(color1)) * blend2 + 0x7FFF) >> 16; // 16x16 -> 32bit, no overflow
+  uint32_t r3 = (uint32_t(R16(color2)) * blend + uint32_t(R16(color1)) * blend2 + 0x7FFF) >> 16;
+  uint32_t g3 = (uint32_t(G16(color2)) * blend + uint32_t(G16(color1)) * blend2 + 0x7FFF) >> 16;
+  uint32_t b3 = (uint32_t(B16(color2)) * blend + uint32_t(B16(color1)) * blend2 + 0x7FFF) >> 16;
+  return RGBW64(r3, g3, b3, w3);
+}
+
+uint64_t IRAM_ATTR_YN __attribute__((hot)) color_add16(uint64_t c1, uint64_t c2) {
+  if (c2 == 0) return c1;
+  if (c1 == 0) return c2;
+  uint32_t r = R16(c1) + R16(c2);
+  uint32_t g = G16(c1) + G16(c2);
+  uint32_t b = B16(c1) + B16(c2);
+  uint32_t w = W16(c1) + W16(c2);
+  uint32_t max = r;
+  if (g > max) max = g;
+  if (b > max) max = b;
+  if (w > max) max = w;
+  if (max < 65536) return RGBW64(r, g, b, w);
+  else             return RGBW64(uint64_t(r) * 65535 / max, uint64_t(g) * 65535 / max, uint64_t(b) * 65535 / max, uint64_t(w) * 65535 / max);
+}
+
+uint64_t IRAM_ATTR_YN __attribute__((hot)) color_fade16(uint64_t c1, uint16_t amount) {
+  if (amount == 0xFFFF) return c1;
+  if (amount == 0) return 0;
+  uint32_t scale = uint32_t(amount) + 1;
+  return RGBW64((R16(c1) * scale) >> 16, (G16(c1) * scale) >> 16, (B16(c1) * scale) >> 16, (W16(c1) * scale) >> 16);
+}
+
+#ifdef WLEDMM_COLOR_BENCHMARK
+// WLEDMM compare throughput of the 8bit and 16bit kernels - prints results to the serial console
+void benchmarkColorKernels(void) {
+  const unsigned loops = 20000;
+  volatile uint32_t sink8 = 0;   // volatile - prevent the compiler from optimizing away the loops
+  volatile uint64_t sink16 = 0;
+  uint32_t c8 = 0x00A05010;
+  uint64_t c16 = COLOR8TO16(c8);
+
+  unsigned long t0 = micros();
+  for (unsigned i = 0; i < loops; i++) { c8 = color_fade(c8 | 0x00808080, 250); sink8 = c8; }
+  unsigned long tFade8 = micros() - t0;
+  t0 = micros();
+  for (unsigned i = 0; i < loops; i++) { c16 = color_fade16(c16 | 0x0000800080008000ULL, 64250); sink16 = c16; }
+  unsigned long tFade16 = micros() - t0;
+
+  t0 = micros();
+  for (unsigned i = 0; i < loops; i++) { c8 = color_blend(c8, 0x00102030 + i, i & 0xFF); sink8 = c8; }
+  unsigned long tBlend8 = micros() - t0;
+  t0 = micros();
+  for (unsigned i = 0; i < loops; i++) { c16 = color_blend16(c16, 0x0000100020003000ULL + i, i & 0xFFFF); sink16 = c16; }
+  unsigned long tBlend16 = micros() - t0;
+
+  t0 = micros();
+  for (unsigned i = 0; i < loops; i++) { c8 = color_add(c8 & 0x007F7F7F, 0x00102030 + i); sink8 = c8; }
+  unsigned long tAdd8 = micros() - t0;
+  t0 = micros();
+  for (unsigned i = 0; i < loops; i++) { c16 = color_add16(c16 & 0x00007FFF7FFF7FFFULL, 0x0000100020003000ULL + i); sink16 = c16; }
+  unsigned long tAdd16 = micros() - t0;
+
+  (void)sink8; (void)sink16;
+  USER_PRINTF("Color kernels (%u calls, micros) 8bit/16bit: fade %lu/%lu, blend %lu/%lu, add %lu/%lu\n", loops, tFade8, tFade16, tBlend8, tBlend16, tAdd8, tAdd16);
+}
+#endif
+#endif
+
 //approximates a Kelvin color temperature from an RGB color.
 //this does no check for the "whiteness" of the color,
 //so should be used combined with a saturation check (as done by auto-white)
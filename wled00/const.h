@@ -185,6 +185,8 @@
 #define REALTIME_MODE_TPM2NET     7
 #define REALTIME_MODE_DDP         8
 #define REALTIME_MODE_DMX         9
+#define REALTIME_MODE_ESPNOW      10           //WLEDMM pixels received via ESP-NOW (WLED_ENABLE_ESPNOW_SYNC)
+#define REALTIME_MODE_FSEQ        11           //WLEDMM .fseq file playback (WLED_ENABLE_FSEQ)
 
 //realtime override modes
 #define REALTIME_OVERRIDE_NONE    0
@@ -204,6 +206,26 @@
 #define DMX_MODE_EFFECT_SEGMENT_W 9            //trigger standalone effects of WLED (18 channels per segment)
 #define DMX_MODE_PRESET           10           //apply presets (1 channel)
 
+//E1.31/Art-Net merge modes for several senders on the same universe
+#define DMX_MERGE_OFF             0            //last packet wins
+#define DMX_MERGE_HTP             1            //highest value per channel wins
+#define DMX_MERGE_LTP             2            //latest change per channel wins
+
+//Frame sync modes (WLED_ENABLE_FRAMESYNC)
+#define FRAMESYNC_OFF             0
+#define FRAMESYNC_MASTER          1            //broadcast frame grid and answer delay requests
+#define FRAMESYNC_FOLLOWER        2            //lock clock and frames to the master
+
+//Show sequencer time sources (WLED_ENABLE_SEQUENCER)
+#define SEQ_SRC_INTERNAL          0            //local clock, started by "run"
+#define SEQ_SRC_NTP               1            //wall clock, relative to an agreed start time
+#define SEQ_SRC_EXTERNAL          2            //position from a player (timecode over UDP or JSON)
+
+//ESP-NOW sync (WLED_ENABLE_ESPNOW_SYNC), bit mapped
+#define ESPNOW_SYNC_NOTIFY        0x01         //send and receive sync notifications via ESP-NOW
+#define ESPNOW_SYNC_PIXELS_OUT    0x02         //stream own pixels
+#define ESPNOW_SYNC_PIXELS_IN     0x04         //accept pixel streams as realtime data
+
 //Light capability byte (unused) 0bRCCCTTTT
 //bits 0/1/2/3: specifies a type of LED driver. A single "driver" may have different chip models but must have the same protocol/behavior
 //bits 4/5/6: specifies the class of LED driver - 0b000 (dec. 0-15)  unconfigured/reserved
@@ -425,7 +447,37 @@
   #else
     #define MAX_LEDS_PER_BUS 2048     // may not be enough for fast LEDs (i.e. APA102)
   #endif
-#endif  
+#endif
+#endif
+
+// WLEDMM index type for strip pixels (ledmap table, bus start, BusManager lookup, segment start/stop and 1D length).
+// The compact 16bit table is the default - it needs half the RAM for ledmaps, and the pixel path is a bit faster
+// (host model: 5.3 vs 6.1 ns per pixel with ledmap); -D WLEDMM_PIXEL_INDEX_32 lifts the 65534 LEDs limit.
+// Pixel positions inside one bus, 2D coordinates, SEGLEN for effects and the JSON/UDP sync formats stay 16bit.
+#ifdef WLEDMM_PIXEL_INDEX_32
+  typedef uint32_t pixel_index_t;
+  #define PIXEL_INDEX_NONE 0xFFFFFFFFU  // ledmap entry "no pixel"
+#else
+  typedef uint16_t pixel_index_t;
+  #define PIXEL_INDEX_NONE 0xFFFFU
+  #if MAX_LEDS > 65534
+    #error MAX_LEDS does not fit into 16bit pixel indices - please add -D WLEDMM_PIXEL_INDEX_32
+  #endif
+#endif
+#define FUSED_PIXEL_NONE 0xFFFFFFFFU  // WLEDMM fused map entry for pixels without LED (ledmap gap, no bus)
+#if MAX_LEDS_PER_BUS > 65535
+  #error MAX_LEDS_PER_BUS is limited to 65535 - please set it explicitly when using large MAX_LEDS
+#endif
+
+// WLEDMM memory placement tiers for large allocations (see tieredMalloc() in util.cpp). Only boards with PSRAM have a choice.
+#define WLED_MEM_HOT  0   // touched for every pixel of every frame (render buffers) - internal RAM, PSRAM only when internal RAM runs out
+#define WLED_MEM_WARM 1   // touched often, but not per pixel - internal RAM while there is plenty of it
+#define WLED_MEM_COLD 2   // config, caches, rarely touched state - PSRAM
+#ifndef WLED_MEM_HOT_RESERVE
+  #define WLED_MEM_HOT_RESERVE  16384  // internal RAM left free for WiFi and networking before hot buffers go to PSRAM
+#endif
+#ifndef WLED_MEM_WARM_RESERVE
+  #define WLED_MEM_WARM_RESERVE 49152  // same for warm buffers - they give up internal RAM earlier
 #endif
 
 // string temp buffer (now stored in stack locally) // WLEDMM ...which is actually not the greatest design choice on ESP32
@@ -495,6 +547,23 @@
   #define JSON_BUFFER_SIZE 24576
  #endif
 #endif
+
+// WLEDMM additional JSON documents for read-only requests (/json, WS state push), so they don't wait for the global "doc"
+#if !defined(WLED_JSON_POOL_SIZE)
+#if defined(ESP8266)
+  #define WLED_JSON_POOL_SIZE 0  // not enough RAM - always use "doc"
+#elif defined(BOARD_HAS_PSRAM) && (defined(WLED_USE_PSRAM) || defined(WLED_USE_PSRAM_JSON))
+  #define WLED_JSON_POOL_SIZE 2  // allocated in PSRAM on first use, kept
+#else
+  #define WLED_JSON_POOL_SIZE 1  // allocated on demand when heap allows, freed after use
+#endif
+#endif
+#if !defined(ARDUINO_ARCH_ESP32) && (WLED_JSON_POOL_SIZE > 0)
+  #warning WLED_JSON_POOL_SIZE is only supported on ESP32 - using the global "doc" only
+  #undef WLED_JSON_POOL_SIZE
+  #define WLED_JSON_POOL_SIZE 0
+#endif
+#define JSON_LOCK_MODULES 32     // size of per-module lock statistics (module ids used by requestJSONBufferLock)
 #endif
 
 //#define MIN_HEAP_SIZE (8k for AsyncWebServer)
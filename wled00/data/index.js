@@ -804,6 +804,17 @@ function populateSegments(s)
 							`<option value="1" ${inst.si==1?' selected':''}>WeWillRockYou</option>`+
 						`</select></div>`+
 					`</div>`;
+		// WLEDMM layer blend mode (only with compositor builds)
+		let blendSel = (inst.bm === undefined) ? "" : `<div class="lbl-s">Blend mode<br>`+
+						`<div class="sel-p"><select class="sel-p" id="seg${i}bm" onchange="setBm(${i})">`+
+							`<option value="0" ${inst.bm==0?' selected':''}>Normal</option>`+
+							`<option value="2" ${inst.bm==2?' selected':''}>Add</option>`+
+							`<option value="6" ${inst.bm==6?' selected':''}>Multiply</option>`+
+							`<option value="10" ${inst.bm==10?' selected':''}>Screen</option>`+
+							`<option value="8" ${inst.bm==8?' selected':''}>Lighten (max)</option>`+
+							`<option value="16" ${inst.bm==16?' selected':''}>Alpha by luma ☾</option>`+
+						`</select></div>`+
+					`</div>`;
 		//WLEDMM ARTIFX
 		let fxName = eJson.find((o)=>{return o.id==selectedFx}).name;
 		let cusEff = `<button class="btn" onclick="toggleCEEditor('${inst.n?inst.n:"default"}', ${i})">ARTI-FX Editor ☾</button><br>`;
@@ -858,6 +869,7 @@ function populateSegments(s)
 					(!isMSeg ? rvXck : '') +
 					(isMSeg&&stoY-staY>1&&stoX-staX>1 ? map2D : '') +
 					(s.AudioReactive && s.AudioReactive.on ? "" : sndSim) +
+					blendSel +
 					(s.ARTIFX && s.ARTIFX.on && fxName.includes("ARTI-FX") ? cusEff : "") + // <!--WLEDMM-->
 					`<label class="check revchkl" id="seg${i}lbtm">`+
 						(isMSeg?'Transpose':'Mirror effect') + (isMSeg ?
@@ -2311,7 +2323,7 @@ function toggleLiveview()
 	}
 
 	gId('buttonSr').className = (isLv) ? "active":"";
-	if (ws && ws.readyState === WebSocket.OPEN) ws.send(`{"lv":${isLv}}`);
+	if (ws && ws.readyState === WebSocket.OPEN) ws.send(`{"lv":${isLv},"lvc":true}`); //WLEDMM compressed stream (decoded in peek.js)
 }
 
 //WLEDMM create and delete iFrame for peek (isLv is true if create)
@@ -2817,6 +2829,13 @@ function setM12(s)
 	requestJson(obj);
 }
 
+function setBm(s)
+{
+	var value = parseInt(gId(`seg${s}bm`).value);
+	var obj = {"seg": {"id": s, "bm": value}};
+	requestJson(obj);
+}
+
 function setSi(s)
 {
 	var value = gId(`seg${s}si`).selectedIndex;
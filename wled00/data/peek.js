@@ -8,39 +8,56 @@ function peek(c) {
 			ws = top.window.ws;
 		} catch (e) {}
 		if (ws && ws.readyState === WebSocket.OPEN) {
-			ws.send("{'lv':true}");
+			ws.send('{"lv":true,"lvc":true}'); //WLEDMM compressed stream
 		} else {
 			ws = new WebSocket((window.location.protocol == "https:"?"wss":"ws")+"://"+document.location.host+"/ws");
 			ws.onopen = ()=>{
-				ws.send("{'lv':true}");
+				ws.send('{"lv":true,"lvc":true}');
 			}
 		}
 		ws.binaryType = "arraybuffer";
+		var frame = null; //WLEDMM compressed stream: RGB of the frame being assembled
+		function colorAmp(color) {
+			if (color == 0) return 0;
+			return 25+225*color/255;
+		} //WLEDMM in range 55 - 205
+		function draw(leds, i, mW, mH) {
+			let pPL = Math.min(c.width / mW, c.height / mH); // pixels per LED (width of circle)
+			let lOf = Math.floor((c.width - pPL*mW)/2); //left offset (to center matrix)
+			ctx.clearRect(0, 0, c.width, c.height); //WLEDMM
+			for (y=0.5;y<mH;y++) for (x=0.5; x<mW; x++) {
+				if (leds[i]!= 0 || leds[i+1]!= 0 || leds[i+2]!= 0) { //WLEDMM: do not show blacks
+					ctx.fillStyle = `rgb(${colorAmp(leds[i])},${colorAmp(leds[i+1])},${colorAmp(leds[i+2])})`;
+					ctx.beginPath();
+					ctx.arc(x*pPL+lOf, y*pPL, pPL*0.4, 0, 2 * Math.PI);
+					ctx.fill();
+				}
+				i+=3;
+			}
+		}
 		ws.addEventListener('message',(e)=>{
 			// function processWSData(e) {
 			try {
 				if (toString.call(e.data) === '[object ArrayBuffer]') {
 					let leds = new Uint8Array(e.data);
-					if (leds[0] != 76 || leds[1] != 2 || !ctx) return; //'L', set in ws.cpp
-					let mW = leds[2]; // matrix width
-					let mH = leds[3]; // matrix height
-					let pPL = Math.min(c.width / mW, c.height / mH); // pixels per LED (width of circle)
-					let lOf = Math.floor((c.width - pPL*mW)/2); //left offset (to center matrix)
-					var i = 4; //same offset as in ws.cpp
-					ctx.clearRect(0, 0, c.width, c.height); //WLEDMM
-					function colorAmp(color) {
-						if (color == 0) return 0;
-						return 25+225*color/255;
-					} //WLEDMM in range 55 - 205
-					for (y=0.5;y<mH;y++) for (x=0.5; x<mW; x++) {
-						if (leds[i]!= 0 || leds[i+1]!= 0 || leds[i+2]!= 0) { //WLEDMM: do not show blacks
-							ctx.fillStyle = `rgb(${colorAmp(leds[i])},${colorAmp(leds[i+1])},${colorAmp(leds[i+2])})`;
-							ctx.beginPath();
-							ctx.arc(x*pPL+lOf, y*pPL, pPL*0.4, 0, 2 * Math.PI);
-							ctx.fill();
-						}
-						i+=3;
+					if (leds[0] != 76 || !ctx) return; //'L', set in ws.cpp
+					if (leds[1] == 2) draw(leds, 4, leds[2], leds[3]); // uncompressed: width, height, RGB
+					if (leds[1] != 3) return;
+					// WLEDMM RGB565 + RLE chunk (live_stream.cpp): 12 byte header, then run / copy records
+					let mW = leds[4] | leds[5]<<8, mH = leds[6] | leds[7]<<8;
+					let p = leds[8] | leds[9]<<8 | leds[10]<<16 | leds[11]<<24;
+					if (!frame || frame.length != mW*mH*3) frame = new Uint8Array(mW*mH*3);
+					function put(c) {
+						if (p >= mW*mH) return;
+						frame[3*p] = (c >> 8) & 0xF8; frame[3*p+1] = (c >> 3) & 0xFC; frame[3*p+2] = (c << 3) & 0xF8;
+						p++;
+					}
+					for (let i = 12; i < leds.length;) {
+						let r = leds[i++];
+						if (r < 128) { let c = leds[i] | leds[i+1]<<8; i += 2; for (let k = 0; k <= r; k++) put(c); }
+						else for (let k = 0; k <= (r & 0x7F); k++, i += 2) put(leds[i] | leds[i+1]<<8);
 					}
+					if (leds[3] & 1) draw(frame, 0, mW, mH); // last chunk of the frame
 				}
 			} catch (err) {
 				console.error("Peek WS error:",err);
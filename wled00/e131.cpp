@@ -31,7 +31,7 @@ void handleDDPPacket(e131_packet_t* p) {
 
   uint32_t start =  htonl(p->channelOffset) / ddpChannelsPerLed;
   start += DMXAddress / ddpChannelsPerLed;
-  uint16_t stop = start + htons(p->dataLen) / ddpChannelsPerLed;
+  uint32_t stop = start + htons(p->dataLen) / ddpChannelsPerLed;
   uint8_t* data = p->data;
   uint16_t c = 0;
   if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
@@ -40,7 +40,7 @@ void handleDDPPacket(e131_packet_t* p) {
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
   if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
-    for (uint16_t i = start; i < stop; i++) {
+    for (uint32_t i = start; i < stop; i++) {
       setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
       c += ddpChannelsPerLed;
     }
@@ -55,12 +55,116 @@ void handleDDPPacket(e131_packet_t* p) {
   }
 }
 
+/*
+ * WLEDMM E1.31/Art-Net merging of several senders per universe
+ *
+ * Every universe keeps the last data of up to WLED_DMX_MERGE_SOURCES senders (identified by IP).
+ * Only senders with the highest live E1.31 priority are merged (Art-Net counts as priority 100);
+ * senders that were silent for DMX_MERGE_TIMEOUT_MS are dropped, so a backup takes over automatically.
+ * Buffers are allocated once per universe (first packet with merging enabled), so there is no allocation in steady state.
+ */
+#ifndef WLED_DMX_MERGE_SOURCES
+#define WLED_DMX_MERGE_SOURCES  2
+#endif
+#if WLED_DMX_MERGE_SOURCES > 8
+#error WLED_DMX_MERGE_SOURCES must be 8 or less
+#endif
+#define DMX_MERGE_TIMEOUT_MS    2500   // E1.31 network data loss timeout
+#define DMX_MERGE_ARTNET_PRIO   100    // E1.31 default priority
+
+typedef struct {
+  uint32_t      ip;                    // 0 = unused
+  unsigned long lastSeen;
+  uint16_t      channels;
+  uint8_t       priority;
+  uint8_t       seq;
+  uint8_t       data[MAX_CHANNELS_PER_UNIVERSE];
+} DMXMergeSource;
+
+typedef struct {
+  DMXMergeSource src[WLED_DMX_MERGE_SOURCES];
+  uint8_t        owner[MAX_CHANNELS_PER_UNIVERSE]; // LTP: source that changed each channel last
+} DMXMergeUniverse;
+
+static DMXMergeUniverse* dmxMerge[E131_MAX_UNIVERSE_COUNT] = {nullptr}; // allocated on the first packet of each universe
+static bool    dmxMergeAllocFailed = false;
+static uint8_t dmxMerged[MAX_CHANNELS_PER_UNIVERSE+1]; // E1.31 layout: start code, channel 1..512
+
+// returns false if the packet does not change the output (lower priority, no free source slot, out of sequence)
+static bool mergeDMXData(uint8_t uniIdx, uint32_t ip, uint8_t priority, uint8_t seq, const uint8_t* data, uint16_t channels, uint16_t &mergedChannels) {
+  DMXMergeUniverse &u = *dmxMerge[uniIdx];
+  unsigned long now = millis();
+  channels = min(channels, uint16_t(MAX_CHANNELS_PER_UNIVERSE));
+
+  // find the sender, or a free / expired / lower priority slot for it
+  int slot = -1, spare = -1;
+  bool spareFree = false, isNew = true;
+  for (int i = 0; i < WLED_DMX_MERGE_SOURCES; i++) {
+    const DMXMergeSource &s = u.src[i];
+    bool alive = s.ip && (now - s.lastSeen < DMX_MERGE_TIMEOUT_MS);
+    if (s.ip == ip) { slot = i; isNew = !alive; break; }
+    if (!alive) { if (!spareFree) { spare = i; spareFree = true; } }
+    else if (!spareFree && (s.priority < priority) && (spare < 0 || u.src[spare].priority > s.priority)) spare = i;
+  }
+  if (slot < 0) slot = spare;
+  if (slot < 0) return false; // all slots taken by live senders with same or higher priority
+
+  DMXMergeSource &src = u.src[slot];
+  if (!isNew && e131SkipOutOfSequence && seq < src.seq && seq > 20 && src.seq < 250) return false;
+
+  if (e131MergeMode == DMX_MERGE_LTP) {
+    for (unsigned ch = 0; ch < channels; ch++) if (isNew || ch >= src.channels || data[ch] != src.data[ch]) u.owner[ch] = slot;
+  }
+  memcpy(src.data, data, channels);
+  src.ip = ip;
+  src.lastSeen = now;
+  src.channels = channels;
+  src.priority = priority;
+  src.seq = seq;
+
+  // only the highest live priority takes part
+  uint8_t topPriority = 0;
+  uint8_t live = 0; // bit mask of merged senders
+  for (int i = 0; i < WLED_DMX_MERGE_SOURCES; i++) {
+    const DMXMergeSource &s = u.src[i];
+    if (!s.ip || (now - s.lastSeen >= DMX_MERGE_TIMEOUT_MS)) continue;
+    if (s.priority > topPriority) { topPriority = s.priority; live = 0; }
+    if (s.priority == topPriority) live |= 1 << i;
+  }
+  if (!(live & (1 << slot))) return false; // sender is stored as backup, output unchanged
+
+  mergedChannels = 0;
+  for (int i = 0; i < WLED_DMX_MERGE_SOURCES; i++) if (live & (1 << i)) mergedChannels = max(mergedChannels, u.src[i].channels);
+
+  uint8_t* out = dmxMerged + 1;
+  if (e131MergeMode == DMX_MERGE_HTP) {
+    memcpy(out, src.data, channels);
+    if (channels < mergedChannels) memset(out + channels, 0, mergedChannels - channels);
+    for (int i = 0; i < WLED_DMX_MERGE_SOURCES; i++) {
+      if (i == slot || !(live & (1 << i))) continue;
+      const DMXMergeSource &s = u.src[i];
+      for (unsigned ch = 0; ch < s.channels; ch++) if (s.data[ch] > out[ch]) out[ch] = s.data[ch];
+    }
+  } else { // LTP
+    for (unsigned ch = 0; ch < mergedChannels; ch++) {
+      uint8_t o = u.owner[ch];
+      if ((o >= WLED_DMX_MERGE_SOURCES) || !(live & (1 << o)) || (ch >= u.src[o].channels)) { u.owner[ch] = o = slot; } // owner gone - current sender takes over
+      out[ch] = (ch < u.src[o].channels) ? u.src[o].data[ch] : 0;
+    }
+  }
+  return true;
+}
+
 //E1.31 and Art-Net protocol support
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
+  #ifdef WLED_ENABLE_RTREC
+  if (!rtRecorderPacket(p, clientIP, protocol)) return; // WLEDMM stream recorder (records, or drops live input during replay)
+  #endif
 
   uint16_t uni = 0, dmxChannels = 0;
   uint8_t* e131_data = nullptr;
   uint8_t seq = 0, mde = REALTIME_MODE_E131;
+  uint8_t priority = DMX_MERGE_ARTNET_PRIO;
 
   if (protocol == P_ARTNET)
   {
@@ -82,11 +186,14 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     uni = htons(p->universe);
     e131_data = p->property_values;
     seq = p->sequence_number;
+    priority = p->priority;
     if (e131Priority != 0) {
       if (p->priority < e131Priority ) return;
-      // track highest priority & skip all lower priorities
-      if (p->priority >= highPriority.get()) highPriority.set(p->priority);
-      if (p->priority < highPriority.get()) return;
+      // track highest priority & skip all lower priorities - WLEDMM the merge engine does this per universe
+      if (e131MergeMode == DMX_MERGE_OFF) {
+        if (p->priority >= highPriority.get()) highPriority.set(p->priority);
+        if (p->priority < highPriority.get()) return;
+      }
     }
   } else { //DDP
     realtimeIP = clientIP;
@@ -100,6 +207,23 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   uint8_t previousUniverses = uni - e131Universe;
 
+  // WLEDMM merge several senders
+  if ((e131MergeMode != DMX_MERGE_OFF) && (previousUniverses < E131_MAX_UNIVERSE_COUNT)) {
+    if (!dmxMerge[previousUniverses] && !dmxMergeAllocFailed) {
+      dmxMerge[previousUniverses] = (DMXMergeUniverse*) tieredCalloc(1, sizeof(DMXMergeUniverse), WLED_MEM_WARM, "DMX merge"); // once per packet, not per pixel
+      dmxMergeAllocFailed = (dmxMerge[previousUniverses] == nullptr);
+      if (dmxMergeAllocFailed) USER_PRINTF("E1.31 merge: not enough memory for universe %u, merging stopped.\n", uni);
+    }
+    if (dmxMerge[previousUniverses]) {
+      const uint8_t* channelData = (mde == REALTIME_MODE_ARTNET) ? e131_data : e131_data + 1; // channel 1 first
+      uint16_t mergedChannels = 0;
+      if (!mergeDMXData(previousUniverses, uint32_t(clientIP), priority, seq, channelData, dmxChannels, mergedChannels)) return;
+      realtimeIP = clientIP;
+      handleDMXData(uni, mergedChannels, (mde == REALTIME_MODE_ARTNET) ? dmxMerged + 1 : dmxMerged, mde, previousUniverses);
+      return;
+    }
+  }
+
   if (e131SkipOutOfSequence && (previousUniverses < E131_MAX_UNIVERSE_COUNT))  // WLEDMM
     if (seq < e131LastSequenceNumber[previousUniverses] && seq > 20 && e131LastSequenceNumber[previousUniverses] < 250){
       DEBUG_PRINT(F("skipping E1.31 frame (last seq="));
@@ -0,0 +1,156 @@
+#include "wled.h"
+
+/*
+ * WLEDMM ESP-NOW transport for sync notifications and small realtime pixel streams
+ *
+ * Nodes talk directly (broadcast, no access point in between), see espnow_sync.h for the packet layout.
+ * ESP-NOW is initialized by handleRemote() in remote.cpp, which forwards our packets to espNowSyncReceive().
+ * Receiving happens in the WiFi task - complete messages are copied for handleEspNowSync() in the main loop.
+ */
+#ifdef WLED_ENABLE_ESPNOW_SYNC
+#ifdef WLED_DISABLE_ESPNOW
+#error WLED_ENABLE_ESPNOW_SYNC needs ESP-NOW (remove WLED_DISABLE_ESPNOW)
+#endif
+
+#include "espnow_sync.h"
+
+#ifndef ESPNOW_PIXEL_FPS
+#define ESPNOW_PIXEL_FPS    40
+#endif
+#define ESPNOW_PIXEL_HEADER 3
+#define ESPNOW_MAX_PIXELS   ((ESPNOW_MAX_MESSAGE - ESPNOW_PIXEL_HEADER) / 3)
+
+static const uint8_t espNowBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static EspNowReassembler espNowRx;                               // only used from the receive callback
+static uint8_t  espNowReady[ESPNOW_MSG_TYPES][ESPNOW_MAX_MESSAGE]; // complete messages, waiting for the main loop
+static uint16_t espNowReadyLen[ESPNOW_MSG_TYPES] = {0};
+static uint8_t  espNowWork[ESPNOW_MAX_MESSAGE];                   // main loop copy
+static uint16_t espNowSeq[ESPNOW_MSG_TYPES] = {0};
+static uint32_t espNowSendErrors = 0;
+static unsigned long espNowLastPixels = 0;
+static unsigned long espNowLastShow = 0;
+
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE espNowMux = portMUX_INITIALIZER_UNLOCKED;
+#define ESPNOW_LOCK()   portENTER_CRITICAL(&espNowMux)
+#define ESPNOW_UNLOCK() portEXIT_CRITICAL(&espNowMux)
+#else
+#define ESPNOW_LOCK()   // ESP8266 callbacks do not interrupt loop()
+#define ESPNOW_UNLOCK()
+#endif
+
+#ifdef WLED_ESPNOW_LOOPBACK
+// single board test: everything we send is received by ourselves
+static EspNowReassembler espNowLoopRx;
+#endif
+
+// called by handleRemote() after esp_now_init(): broadcast peer for sending
+void espNowSyncInit() {
+#ifdef ARDUINO_ARCH_ESP32
+  if (!esp_now_is_peer_exist(espNowBroadcast)) {
+    esp_now_peer_info_t peer = {};
+    memcpy(peer.peer_addr, espNowBroadcast, 6);
+    peer.channel = 0;                                    // current WiFi channel
+    peer.ifidx   = apActive ? WIFI_IF_AP : WIFI_IF_STA;
+    peer.encrypt = false;
+    if (esp_now_add_peer(&peer) != ESP_OK) USER_PRINTLN(F("ESP-NOW sync: could not add broadcast peer."));
+  }
+#else
+  esp_now_set_self_role(ESP_NOW_ROLE_COMBO);
+  esp_now_add_peer(const_cast<uint8_t*>(espNowBroadcast), ESP_NOW_ROLE_COMBO, 0, NULL, 0);
+#endif
+  USER_PRINTLN(F("ESP-NOW sync started."));
+}
+
+// ESP-NOW receive callback context - returns true if the packet belongs to us
+bool espNowSyncReceive(const uint8_t* mac, const uint8_t* data, int len) {
+  if (len < 0 || !espNowIsSyncPacket(data, len)) return false;
+  int type = espNowRx.push(mac, data, len);
+  if (type < 0) return true;
+  ESPNOW_LOCK();
+  memcpy(espNowReady[type], espNowRx.message(type), espNowRx.length(type)); // latest message wins
+  espNowReadyLen[type] = espNowRx.length(type);
+  ESPNOW_UNLOCK();
+  return true;
+}
+
+static bool espNowSendPacket(const uint8_t* packet, size_t len) {
+#ifdef WLED_ESPNOW_LOOPBACK
+  static uint8_t ownMac[6] = {0};
+  if (!ownMac[0]) WiFi.macAddress(ownMac);
+  int type = espNowLoopRx.push(ownMac, packet, len);
+  if (type >= 0) {
+    ESPNOW_LOCK();
+    memcpy(espNowReady[type], espNowLoopRx.message(type), espNowLoopRx.length(type));
+    espNowReadyLen[type] = espNowLoopRx.length(type);
+    ESPNOW_UNLOCK();
+  }
+  return true;
+#else
+  if (esp_now_send(const_cast<uint8_t*>(espNowBroadcast), const_cast<uint8_t*>(packet), len) != ESP_OK) {
+    if ((espNowSendErrors++ % 100) == 0) DEBUG_PRINTF("ESP-NOW sync: send failed (%u errors).\n", espNowSendErrors);
+    return false;
+  }
+  return true;
+#endif
+}
+
+bool espNowSyncSend(uint8_t type, const uint8_t* data, size_t len) {
+  if (!espNowSyncMode || type >= ESPNOW_MSG_TYPES) return false;
+  return espNowSplitMessage(type, espNowSeq[type]++, data, len, espNowSendPacket);
+}
+
+static void espNowApplyPixels(const uint8_t* msg, size_t len) {
+  if (!receiveDirect || len < ESPNOW_PIXEL_HEADER) return;
+  uint8_t  channels = msg[0];
+  uint16_t id = msg[1] | (msg[2] << 8);
+  if (channels != 3 && channels != 4) return;
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ESPNOW);
+  if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+  pixel_index_t totalLen = strip.getLengthTotal();
+  for (size_t i = ESPNOW_PIXEL_HEADER; i + channels <= len && id < totalLen; i += channels, id++) {
+    setRealtimePixel(id, msg[i], msg[i+1], msg[i+2], (channels == 4) ? msg[i+3] : 0);
+  }
+  if (!(realtimeMode && useMainSegmentOnly)) strip.show();
+}
+
+// stream our own LEDs (RGB, from the start of the strip) to other nodes
+static void espNowSendPixels() {
+  if (realtimeMode == REALTIME_MODE_ESPNOW) return;                 // don't echo a stream we receive
+  if (strip.getLastShow() == espNowLastShow) return;                // nothing new
+  if (millis() - espNowLastPixels < 1000 / ESPNOW_PIXEL_FPS) return;
+  espNowLastShow   = strip.getLastShow();
+  espNowLastPixels = millis();
+
+  unsigned count = min(unsigned(strip.getLengthTotal()), unsigned(ESPNOW_MAX_PIXELS));
+  uint8_t* msg = espNowWork; // main loop only
+  msg[0] = 3;
+  msg[1] = 0; msg[2] = 0;    // first pixel
+  size_t len = ESPNOW_PIXEL_HEADER;
+  for (unsigned i = 0; i < count; i++) {
+    uint32_t c = strip.getPixelColorRestored(i);
+    msg[len++] = R(c); msg[len++] = G(c); msg[len++] = B(c);
+  }
+  espNowSyncSend(ESPNOW_MSG_PIXELS, msg, len);
+}
+
+void handleEspNowSync() {
+  if (!espNowSyncMode) return;
+  for (uint8_t type = 0; type < ESPNOW_MSG_TYPES; type++) {
+    size_t len = 0;
+    ESPNOW_LOCK();
+    if (espNowReadyLen[type]) {
+      len = espNowReadyLen[type];
+      memcpy(espNowWork, espNowReady[type], len);
+      espNowReadyLen[type] = 0;
+    }
+    ESPNOW_UNLOCK();
+    if (!len) continue;
+    if (type == ESPNOW_MSG_SYNC && (espNowSyncMode & ESPNOW_SYNC_NOTIFY)) handleSyncPacket(espNowWork, len);
+    else if (type == ESPNOW_MSG_PIXELS && (espNowSyncMode & ESPNOW_SYNC_PIXELS_IN)) espNowApplyPixels(espNowWork, len);
+  }
+  if (espNowSyncMode & ESPNOW_SYNC_PIXELS_OUT) espNowSendPixels();
+}
+
+#endif
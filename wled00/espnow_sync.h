@@ -0,0 +1,141 @@
+#pragma once
+#ifndef WLED_ESPNOW_SYNC_H
+#define WLED_ESPNOW_SYNC_H
+
+/*
+ * WLEDMM ESP-NOW sync transport - message framing and reassembly
+ *
+ * No Arduino dependencies: test/test_espnow_sync sends notifier packets through split, EspNowLoopback
+ * and reassembly on the build host (pio test -e native).
+ *
+ * Messages of up to ESPNOW_MAX_MESSAGE bytes are split into ESP-NOW packets of max. 250 bytes:
+ *   header (12 bytes): 'W', 'N', version, message type, message sequence (uint16),
+ *                      chunk index, chunk count, byte offset (uint16), message length (uint16)
+ *   payload:           up to ESPNOW_MAX_PAYLOAD bytes of the message, starting at offset
+ * All multi-byte values are little endian. Chunks may arrive in any order; a new sequence number
+ * (or sender) discards an incomplete message of the same type.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define ESPNOW_MAX_PACKET   250
+#define ESPNOW_HEADER_LEN   12
+#define ESPNOW_MAX_PAYLOAD  (ESPNOW_MAX_PACKET - ESPNOW_HEADER_LEN)
+#define ESPNOW_MAX_MESSAGE  2048
+#define ESPNOW_MAX_CHUNKS   ((ESPNOW_MAX_MESSAGE + ESPNOW_MAX_PAYLOAD - 1) / ESPNOW_MAX_PAYLOAD)
+#define ESPNOW_VERSION      1
+
+#define ESPNOW_MSG_SYNC     0   // WLED notifier packet (same as UDP)
+#define ESPNOW_MSG_PIXELS   1   // channels per pixel, first pixel (uint16), pixel data
+#define ESPNOW_MSG_TYPES    2
+
+// split a message into packets and hand each one to send(packet, length); returns false if send() failed
+template<typename SendFn>
+bool espNowSplitMessage(uint8_t type, uint16_t seq, const uint8_t* msg, size_t len, SendFn send) {
+  if (len == 0 || len > ESPNOW_MAX_MESSAGE) return false;
+  uint8_t packet[ESPNOW_MAX_PACKET];
+  uint8_t count = (len + ESPNOW_MAX_PAYLOAD - 1) / ESPNOW_MAX_PAYLOAD;
+  for (uint8_t idx = 0; idx < count; idx++) {
+    size_t offset = size_t(idx) * ESPNOW_MAX_PAYLOAD;
+    size_t chunk  = (len - offset < ESPNOW_MAX_PAYLOAD) ? len - offset : ESPNOW_MAX_PAYLOAD;
+    packet[0]  = 'W';
+    packet[1]  = 'N';
+    packet[2]  = ESPNOW_VERSION;
+    packet[3]  = type;
+    packet[4]  = seq & 0xFF;    packet[5]  = seq >> 8;
+    packet[6]  = idx;
+    packet[7]  = count;
+    packet[8]  = offset & 0xFF; packet[9]  = offset >> 8;
+    packet[10] = len & 0xFF;    packet[11] = len >> 8;
+    memcpy(packet + ESPNOW_HEADER_LEN, msg + offset, chunk);
+    if (!send(packet, ESPNOW_HEADER_LEN + chunk)) return false;
+  }
+  return true;
+}
+
+static inline bool espNowIsSyncPacket(const uint8_t* data, size_t len) {
+  return (len >= ESPNOW_HEADER_LEN) && (data[0] == 'W') && (data[1] == 'N') && (data[2] == ESPNOW_VERSION);
+}
+
+class EspNowReassembler {
+  public:
+    // feed one packet; returns the message type when a message is complete, -1 otherwise
+    int push(const uint8_t* mac, const uint8_t* data, size_t len) {
+      if (!espNowIsSyncPacket(data, len)) return -1;
+      uint8_t  type   = data[3];
+      uint16_t seq    = data[4] | (data[5] << 8);
+      uint8_t  idx    = data[6];
+      uint8_t  count  = data[7];
+      uint16_t offset = data[8] | (data[9] << 8);
+      uint16_t total  = data[10] | (data[11] << 8);
+      size_t   chunk  = len - ESPNOW_HEADER_LEN;
+      if (type >= ESPNOW_MSG_TYPES || count == 0 || count > ESPNOW_MAX_CHUNKS || idx >= count) return -1;
+      if (total > ESPNOW_MAX_MESSAGE || size_t(offset) + chunk > total) return -1;
+
+      Slot &s = _slots[type];
+      if (!s.active || s.seq != seq || s.total != total || s.count != count || memcmp(s.mac, mac, 6) != 0) {
+        if (s.active && s.received) _dropped++; // previous message incomplete
+        s.active   = true;
+        s.seq      = seq;
+        s.total    = total;
+        s.count    = count;
+        s.received = 0;
+        s.mask     = 0;
+        memcpy(s.mac, mac, 6);
+      }
+      uint16_t bit = 1U << idx;
+      if (s.mask & bit) return -1; // duplicate
+      memcpy(s.data + offset, data + ESPNOW_HEADER_LEN, chunk);
+      s.mask |= bit;
+      if (++s.received < s.count) return -1;
+      s.active = false;
+      _complete++;
+      return type;
+    }
+
+    const uint8_t* message(uint8_t type) const { return _slots[type].data; }
+    size_t length(uint8_t type) const { return _slots[type].total; }
+    const uint8_t* sender(uint8_t type) const { return _slots[type].mac; }
+    uint32_t dropped() const { return _dropped; }
+    uint32_t complete() const { return _complete; }
+
+  private:
+    struct Slot {
+      bool     active = false;
+      uint16_t seq = 0, total = 0;
+      uint8_t  count = 0, received = 0;
+      uint16_t mask = 0;                     // one bit per chunk (ESPNOW_MAX_CHUNKS <= 16)
+      uint8_t  mac[6] = {0};
+      uint8_t  data[ESPNOW_MAX_MESSAGE];
+    };
+    Slot     _slots[ESPNOW_MSG_TYPES];
+    uint32_t _dropped = 0;
+    uint32_t _complete = 0;
+};
+
+static_assert(ESPNOW_MAX_CHUNKS <= 16, "chunk mask is 16 bit");
+
+// stand-in for the radio in host tests: packets go straight into a reassembler, optionally losing every n-th packet
+class EspNowLoopback {
+  public:
+    EspNowLoopback(EspNowReassembler &rx, const uint8_t* mac, unsigned dropEvery = 0) : _rx(rx), _dropEvery(dropEvery) { memcpy(_mac, mac, 6); }
+
+    // returns the completed message type, or -1
+    int send(const uint8_t* packet, size_t len) {
+      _sent++;
+      if (_dropEvery && (_sent % _dropEvery == 0)) return -1;
+      return _rx.push(_mac, packet, len);
+    }
+
+    uint32_t sent() const { return _sent; }
+
+  private:
+    EspNowReassembler &_rx;
+    uint8_t  _mac[6];
+    unsigned _dropEvery;
+    uint32_t _sent = 0;
+};
+
+#endif
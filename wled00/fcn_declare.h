@@ -57,6 +57,7 @@ uint32_t __attribute__((const)) color_fade(uint32_t c1, uint8_t amount, bool vid
 #else
 #include "colorTools.hpp"
 #endif
+uint32_t __attribute__((const)) color_composite(uint32_t below, uint32_t layer, uint8_t mode, uint8_t opacity); // WLEDMM layer is already scaled by opacity - not in colorTools.hpp, needed by all builds
 
 inline uint32_t colorFromRgbw(byte* rgbw) { return uint32_t((byte(rgbw[3]) << 24) | (byte(rgbw[0]) << 16) | (byte(rgbw[1]) << 8) | (byte(rgbw[2]))); }
 void colorHStoRGB(uint16_t hue, byte sat, byte* rgb); //hue, sat to rgb
@@ -75,6 +76,22 @@ uint8_t __attribute__((pure)) gamma8(uint8_t b);
 uint32_t __attribute__((pure)) gamma32(uint32_t);                                             // WLEDMM: added attribute pure
 uint8_t unGamma8(uint8_t value);                                                              // WLEDMM revert gamma correction
 uint32_t unGamma24(uint32_t c);                                                               // WLEDMM for 24bit color (white left as-is)
+#ifdef WLEDMM_COLOR_8DOT8
+// WLEDMM 16bit per channel colors (8.8 fixed point), packed as W-R-G-B into 64bit
+#define RGBW64(r,g,b,w) ((uint64_t(uint16_t(w)) << 48) | (uint64_t(uint16_t(r)) << 32) | (uint64_t(uint16_t(g)) << 16) | uint64_t(uint16_t(b)))
+#define R16(c) (uint16_t((c) >> 32))
+#define G16(c) (uint16_t((c) >> 16))
+#define B16(c) (uint16_t(c))
+#define W16(c) (uint16_t((c) >> 48))
+#define COLOR8TO16(c) RGBW64(R(c)*257U, G(c)*257U, B(c)*257U, W(c)*257U)           // 0xFF -> 0xFFFF
+#define COLOR16TO8(c) RGBW32(R16(c) >> 8, G16(c) >> 8, B16(c) >> 8, W16(c) >> 8)
+uint64_t __attribute__((const)) color_blend16(uint64_t color1, uint64_t color2, uint16_t blend);  // blend 0..65535
+uint64_t __attribute__((const)) color_add16(uint64_t c1, uint64_t c2);                            // preserves color ratio
+uint64_t __attribute__((const)) color_fade16(uint64_t c1, uint16_t amount);                       // amount 0..65535 (65535 = no fade)
+#ifdef WLEDMM_COLOR_BENCHMARK
+void benchmarkColorKernels(void);
+#endif
+#endif
 
 //dmx_output.cpp
 void initDMXOutput();
@@ -84,9 +101,25 @@ void handleDMXOutput();
 void initDMXInput();
 void handleDMXInput();
 
+//espnow_sync.cpp
+#ifdef WLED_ENABLE_ESPNOW_SYNC
+void espNowSyncInit();
+bool espNowSyncReceive(const uint8_t* mac, const uint8_t* data, int len);
+bool espNowSyncSend(uint8_t type, const uint8_t* data, size_t len);
+void handleEspNowSync();
+#endif
+
 //e131.cpp
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
 void handleDMXData(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, uint8_t mde, uint8_t previousUniverses);
+
+//rt_recorder.cpp
+#ifdef WLED_ENABLE_RTREC
+bool rtRecorderPacket(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleRtRecorder();
+void deserializeRtRecorder(JsonObject rec);
+void serializeRtRecorder(JsonObject rec);
+#endif
 void handleArtnetPollReply(IPAddress ipAddress);
 void prepareArtnetPollReply(ArtPollReply* reply);
 void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t portAddress);
@@ -100,6 +133,9 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest);
 void updateFSInfo();
 void closeFile();
 void invalidateFileNameCache();   // WLEDMM call when new files were uploaded
+#if defined(WLED_ENABLE_FSEQ) || defined(WLED_ENABLE_RTREC)
+File openMediaFile(const char* path, const char* mode);
+#endif
 
 //hue.cpp
 void handleHue();
@@ -157,10 +193,39 @@ void serializeInfo(JsonObject root);
 void serializeModeNames(JsonArray arr, const char *qstring);
 void serializeModeData(JsonObject root);
 void serveJson(AsyncWebServerRequest* request);
+uint32_t hashJson(JsonVariantConst v);
 #ifdef WLED_ENABLE_JSONLIVE
 bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient = 0);
 #endif
 
+//framesync.cpp
+#ifdef WLED_ENABLE_FRAMESYNC
+void initFrameSync();
+void handleFrameSync();
+int frameSyncPoll(unsigned long &effectTime);
+#endif
+
+//sequencer.cpp
+#ifdef WLED_ENABLE_SEQUENCER
+void initSequencer();
+void handleSequencer();
+void sequencerService();
+int32_t sequencerPosition();
+void deserializeSequencer(JsonObject seq);
+void serializeSequencer(JsonObject seq);
+#endif
+
+//fseq_player.cpp
+#ifdef WLED_ENABLE_FSEQ
+void handleFseqPlayer();
+void deserializeFseq(JsonObject fseq);
+void serializeFseq(JsonObject fseq);
+#endif
+
+//live_stream.cpp
+void serveLiveStream(AsyncWebServerRequest* request);
+bool sendLiveStreamWs(uint32_t wsClient, int segId = -1);
+
 #ifdef ARDUINO_ARCH_ESP32
 #include <esp_system.h>
 int getCoreResetReason(int core);
@@ -252,8 +317,9 @@ void notify(byte callMode, bool followUp=false);
 uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false, uint8_t artnet_outouts=1, uint16_t artnet_leds_per_output=1, uint8_t artnet_fps_limit=1);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
+void handleSyncPacket(const byte* data, size_t len);
 void handleNotifications();
-void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixel(pixel_index_t i, byte r, byte g, byte b, byte w);
 void refreshNodeList();
 void sendSysInfoUDP();
 
@@ -381,7 +447,21 @@ void sappends(char stype, const char* key, char* val);
 void prepareHostname(char* hostname);
 bool isAsterisksOnly(const char* str, byte maxLen)  __attribute__((pure));
 bool requestJSONBufferLock(uint8_t module=255);
+bool tryJSONBufferLock(uint8_t module=255); // WLEDMM non-blocking
 void releaseJSONBufferLock();
+int8_t leaseJSONBuffer(uint8_t module, JsonDocument** leasedDoc, bool wait = true);
+void returnJSONBuffer(int8_t slot);
+void serializeJSONBufferStats(JsonObject root);
+void* tieredMalloc(size_t size, uint8_t tier, const char* owner);
+void* tieredCalloc(size_t count, size_t size, uint8_t tier, const char* owner);
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+void* tieredAlignedCalloc(size_t align, size_t count, size_t size, uint8_t tier, const char* owner);
+#endif
+void* tieredRealloc(void* ptr, size_t size, uint8_t tier, const char* owner); // frees ptr on failure, like reallocf()
+void printMemoryPlacement();
+#ifdef WLEDMM_SEGMENT_ARENA
+void serializeSegmentArena(JsonObject root); // FX_fcn.cpp
+#endif
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen);
 uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxLen, uint8_t *var = nullptr);
 int16_t extractModeDefaults(uint8_t mode, const char *segVar);
@@ -414,6 +494,23 @@ class JSONBufferGuard {
     inline void release() { if (holding_lock) releaseJSONBufferLock(); holding_lock = false; }
 };
 
+// WLEDMM RAII lease of a JSON document for read-only use (serialize & send)
+// uses a pool document if one is free, otherwise waits for the global "doc" like JSONBufferGuard
+// do not use for requests that change state or presets - they need the global "doc" lock (fileDoc)
+class JSONBufferLease {
+  JsonDocument* _doc = nullptr;
+  int8_t _slot;
+  public:
+    inline JSONBufferLease(uint8_t module=255, bool wait=true) : _slot(leaseJSONBuffer(module, &_doc, wait)) {};
+    inline ~JSONBufferLease() { release(); };
+    inline JSONBufferLease(const JSONBufferLease&) = delete; // Noncopyable
+    inline JSONBufferLease& operator=(const JSONBufferLease&) = delete;
+    inline JSONBufferLease(JSONBufferLease&& r) : _doc(r._doc), _slot(r._slot) { r._doc = nullptr; r._slot = -1; };  // but movable
+    inline JsonDocument* doc() const { return _doc; }
+    explicit inline operator bool() const { return _slot >= 0; };
+    inline void release() { if (_slot >= 0) returnJSONBuffer(_slot); _slot = -1; _doc = nullptr; }
+};
+
 #ifdef WLED_ADD_EEPROM_SUPPORT
 //wled_eeprom.cpp
 void applyMacro(byte index);
@@ -10,6 +10,16 @@
 #endif
 #endif
 
+#if defined(WLED_ENABLE_FSEQ) || defined(WLED_ENABLE_RTREC)
+#if defined(WLED_USE_SD_MMC)
+  #include "SD_MMC.h"
+  #define WLED_SD SD_MMC
+#elif defined(WLED_USE_SD_SPI)
+  #include "SD.h"
+  #define WLED_SD SD
+#endif
+#endif
+
 //WLEDMM seems that 256 is indeed the optimal buffer length
 #define FS_BUFSIZE 256
 
@@ -52,6 +62,16 @@ void closeFile() {
   doCloseFile = false;
 }
 
+#if defined(WLED_ENABLE_FSEQ) || defined(WLED_ENABLE_RTREC)
+// WLEDMM show and recording files: "/sd/..." lives on the SD card (if there is one), everything else on WLED_FS
+File openMediaFile(const char* path, const char* mode) {
+  #ifdef WLED_SD
+  if (strncmp(path, "/sd/", 4) == 0) return WLED_SD.open(path + 3, mode);
+  #endif
+  return WLED_FS.open(path, mode);
+}
+#endif
+
 //find() that reads and buffers data from file stream in 256-byte blocks.
 //Significantly faster, f.find(key) can take SECONDS for multi-kB files
 static bool bufferedFind(const char *target, bool fromStart = true) {
@@ -438,7 +458,7 @@ static const uint8_t *getPresetCache(size_t &size) {
       presetsCachedTime = presetsModifiedTime;
       presetsCachedValidate = cacheInvalidate;
       presetsCachedSize = 0;
-      presetsCached = (uint8_t*)ps_malloc(file.size() + 1);
+      presetsCached = (uint8_t*)tieredMalloc(file.size() + 1, WLED_MEM_COLD, "presets cache");
       if (presetsCached) {
         presetsCachedSize = file.size();
         file.read(presetsCached, presetsCachedSize);
@@ -0,0 +1,211 @@
+#include "wled.h"
+
+/*
+ * WLEDMM frame-locked rendering across several controllers
+ *
+ * The master broadcasts its frame grid (period, own clock, strip.timebase). Followers measure the clock offset
+ * with a PTP-style delay request / response (t1..t4), estimate drift with a small PI loop, and then render
+ * frame "k" at the same instant as the master, with exactly the same effect time (strip.now).
+ *
+ * Packet layout (little endian): 'F','S', version, type, payload
+ *   ANNOUNCE   (master -> broadcast): masterUs (int64), periodUs (uint32), timebase (int32), syncGroups (uint8)
+ *   DELAY_REQ  (follower -> master):  t1 (int64)
+ *   DELAY_RESP (master -> follower):  t1 (int64), t2 (int64), t3 (int64), periodUs (uint32), timebase (int32)
+ */
+#ifdef WLED_ENABLE_FRAMESYNC
+
+#define FS_VERSION          1
+#define FS_ANNOUNCE         1
+#define FS_DELAY_REQ        2
+#define FS_DELAY_RESP       3
+#define FS_PACKET_SIZE      40
+#define FS_ANNOUNCE_MS      250   // master: announce interval
+#define FS_REQUEST_MS       500   // follower: delay request interval (faster until locked)
+#define FS_TIMEOUT_MS       3000  // follower: free-run when master is gone
+#define FS_STEP_US          10000 // offset error that causes a hard step instead of slewing
+#define FS_MIN_PERIOD_US    2000
+
+static WiFiUDP   fsUdp;
+static bool      fsConnected = false;
+
+// master & follower
+static uint32_t  fsPeriodUs   = 0;     // frame period of the shared grid
+static int64_t   fsLastTick   = -1;    // last rendered tick number
+
+// follower
+static IPAddress fsMasterIP;
+static int32_t   fsMasterTimebase = 0;
+static int64_t   fsOffsetUs   = 0;     // master clock - local clock, at fsLastSyncUs
+static float     fsDrift      = 0.0f;  // master clock speed relative to local clock (us per us)
+static int64_t   fsLastSyncUs = 0;     // local time of last accepted measurement
+static uint32_t  fsMinRttUs   = UINT32_MAX;
+static unsigned long fsLastAnnounce = 0;
+static unsigned long fsLastRequest  = 0;
+static uint8_t   fsSamples    = 0;     // accepted measurements since (re)lock
+
+static inline int64_t fsMicros() {
+#ifdef ARDUINO_ARCH_ESP32
+  return esp_timer_get_time();
+#else
+  return micros(); // rolls over after 71 minutes - good enough for ESP8266
+#endif
+}
+
+static void fsPut64(uint8_t* p, int64_t v) { for (unsigned i = 0; i < 8; i++) p[i] = (uint64_t(v) >> (8*i)) & 0xFF; }
+static void fsPut32(uint8_t* p, uint32_t v) { for (unsigned i = 0; i < 4; i++) p[i] = (v >> (8*i)) & 0xFF; }
+static int64_t fsGet64(const uint8_t* p) { uint64_t v = 0; for (unsigned i = 0; i < 8; i++) v |= uint64_t(p[i]) << (8*i); return int64_t(v); }
+static uint32_t fsGet32(const uint8_t* p) { uint32_t v = 0; for (unsigned i = 0; i < 4; i++) v |= uint32_t(p[i]) << (8*i); return v; }
+
+static void fsHeader(uint8_t* p, uint8_t type) { p[0] = 'F'; p[1] = 'S'; p[2] = FS_VERSION; p[3] = type; }
+
+// follower: best estimate of the master clock
+static inline int64_t fsMasterMicros(int64_t localUs) {
+  return localUs + fsOffsetUs + int64_t(fsDrift * float(localUs - fsLastSyncUs));
+}
+
+static bool fsLocked() {
+  return (fsSamples >= 2) && (fsPeriodUs >= FS_MIN_PERIOD_US) && (millis() - fsLastAnnounce < FS_TIMEOUT_MS);
+}
+
+void initFrameSync() {
+  fsConnected = false;
+  if (frameSyncMode == FRAMESYNC_OFF || frameSyncPort == 0) return;
+  fsConnected = fsUdp.begin(frameSyncPort);
+  fsSamples = 0;
+  fsLastTick = -1;
+  fsMinRttUs = UINT32_MAX;
+  USER_PRINTF("Frame sync %s on port %u %s.\n", frameSyncMode == FRAMESYNC_MASTER ? "master" : "follower", frameSyncPort, fsConnected ? "started" : "failed");
+}
+
+// follower: process a delay response (t1 = request sent, t2 = master received, t3 = master replied, t4 = response received)
+static void fsHandleDelayResp(const uint8_t* p, int64_t t4) {
+  int64_t t1 = fsGet64(p+4), t2 = fsGet64(p+12), t3 = fsGet64(p+20);
+  uint32_t period = fsGet32(p+28);
+  int64_t rtt = (t4 - t1) - (t3 - t2);
+  if (rtt < 0 || rtt > 500000) return; // stale or broken
+  // ignore measurements with unusually long round trip (wifi retries) - they are asymmetric most of the time
+  if (uint32_t(rtt) < fsMinRttUs) fsMinRttUs = rtt;
+  else fsMinRttUs += (fsMinRttUs >> 6) + 1; // let the minimum age slowly
+  if ((fsSamples > 0) && (rtt > int64_t(fsMinRttUs) * 2 + 1000)) return;
+
+  int64_t measured = ((t2 - t1) + (t3 - t4)) / 2;  // master - local
+  fsMasterTimebase = int32_t(fsGet32(p+32));
+  fsPeriodUs = period;
+
+  if (fsSamples == 0 || fsLastSyncUs == 0) {
+    fsOffsetUs = measured; fsDrift = 0.0f;
+  } else {
+    int64_t predicted = fsOffsetUs + int64_t(fsDrift * float(t4 - fsLastSyncUs));
+    int64_t error = measured - predicted;
+    if (llabs(error) > FS_STEP_US) {
+      fsOffsetUs = measured; fsDrift = 0.0f; fsSamples = 0; // lost lock - step
+      DEBUG_PRINTF("Frame sync: step %lld us\n", error);
+    } else {
+      // PI loop: correct a quarter of the phase error now, and slowly learn the frequency error
+      fsOffsetUs = predicted + error / 4;
+      float dt = float(t4 - fsLastSyncUs);
+      if (dt > 0) fsDrift = constrain(fsDrift + (float(error) / dt) / 8.0f, -0.001f, 0.001f); // max 1000ppm
+    }
+  }
+  fsLastSyncUs = t4;
+  if (fsSamples < 255) fsSamples++;
+}
+
+void handleFrameSync() {
+  if (!fsConnected || frameSyncMode == FRAMESYNC_OFF) return;
+  uint8_t buf[FS_PACKET_SIZE];
+
+  // receive
+  int size;
+  while ((size = fsUdp.parsePacket()) > 0) {
+    int64_t rxUs = fsMicros();
+    if (size > FS_PACKET_SIZE) { fsUdp.flush(); continue; }
+    int len = fsUdp.read(buf, size);
+    if (len < 4 || buf[0] != 'F' || buf[1] != 'S' || buf[2] != FS_VERSION) continue;
+
+    if (frameSyncMode == FRAMESYNC_MASTER && buf[3] == FS_DELAY_REQ && len >= 12) {
+      uint8_t resp[FS_PACKET_SIZE];
+      fsHeader(resp, FS_DELAY_RESP);
+      memcpy(resp+4, buf+4, 8);                  // t1
+      fsPut64(resp+12, rxUs);                    // t2
+      fsPut32(resp+28, fsPeriodUs);
+      fsPut32(resp+32, uint32_t(strip.timebase));
+      if (0 != fsUdp.beginPacket(fsUdp.remoteIP(), fsUdp.remotePort())) {
+        fsPut64(resp+20, fsMicros());            // t3 - as late as possible
+        fsUdp.write(resp, 36);
+        fsUdp.endPacket();
+      }
+    } else if (frameSyncMode == FRAMESYNC_FOLLOWER && buf[3] == FS_ANNOUNCE && len >= 21) {
+      if (!(receiveGroups & buf[20])) continue;  // not our sync group
+      fsMasterIP = fsUdp.remoteIP();
+      fsPeriodUs = fsGet32(buf+12);
+      fsLastAnnounce = millis();
+    } else if (frameSyncMode == FRAMESYNC_FOLLOWER && buf[3] == FS_DELAY_RESP && len >= 36) {
+      fsHandleDelayResp(buf, rxUs);
+    }
+  }
+
+  // send
+  if (frameSyncMode == FRAMESYNC_MASTER) {
+    uint8_t fps = strip.getTargetFps();
+    if ((fps == FPS_UNLIMITED) || (fps == FPS_UNLIMITED_AC)) fps = WLED_FPS; // unlimited makes no sense for a shared grid
+    fsPeriodUs = max(uint32_t(FS_MIN_PERIOD_US), uint32_t(1000000UL / fps)); // grid follows target FPS
+    if (millis() - fsLastAnnounce >= FS_ANNOUNCE_MS) {
+      fsLastAnnounce = millis();
+      IPAddress broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+      fsHeader(buf, FS_ANNOUNCE);
+      fsPut64(buf+4, fsMicros());
+      fsPut32(buf+12, fsPeriodUs);
+      fsPut32(buf+16, uint32_t(strip.timebase));
+      buf[20] = syncGroups;
+      if (0 != fsUdp.beginPacket(broadcastIp, frameSyncPort)) {
+        fsUdp.write(buf, 21);
+        fsUdp.endPacket();
+      }
+    }
+  } else if (fsMasterIP[0] != 0 && (millis() - fsLastAnnounce < FS_TIMEOUT_MS)) {
+    unsigned long interval = (fsSamples < 8) ? FS_REQUEST_MS / 4 : FS_REQUEST_MS;
+    if (millis() - fsLastRequest >= interval) {
+      fsLastRequest = millis();
+      fsHeader(buf, FS_DELAY_REQ);
+      if (0 != fsUdp.beginPacket(fsMasterIP, frameSyncPort)) {
+        fsPut64(buf+4, fsMicros());              // t1
+        fsUdp.write(buf, 12);
+        fsUdp.endPacket();
+      }
+    }
+    // smoothly pull strip.timebase towards the master, so code outside service() sees the same effect time
+    if (fsLocked()) {
+      int64_t masterMs = fsMasterMicros(fsMicros()) / 1000;
+      int32_t target = int32_t(uint32_t(masterMs) + uint32_t(fsMasterTimebase) - uint32_t(millis()));
+      int32_t diff = target - int32_t(strip.timebase);
+      if (abs(diff) > 1000) strip.timebase = target;       // far off - jump
+      else if (diff > 0) strip.timebase++;                  // slew 1ms per loop
+      else if (diff < 0) strip.timebase--;
+    }
+  }
+}
+
+// called from strip.service(): -1 = not frame-locked (use normal timing), 0 = wait, 1 = render now with effectTime
+int frameSyncPoll(unsigned long &effectTime) {
+  if (!fsConnected || frameSyncMode == FRAMESYNC_OFF) return -1;
+  int64_t clockUs;
+  int32_t timebase;
+  if (frameSyncMode == FRAMESYNC_MASTER) {
+    if (fsPeriodUs < FS_MIN_PERIOD_US) return -1;
+    clockUs  = fsMicros();
+    timebase = strip.timebase;
+  } else {
+    if (!fsLocked()) { fsLastTick = -1; return -1; } // free-run until we have a stable lock
+    clockUs  = fsMasterMicros(fsMicros());
+    timebase = fsMasterTimebase;
+  }
+  int64_t tick = clockUs / fsPeriodUs;
+  if (tick == fsLastTick) return 0;
+  fsLastTick = tick;
+  // identical effect time on all controllers -> identical pixels
+  effectTime = (unsigned long)((tick * fsPeriodUs) / 1000) + (unsigned long)timebase;
+  return 1;
+}
+
+#endif
@@ -0,0 +1,202 @@
+#pragma once
+#ifndef WLED_FSEQ_H
+#define WLED_FSEQ_H
+
+/*
+ * WLEDMM xLights .fseq (version 2) file header
+ *
+ * Layout (little endian):
+ *   0  'PSEQ'               4  channel data offset (uint16)   6  minor version   7  major version (2)
+ *   8  header length (uint16, start of variable headers)       10 channels per frame (uint32)
+ *   14 frame count (uint32) 18 step time in ms                19 flags
+ *   20 compression (bits 0-3: 0 none, 1 zstd, 2 zlib; bits 4-7: high bits of the block count)
+ *   21 compression block count (low 8 bits)                   22 sparse range count    23 reserved
+ *   24 unique id (uint64)
+ *   32 compression blocks: frame number (uint32), length (uint32)
+ *   .. sparse ranges: first channel (uint24), channel count (uint24)
+ * Frame n starts at channel data offset + n * channels per frame. With sparse ranges, a frame holds only the
+ * channels of the ranges, one range after the other.
+ * Compressed files (WLED_ENABLE_FSEQ_ZSTD): each compression block is one zstd frame that holds the frames
+ * from its frame number up to the next block's; blocks follow each other from the channel data offset on.
+ * Unused entries at the end of the block table have length 0.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#ifdef WLED_ENABLE_FSEQ_ZSTD
+#define ZSTD_STATIC_LINKING_ONLY  // ZSTD_createDStream_advanced()
+#include <zstd.h>
+#endif
+
+#define FSEQ_FIXED_HEADER  32
+#define FSEQ_MAX_RANGES    16
+#define FSEQ_COMPRESS_NONE 0
+#define FSEQ_COMPRESS_ZSTD 1
+#define FSEQ_COMPRESS_ZLIB 2
+
+struct FseqBlock {
+  uint32_t frame;   // first frame in the block
+  uint32_t offset;  // file position of the compressed data
+  uint32_t len;     // compressed length
+};
+
+struct FseqHeader {
+  uint16_t dataOffset;
+  uint8_t  major, minor;
+  uint32_t channels;      // bytes per frame
+  uint32_t frames;
+  uint8_t  stepMs;
+  uint8_t  compression;
+  uint16_t blocks;
+  uint8_t  ranges;        // 0 = frame is channels 0..channels-1
+  uint32_t rangeStart[FSEQ_MAX_RANGES];
+  uint32_t rangeLen[FSEQ_MAX_RANGES];
+
+  static uint32_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+  static uint32_t get24(const uint8_t* p) { return p[0] | (p[1] << 8) | (uint32_t(p[2]) << 16); }
+  static uint32_t get32(const uint8_t* p) { return get24(p) | (uint32_t(p[3]) << 24); }
+
+  // fixed part (FSEQ_FIXED_HEADER bytes); returns nullptr or the reason why we cannot play the file
+  const char* parse(const uint8_t* h, size_t len) {
+    if (len < FSEQ_FIXED_HEADER || h[0] != 'P' || h[1] != 'S' || h[2] != 'E' || h[3] != 'Q') return "not an fseq file";
+    dataOffset  = get16(h+4);
+    minor       = h[6];
+    major       = h[7];
+    channels    = get32(h+10);
+    frames      = get32(h+14);
+    stepMs      = h[18];
+    compression = h[20] & 0x0F;
+    blocks      = h[21] | ((h[20] & 0xF0) << 4);
+    ranges      = h[22];
+    if (major != 2) return "only fseq version 2 is supported";
+    if (compression == FSEQ_COMPRESS_ZLIB) return "zlib compressed fseq - please export with zstd or uncompressed";
+    #ifdef WLED_ENABLE_FSEQ_ZSTD
+    if (compression > FSEQ_COMPRESS_ZLIB) return "unknown compression";
+    if (compression == FSEQ_COMPRESS_ZSTD && blocks == 0) return "broken header";
+    #else
+    if (compression != FSEQ_COMPRESS_NONE) return "compressed fseq - please export uncompressed";
+    #endif
+    if (stepMs == 0 || channels == 0 || frames == 0) return "empty sequence";
+    if (ranges > FSEQ_MAX_RANGES) return "too many sparse ranges";
+    if (rangeTableOffset() + ranges * 6 > dataOffset) return "broken header";
+    return nullptr;
+  }
+
+  size_t rangeTableOffset() const { return FSEQ_FIXED_HEADER + blocks * 8; }
+
+  // sparse range table (ranges * 6 bytes, read from rangeTableOffset())
+  const char* parseRanges(const uint8_t* r) {
+    uint32_t total = 0;
+    for (unsigned i = 0; i < ranges; i++) {
+      rangeStart[i] = get24(r + i*6);
+      rangeLen[i]   = get24(r + i*6 + 3);
+      total += rangeLen[i];
+    }
+    if (ranges > 0 && total != channels) return "sparse ranges don't match frame size";
+    return nullptr;
+  }
+
+  uint32_t frameOffset(uint32_t frame) const { return dataOffset + frame * channels; }
+
+  // one entry of the compression block table (8 bytes each, from FSEQ_FIXED_HEADER on); "next" is the file position
+  // of this block's data, advanced to the next block. Returns false for unused entries.
+  bool parseBlock(const uint8_t* e, FseqBlock& b, uint32_t& next) const {
+    b.frame  = get32(e);
+    b.len    = get32(e + 4);
+    b.offset = next;
+    next += b.len;
+    return b.len > 0;
+  }
+
+  // block table sanity: starts with frame 0, frames ascending and in range
+  const char* checkBlocks(const FseqBlock* b, size_t count) const {
+    if (count == 0 || b[0].frame != 0) return "broken compression block table";
+    for (size_t i = 1; i < count; i++) if (b[i].frame <= b[i-1].frame || b[i].frame >= frames) return "broken compression block table";
+    return nullptr;
+  }
+
+  // block that holds a frame (binary search)
+  static size_t findBlock(const FseqBlock* b, size_t count, uint32_t frame) {
+    size_t lo = 0, hi = count;
+    while (hi - lo > 1) {
+      size_t mid = (lo + hi) / 2;
+      if (b[mid].frame <= frame) lo = mid; else hi = mid;
+    }
+    return lo;
+  }
+
+  // calls pixel(index, r, g, b) for all complete RGB triples in a frame; channel = first channel of pixel 0
+  template<typename PixelFn>
+  void forEachPixel(const uint8_t* frame, uint32_t channel, PixelFn pixel) const {
+    unsigned n = ranges ? ranges : 1;
+    for (unsigned r = 0; r < n; r++) {
+      uint32_t start = ranges ? rangeStart[r] : 0;
+      uint32_t len   = ranges ? rangeLen[r]   : channels;
+      const uint8_t* d = frame;
+      frame += len;
+      if (start + len <= channel) continue;
+      if (start < channel) { d += channel - start; len -= channel - start; start = channel; }
+      start -= channel;
+      uint32_t skip = (3 - start % 3) % 3; // range starts inside a pixel
+      if (skip >= len) continue;
+      d += skip; start += skip; len -= skip;
+      for (uint32_t c = 0; c + 3 <= len; c += 3, d += 3) pixel((start + c) / 3, d[0], d[1], d[2]);
+    }
+  }
+};
+
+#ifdef WLED_ENABLE_FSEQ_ZSTD
+// streams the frames of one compression block after the other; fill(buf, max) returns compressed bytes from the
+// current file position. Restart at a block to go back, or to jump to another block.
+class FseqZstd {
+  public:
+    ~FseqZstd() { end(); }
+
+    bool begin(ZSTD_customMem mem, int windowLogMax) {
+      end();
+      _ds = ZSTD_createDStream_advanced(mem);
+      if (_ds) ZSTD_DCtx_setParameter(_ds, ZSTD_d_windowLogMax, windowLogMax); // refuse blocks that need a bigger window
+      return _ds != nullptr;
+    }
+
+    void end() {
+      if (_ds) ZSTD_freeDStream(_ds);
+      _ds = nullptr;
+    }
+
+    void restart(uint32_t compressedLen) {
+      ZSTD_DCtx_reset(_ds, ZSTD_reset_session_only);
+      _left = compressedLen;
+      _in.src = _buf; _in.size = 0; _in.pos = 0;
+    }
+
+    // exactly len bytes of decompressed data; returns nullptr or an error
+    template<typename FillFn>
+    const char* read(uint8_t* out, size_t len, FillFn fill) {
+      if (!_ds) return "no zstd decoder";
+      ZSTD_outBuffer o = {out, len, 0};
+      while (o.pos < o.size) {
+        if (_in.pos == _in.size && _left > 0) {
+          size_t n = fill(_buf, _left < sizeof(_buf) ? _left : sizeof(_buf));
+          if (n == 0) return "read error";
+          _left -= n;
+          _in.size = n; _in.pos = 0;
+        }
+        size_t inBefore = _in.pos, outBefore = o.pos;
+        size_t r = ZSTD_decompressStream(_ds, &o, &_in);
+        if (ZSTD_isError(r)) return ZSTD_getErrorName(r);
+        if (o.pos < o.size && (r == 0 || (_in.pos == _in.size && _left == 0 && o.pos == outBefore && _in.pos == inBefore)))
+          return "compression block is shorter than its frames"; // block ended, or no input left and no progress
+      }
+      return nullptr;
+    }
+
+  private:
+    ZSTD_DStream* _ds = nullptr;
+    ZSTD_inBuffer _in = {nullptr, 0, 0};
+    uint32_t _left = 0;         // compressed bytes of the block not read yet
+    uint8_t  _buf[512];
+};
+#endif
+
+#endif
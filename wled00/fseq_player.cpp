@@ -0,0 +1,347 @@
+#include "wled.h"
+
+/*
+ * WLEDMM .fseq player - plays precomputed shows from LittleFS or SD without a network feed
+ *
+ * {"fseq":{"file":"/show.fseq","loop":true,"sync":false}} starts, {"fseq":{"stop":true}} stops playback.
+ * Files starting with "/sd/" are read from the SD card (WLED_USE_SD_MMC or WLED_USE_SD_SPI).
+ * Channel 0 of the sequence is the red channel of pixel 0 (+ DMX start address); only RGB pixels.
+ *
+ * A reader (own task on ESP32, main loop on ESP8266) reads ahead into two frame buffers; the main loop shows
+ * the frame that is due at the file's step time - or at the show sequencer's position with "sync":true.
+ * RAM use is two frames, independent of the sequence length.
+ * zstd compressed files (WLED_ENABLE_FSEQ_ZSTD) are decompressed by the reader, block by block: frames are
+ * streamed in order, going back or jumping restarts at the block that holds the wanted frame. The decoder needs
+ * its window on top (up to 2^FSEQ_ZSTD_WINDOW_LOG bytes), so PSRAM is recommended.
+ *
+ * Reader and main loop hand the file over with fseqState:
+ *   loop: OPEN -> reader: HEADER (or ERROR) -> loop: PLAY (buffers allocated) -> loop: CLOSE -> reader: CLOSED -> loop: IDLE
+ */
+#ifdef WLED_ENABLE_FSEQ
+
+#include "fseq.h"
+
+#ifndef FSEQ_MAX_FRAME
+#define FSEQ_MAX_FRAME (MAX_LEDS * 3)  // bytes per frame
+#endif
+#ifndef FSEQ_ZSTD_WINDOW_LOG
+  #if defined(BOARD_HAS_PSRAM)
+  #define FSEQ_ZSTD_WINDOW_LOG 20      // 1MB - xLights' default compression level stays below
+  #else
+  #define FSEQ_ZSTD_WINDOW_LOG 16
+  #endif
+#endif
+
+#define FSEQ_IDLE    0
+#define FSEQ_OPEN    1
+#define FSEQ_HEADER  2
+#define FSEQ_PLAY    3
+#define FSEQ_CLOSE   4
+#define FSEQ_CLOSED  5
+#define FSEQ_ERROR   6
+
+static volatile uint8_t fseqState = FSEQ_IDLE;
+static FseqHeader fseqHdr;                 // written by the reader before FSEQ_HEADER
+static const char* fseqError = nullptr;
+static File       fseqFile;                // reader only
+static char       fseqPath[33] = {'\0'};   // file being opened / played
+static char       fseqPending[33] = {'\0'};
+static volatile bool fseqStopReq = false;
+static bool       fseqLoop = false;
+static bool       fseqSync = false;
+
+static uint8_t*   fseqBuf[2] = {nullptr, nullptr};
+static volatile int32_t fseqBufFrame[2] = {-1, -1}; // frame in buffer, -1 = free (reader may fill it)
+static volatile uint32_t fseqDue = 0;      // frame the loop wants now
+static int32_t    fseqShown = -1;
+static unsigned long fseqStartMs = 0;
+static uint32_t   fseqFramesShown = 0, fseqFramesMissed = 0;
+
+#ifdef WLED_ENABLE_FSEQ_ZSTD
+static FseqZstd   fseqZstd;                // reader only
+static FseqBlock* fseqBlocks = nullptr;    // compression block index, reader only
+static uint16_t   fseqBlockCount = 0;
+static uint16_t   fseqZBlock = 0;          // block the decoder is in
+static int32_t    fseqZNext = -1;          // next frame the decoder delivers, -1 = no block open
+
+static void* fseqZstdAlloc(void*, size_t size) { return tieredMalloc(size, WLED_MEM_WARM, "fseq zstd"); }
+static void  fseqZstdFree(void*, void* ptr) { free(ptr); }
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+static TaskHandle_t fseqTask = nullptr;
+static portMUX_TYPE fseqMux = portMUX_INITIALIZER_UNLOCKED;
+#define FSEQ_LOCK()   portENTER_CRITICAL(&fseqMux)
+#define FSEQ_UNLOCK() portEXIT_CRITICAL(&fseqMux)
+#else
+#define FSEQ_LOCK()
+#define FSEQ_UNLOCK()
+#endif
+
+// frame distance from the due frame (wraps when looping), negative = already late
+static int32_t fseqAhead(int32_t frame, uint32_t due) {
+  if (!fseqLoop) return frame - int32_t(due);
+  int32_t d = (frame + fseqHdr.frames - due) % fseqHdr.frames;
+  return (d > int32_t(fseqHdr.frames / 2)) ? d - int32_t(fseqHdr.frames) : d;
+}
+
+#ifdef WLED_ENABLE_FSEQ_ZSTD
+// reader: block table and decoder of a compressed file; returns nullptr or an error
+static const char* fseqOpenCompressed() {
+  fseqBlocks = (FseqBlock*) tieredMalloc(fseqHdr.blocks * sizeof(FseqBlock), WLED_MEM_COLD, "fseq blocks");
+  if (!fseqBlocks) return "not enough memory for the block table";
+  if (!fseqFile.seek(FSEQ_FIXED_HEADER)) return "file too short";
+  uint32_t next = fseqHdr.dataOffset;
+  fseqBlockCount = 0;
+  for (unsigned i = 0; i < fseqHdr.blocks; i++) {
+    uint8_t e[8];
+    if (fseqFile.read(e, 8) != 8) return "file too short";
+    if (fseqHdr.parseBlock(e, fseqBlocks[fseqBlockCount], next)) fseqBlockCount++;
+  }
+  const char* err = fseqHdr.checkBlocks(fseqBlocks, fseqBlockCount);
+  if (err) return err;
+  if (next > fseqFile.size()) return "file too short";
+  ZSTD_customMem mem = {fseqZstdAlloc, fseqZstdFree, nullptr};
+  if (!fseqZstd.begin(mem, FSEQ_ZSTD_WINDOW_LOG)) return "not enough memory for the zstd decoder";
+  fseqZNext = -1;
+  return nullptr;
+}
+
+static void fseqCloseCompressed() {
+  fseqZstd.end();
+  if (fseqBlocks) free(fseqBlocks);
+  fseqBlocks = nullptr;
+  fseqBlockCount = 0;
+  fseqZNext = -1;
+}
+#endif
+
+// reader: one frame into out
+static const char* fseqReadFrame(uint32_t frame, uint8_t* out) {
+  #ifdef WLED_ENABLE_FSEQ_ZSTD
+  if (fseqHdr.compression == FSEQ_COMPRESS_ZSTD) {
+    size_t blk = FseqHeader::findBlock(fseqBlocks, fseqBlockCount, frame);
+    if (fseqZNext < 0 || blk != fseqZBlock || uint32_t(fseqZNext) > frame) {
+      if (!fseqFile.seek(fseqBlocks[blk].offset)) return "read error";
+      fseqZstd.restart(fseqBlocks[blk].len);
+      fseqZBlock = blk;
+      fseqZNext = fseqBlocks[blk].frame;
+    }
+    while (uint32_t(fseqZNext) <= frame) { // frames before the wanted one are decoded into out and dropped
+      const char* err = fseqZstd.read(out, fseqHdr.channels, [](uint8_t* buf, size_t len) -> size_t { return fseqFile.read(buf, len); });
+      if (err) { fseqZNext = -1; return err; }
+      fseqZNext++;
+    }
+    return nullptr;
+  }
+  #endif
+  if (!fseqFile.seek(fseqHdr.frameOffset(frame)) || fseqFile.read(out, fseqHdr.channels) != int(fseqHdr.channels)) return "read error";
+  return nullptr;
+}
+
+// reader: open the file, then keep both buffers filled with the next frames
+static void fseqReaderStep() {
+  switch (fseqState) {
+    case FSEQ_OPEN: {
+      uint8_t h[FSEQ_FIXED_HEADER + FSEQ_MAX_RANGES * 6];
+      fseqFile = openMediaFile(fseqPath, "r");
+      fseqError = fseqFile ? nullptr : "file not found";
+      if (!fseqError && fseqFile.read(h, FSEQ_FIXED_HEADER) != FSEQ_FIXED_HEADER) fseqError = "file too short";
+      if (!fseqError) fseqError = fseqHdr.parse(h, FSEQ_FIXED_HEADER);
+      if (!fseqError && fseqHdr.channels > FSEQ_MAX_FRAME) fseqError = "frames are bigger than FSEQ_MAX_FRAME";
+      if (!fseqError && fseqHdr.ranges > 0) {
+        if (!fseqFile.seek(fseqHdr.rangeTableOffset()) || fseqFile.read(h, fseqHdr.ranges * 6) != int(fseqHdr.ranges * 6)) fseqError = "file too short";
+        else fseqError = fseqHdr.parseRanges(h);
+      }
+      #ifdef WLED_ENABLE_FSEQ_ZSTD
+      if (!fseqError && fseqHdr.compression == FSEQ_COMPRESS_ZSTD) fseqError = fseqOpenCompressed();
+      if (fseqError) fseqCloseCompressed();
+      #endif
+      if (fseqError && fseqFile) fseqFile.close();
+      fseqState = fseqError ? FSEQ_ERROR : FSEQ_HEADER;
+      break;
+    }
+    case FSEQ_PLAY: {
+      for (unsigned b = 0; b < 2 && fseqState == FSEQ_PLAY; b++) {
+        if (fseqBufFrame[b] >= 0) continue;
+        // earliest frame from "due" on that is not in the other buffer
+        uint32_t due = fseqDue;
+        uint32_t want = due;
+        int32_t other = fseqBufFrame[1-b];
+        if (other >= 0 && fseqAhead(other, due) >= 0) want = other + 1;
+        if (want >= fseqHdr.frames) {
+          if (!fseqLoop) continue;
+          want = 0;
+        }
+        const char* err = fseqReadFrame(want, fseqBuf[b]);
+        if (err) {
+          fseqError = err;
+          fseqState = FSEQ_CLOSE; // main loop reports the error when closed
+          break;
+        }
+        fseqBufFrame[b] = want;
+      }
+      break;
+    }
+    case FSEQ_CLOSE:
+      if (fseqFile) fseqFile.close();
+      #ifdef WLED_ENABLE_FSEQ_ZSTD
+      fseqCloseCompressed();
+      #endif
+      fseqState = FSEQ_CLOSED;
+      break;
+  }
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+static void fseqReaderTask(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10)); // woken by the loop after a frame was shown
+    fseqReaderStep();
+  }
+}
+#endif
+
+static void fseqWakeReader() {
+  #ifdef ARDUINO_ARCH_ESP32
+  if (fseqTask) xTaskNotifyGive(fseqTask);
+  #else
+  fseqReaderStep();
+  #endif
+}
+
+static void fseqFreeBuffers() {
+  for (unsigned b = 0; b < 2; b++) {
+    if (fseqBuf[b]) free(fseqBuf[b]);
+    fseqBuf[b] = nullptr;
+    fseqBufFrame[b] = -1;
+  }
+}
+
+static void fseqShow(uint8_t* frame) {
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_FSEQ);
+  if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
+  pixel_index_t totalLen = strip.getLengthTotal();
+  fseqHdr.forEachPixel(frame, DMXAddress > 0 ? DMXAddress - 1 : 0, [totalLen](uint32_t i, uint8_t r, uint8_t g, uint8_t b) {
+    if (i < totalLen) setRealtimePixel(i, r, g, b, 0);
+  });
+  if (!(realtimeMode && useMainSegmentOnly)) strip.show();
+}
+
+// main loop
+void handleFseqPlayer() {
+  switch (fseqState) {
+    case FSEQ_IDLE: {
+      FSEQ_LOCK();
+      bool start = fseqPending[0] != '\0';
+      if (start) { strcpy(fseqPath, fseqPending); fseqPending[0] = '\0'; }
+      FSEQ_UNLOCK();
+      fseqStopReq = false;
+      if (!start) return;
+      #ifdef ARDUINO_ARCH_ESP32
+      #ifdef WLED_ENABLE_FSEQ_ZSTD
+      if (!fseqTask) xTaskCreatePinnedToCore(fseqReaderTask, "fseqReader", 6144, nullptr, 2, &fseqTask, 0); // zstd needs more stack
+      #else
+      if (!fseqTask) xTaskCreatePinnedToCore(fseqReaderTask, "fseqReader", 3072, nullptr, 2, &fseqTask, 0);
+      #endif
+      #endif
+      fseqState = FSEQ_OPEN;
+      fseqWakeReader();
+      return;
+    }
+    case FSEQ_ERROR:
+      USER_PRINTF("FSEQ: %s - %s.\n", fseqPath, fseqError);
+      fseqState = FSEQ_IDLE;
+      return;
+    case FSEQ_HEADER:
+      for (unsigned b = 0; b < 2; b++) fseqBuf[b] = (uint8_t*) tieredMalloc(fseqHdr.channels, WLED_MEM_WARM, "fseq frames");
+      if (!fseqBuf[0] || !fseqBuf[1]) {
+        fseqFreeBuffers();
+        errorFlag = ERR_LOW_MEM;
+        fseqState = FSEQ_CLOSE;
+        fseqWakeReader();
+        return;
+      }
+      USER_PRINTF("FSEQ: playing %s, %u frames of %u channels, %u ms.\n", fseqPath, fseqHdr.frames, fseqHdr.channels, fseqHdr.stepMs);
+      fseqDue = 0;
+      fseqShown = -1;
+      fseqError = nullptr;
+      fseqFramesShown = fseqFramesMissed = 0;
+      fseqStartMs = millis();
+      fseqState = FSEQ_PLAY;
+      fseqWakeReader();
+      return;
+    case FSEQ_CLOSE:
+      fseqWakeReader();
+      return;
+    case FSEQ_CLOSED:
+      if (fseqError) USER_PRINTF("FSEQ: %s - %s.\n", fseqPath, fseqError);
+      fseqFreeBuffers();
+      if (realtimeMode == REALTIME_MODE_FSEQ) exitRealtime();
+      fseqState = FSEQ_IDLE;
+      return;
+    case FSEQ_PLAY:
+      break;
+    default:
+      return;
+  }
+
+  // playing
+  bool stop = fseqStopReq || (fseqPending[0] != '\0');
+  int64_t pos = millis() - fseqStartMs;
+  #ifdef WLED_ENABLE_SEQUENCER
+  if (fseqSync) pos = sequencerPosition(); // -1 = sequencer stopped, hold the last frame
+  #endif
+  if (!stop && pos < 0) return;
+  uint32_t due = pos / fseqHdr.stepMs;
+  if (due >= fseqHdr.frames) {
+    if (fseqLoop) due %= fseqHdr.frames;
+    else stop = !fseqSync;
+  }
+  if (stop) {
+    fseqState = FSEQ_CLOSE;
+    fseqWakeReader();
+    return;
+  }
+  if (int32_t(due) == fseqShown || due >= fseqHdr.frames) return;
+  fseqDue = due;
+
+  int shown = -1;
+  for (unsigned b = 0; b < 2; b++) {
+    int32_t frame = fseqBufFrame[b];
+    if (frame < 0) continue;
+    int32_t ahead = fseqAhead(frame, due);
+    if (ahead == 0) { fseqShow(fseqBuf[b]); shown = b; }
+    if (ahead <= 0) fseqBufFrame[b] = -1; // shown or too late - reader may refill
+  }
+  if (shown >= 0) {
+    if (fseqShown >= 0 && fseqAhead(due, fseqShown) > 1) fseqFramesMissed += fseqAhead(due, fseqShown) - 1;
+    fseqShown = due;
+    fseqFramesShown++;
+  }
+  fseqWakeReader();
+}
+
+// {"fseq":{...}} in a JSON state request - may run in async_tcp context
+void deserializeFseq(JsonObject fseq) {
+  if (fseq[F("stop")] | false) fseqStopReq = true;
+  const char* file = fseq[F("file")];
+  if (file && file[0] == '/') {
+    fseqLoop = fseq[F("loop")] | false;
+    fseqSync = fseq[F("sync")] | false;
+    FSEQ_LOCK();
+    strlcpy(fseqPending, file, sizeof(fseqPending));
+    FSEQ_UNLOCK();
+  }
+}
+
+void serializeFseq(JsonObject fseq) {
+  bool playing = (fseqState == FSEQ_PLAY);
+  fseq[F("file")] = playing ? fseqPath : "";
+  fseq[F("frame")] = fseqShown;
+  fseq[F("frames")] = playing ? fseqHdr.frames : 0;
+  fseq[F("shown")] = fseqFramesShown;
+  fseq[F("missed")] = fseqFramesMissed; // frames the reader could not deliver in time
+}
+
+#endif
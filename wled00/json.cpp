@@ -69,7 +69,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   #ifndef WLED_DISABLE_2D
     // Serial.printf("before %d: %s %s %s %s\n", id, elem["start"].as<std::string>().c_str(), elem["stop"].as<std::string>().c_str(), elem["startY"].as<std::string>().c_str(), elem["stopY"].as<std::string>().c_str());
   if (strip.isMatrix && !elem["start"].isNull() && !elem["stop"].isNull() && elem["startY"].isNull() && elem["stopY"].isNull()) {
-    uint16_t start1=elem["start"], stop1=elem["stop"];
+    pixel_index_t start1=elem["start"], stop1=elem["stop"];
     elem["start"] = start1%Segment::maxWidth;
     elem["startY"]= Segment::maxWidth?(start1 / Segment::maxWidth):0;
     elem["stop"] = (stop1-1)%Segment::maxWidth + 1;
@@ -104,7 +104,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   Segment& seg = strip.getSegment(id);
   Segment prev = seg; //make a backup so we can tell if something changed // WLEDMM fixMe: copy constructor = waste of memory
 
-  uint16_t start = elem["start"] | seg.start;
+  pixel_index_t start = elem["start"] | seg.start;
   if (stop < 0) {
     int len = elem["len"]; // WLEDMM bugfix for broken presets with len < 0
     stop = (len > 0) ? start + len : seg.stop;
@@ -119,7 +119,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
     elem.remove("id");  // remove for recursive call
     elem.remove("rpt"); // remove for recursive call
     elem.remove("n");   // remove for recursive call
-    uint16_t len = (stop >= start) ? (stop - start) : 0;  // WLEDMM stop < 1 is allowed, so we need to avoid underflow
+    pixel_index_t len = (stop >= start) ? (stop - start) : 0;  // WLEDMM stop < 1 is allowed, so we need to avoid underflow
     for (size_t i=id+1; i<strip.getMaxSegments(); i++) {
       start = start + len;
       if (start >= strip.getLengthTotal()) break;
@@ -176,6 +176,9 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
 
   seg.map1D2D  = constrain(map1D2D, 0, 7);
   seg.soundSim = constrain(soundSim, 0, 1);
+  #ifdef WLEDMM_LAYER_COMPOSITOR
+  seg.blendMode = elem["bm"] | seg.blendMode;  // WLEDMM unknown modes are blended as "normal"
+  #endif
 
   uint8_t set = elem[F("set")] | seg.set;
   seg.set = constrain(set, 0, 3);
@@ -610,6 +613,19 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   }
 
   doAdvancePlaylist = root[F("np")] | doAdvancePlaylist; //advances to next preset in playlist when true
+
+  #ifdef WLED_ENABLE_SEQUENCER
+  JsonObject seq = root[F("seq")];
+  if (!seq.isNull()) deserializeSequencer(seq); // WLEDMM show sequencer
+  #endif
+  #ifdef WLED_ENABLE_FSEQ
+  JsonObject fseq = root[F("fseq")];
+  if (!fseq.isNull()) deserializeFseq(fseq);    // WLEDMM .fseq player
+  #endif
+  #ifdef WLED_ENABLE_RTREC
+  JsonObject rtrec = root[F("rtrec")];
+  if (!rtrec.isNull()) deserializeRtRecorder(rtrec); // WLEDMM realtime stream recorder
+  #endif
   
   stateUpdated(callMode);
   if (presetToRestore) currentPreset = presetToRestore;
@@ -688,6 +704,9 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
   root["o3"]  = seg.check3;
   root["si"]  = seg.soundSim;
   root["m12"] = seg.map1D2D;
+  #ifdef WLEDMM_LAYER_COMPOSITOR
+  root["bm"]  = seg.blendMode;
+  #endif
 }
 
 void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool selectedSegmentsOnly)
@@ -735,6 +754,18 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
 
     root["ps"] = (currentPreset > 0) ? currentPreset : -1;
     root[F("pl")] = currentPlaylist;
+    #ifdef WLED_ENABLE_SEQUENCER
+    JsonObject seq = root.createNestedObject(F("seq"));
+    serializeSequencer(seq);
+    #endif
+    #ifdef WLED_ENABLE_FSEQ
+    JsonObject fseq = root.createNestedObject(F("fseq"));
+    serializeFseq(fseq);
+    #endif
+    #ifdef WLED_ENABLE_RTREC
+    JsonObject rtrec = root.createNestedObject(F("rtrec"));
+    serializeRtRecorder(rtrec);
+    #endif
 
     usermods.addToJsonState(root);
 
@@ -976,6 +1007,8 @@ void serializeInfo(JsonObject root)
     case REALTIME_MODE_TPM2NET:  root["lm"] = F("tpm2.net"); break;
     case REALTIME_MODE_DDP:      root["lm"] = F("DDP"); break;
     case REALTIME_MODE_DMX:      root["lm"] = F("DMX"); break;
+    case REALTIME_MODE_ESPNOW:   root["lm"] = F("ESP-NOW"); break;
+    case REALTIME_MODE_FSEQ:     root["lm"] = F("FSEQ"); break;
   }
 
   if (realtimeIP[0] == 0)
@@ -1070,6 +1103,12 @@ void serializeInfo(JsonObject root)
   root[F("getflash")] = ESP.getFlashChipSize(); //WLEDMM and Athom, works for both ESP32 and ESP8266
 
   root[F("freeheap")] = ESP.getFreeHeap();
+  JsonObject jbuf = root.createNestedObject(F("jbuf")); // WLEDMM JSON buffer usage
+  serializeJSONBufferStats(jbuf);
+  #ifdef WLEDMM_SEGMENT_ARENA
+  JsonObject jarena = root.createNestedObject(F("segarena")); // WLEDMM segment arena usage and fragmentation
+  serializeSegmentArena(jarena);
+  #endif
   //WLEDMM: conditional on esp32
   #if defined(ARDUINO_ARCH_ESP32)
     root[F("freestack")] = uxTaskGetStackHighWaterMark(NULL); //WLEDMM
@@ -1412,17 +1451,30 @@ void serializeNodes(JsonObject root)
   }
 }
 
+// WLEDMM copies the name (without @ extensions) or the fxdata part of one effect into lineBuffer
+// returns false for unused mode slots, which are not listed
+static bool getModeEntry(uint8_t mode, bool fxdata, char* lineBuffer, size_t bufSize) {
+  const char* data = strip.getModeData(mode);
+  size_t nameLen = strip.getModeNameLen(mode); // WLEDMM precomputed - no need to search for '@'
+  if (nameLen == 0) return false;
+  if (fxdata) {
+    lineBuffer[0] = 0;
+    if (pgm_read_byte(data + nameLen) == '@') strncpy_P(lineBuffer, data + nameLen + 1, bufSize-1);
+    lineBuffer[bufSize-1] = 0;
+  } else {
+    nameLen = min(nameLen, bufSize-1);
+    strncpy_P(lineBuffer, data, nameLen);
+    lineBuffer[nameLen] = 0; // terminate mode data after name
+  }
+  return true;
+}
+
 // deserializes mode data string into JsonArray
 void serializeModeData(JsonArray fxdata)
 {
   char lineBuffer[192] = { 0 };
   for (size_t i = 0; i < strip.getModeCount(); i++) {
-    strncpy_P(lineBuffer, strip.getModeData(i), sizeof(lineBuffer)-1);
-    if (lineBuffer[0] != 0) {
-      char* dataPtr = strchr(lineBuffer,'@');
-      if (dataPtr) fxdata.add(dataPtr+1);
-      else         fxdata.add("");
-    }
+    if (getModeEntry(i, true, lineBuffer, sizeof(lineBuffer))) fxdata.add(lineBuffer);
   }
 }
 
@@ -1431,39 +1483,233 @@ void serializeModeData(JsonArray fxdata)
 void serializeModeNames(JsonArray arr) {
   char lineBuffer[192] = { 0 };
   for (size_t i = 0; i < strip.getModeCount(); i++) {
-    strncpy_P(lineBuffer, strip.getModeData(i), sizeof(lineBuffer)-1);
-    if (lineBuffer[0] != 0) {
-      char* dataPtr = strchr(lineBuffer,'@');
-      if (dataPtr) *dataPtr = 0; // terminate mode data after name
-      arr.add(lineBuffer);
-    }
+    if (getModeEntry(i, false, lineBuffer, sizeof(lineBuffer))) arr.add(lineBuffer);
   }
 }
 
-// Global buffer locking response helper class (to make sure lock is released when AsyncJsonResponse is destroyed)
+// Leased buffer response helper class (to make sure the JSON document is returned when AsyncJsonResponse is destroyed)
 class LockedJsonResponse: public AsyncJsonResponse {
-  bool _holding_lock;
+  JSONBufferLease _lease;
   public:
-  // WARNING: constructor assumes requestJSONBufferLock() was successfully acquired externally/prior to constructing the instance
-  // Not a good practice with C++. Unfortunately AsyncJsonResponse only has 2 constructors - for dynamic buffer or existing buffer,
+  // WARNING: constructor assumes the lease was successfully acquired (check before constructing the instance)
+  // Unfortunately AsyncJsonResponse only has 2 constructors - for dynamic buffer or existing buffer,
   // with existing buffer it clears its content during construction
-  // if the lock was not acquired (using JSONBufferGuard class) previous implementation still cleared existing buffer
-  inline LockedJsonResponse(JsonDocument* doc, bool isArray) : AsyncJsonResponse(doc, isArray), _holding_lock(true) {};
+  inline LockedJsonResponse(JSONBufferLease&& lease, bool isArray) : AsyncJsonResponse(lease.doc(), isArray), _lease(std::move(lease)) {};
 
   virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) { 
     size_t result = AsyncJsonResponse::_fillBuffer(buf, maxLen);
-    // Release lock as soon as we're done filling content
-    if (((result + _sentLength) >= (_contentLength)) && _holding_lock) {
-      releaseJSONBufferLock();
-      _holding_lock = false;
-    }
+    // Return the document as soon as we're done filling content
+    if ((result + _sentLength) >= (_contentLength)) _lease.release();
     return result;
   }
 
-  // destructor will remove JSON buffer lock when response is destroyed in AsyncWebServer
-  virtual ~LockedJsonResponse() { if (_holding_lock) releaseJSONBufferLock(); };
+  // lease destructor returns the JSON document when response is destroyed in AsyncWebServer
+  virtual ~LockedJsonResponse() {};
 };
 
+// WLEDMM FNV-1a hash of serialized JSON, computed without a buffer
+class JsonHashPrint : public Print {
+  public:
+    uint32_t hash = 2166136261UL;
+    size_t write(uint8_t c) override { hash = (hash ^ c) * 16777619UL; return 1; }
+    size_t write(const uint8_t *buf, size_t len) override { for (size_t i = 0; i < len; i++) write(buf[i]); return len; }
+};
+
+uint32_t hashJson(JsonVariantConst v) {
+  JsonHashPrint h;
+  serializeJson(v, h);
+  return h.hash;
+}
+
+// WLEDMM /json/state is serialized once per state revision and re-used for all clients.
+// The ETag is the content hash, so pollers get "304 Not Modified" until something visible changes.
+#define STATE_CACHE_MAX_AGE 2000 // ms - re-check content after this time (usermod data and timers don't bump stateRevision)
+
+static String   stateCache;
+static uint32_t stateCacheRev  = 0;   // stateRevision at time of serialization, 0 = invalid
+static uint32_t stateCacheHash = 0;
+static unsigned long stateCacheTime = 0;
+
+static void serveStateCached(AsyncWebServerRequest* request)
+{
+  // all web requests run in the async_tcp task - no locking needed for the cache
+  if (stateCacheRev != stateRevision || nightlightActive || (millis() - stateCacheTime > STATE_CACHE_MAX_AGE)) {
+    JSONBufferLease lease(17);
+    if (!lease) {
+      request->send(503, "application/json", F("{\"error\":3}"));
+      return;
+    }
+    uint32_t rev = stateRevision;
+    JsonObject state = lease.doc()->to<JsonObject>();
+    serializeState(state);
+    stateCache = String(); // free old content first
+    stateCache.reserve(measureJson(*lease.doc()) + 1);
+    serializeJson(*lease.doc(), stateCache);
+    stateCacheHash = hashJson(state);
+    stateCacheRev  = state.containsKey(F("error")) ? 0 : rev; // error is reported only once
+    stateCacheTime = millis();
+  }
+
+  char etag[12];
+  snprintf_P(etag, sizeof(etag), PSTR("\"%08x\""), stateCacheHash);
+  AsyncWebHeader* header = request->getHeader("If-None-Match");
+  if (header && header->value() == etag) {
+    request->send(304);
+    return;
+  }
+  AsyncWebServerResponse *response = request->beginResponse(200, "application/json", stateCache); // copy - cache may be replaced while sending
+  response->addHeader(F("Cache-Control"), F("no-cache")); // revalidate with If-None-Match
+  response->addHeader(F("ETag"), etag);
+  request->send(response);
+}
+
+// WLEDMM streaming JSON writer for /json, /json/si, /json/info, /json/eff and /json/fxdata
+// Output is produced section by section while the response is sent, so there is no DOM for the whole
+// response and no JSON document is held until the last byte is out. State and info are serialized
+// with a short-lived JSON document lease; effect names, fxdata and palettes are written item by item.
+#define JSON_STREAM_PAL_CHUNK 256 // bytes produced per step for palettes and effect lists
+
+class JsonStreamer {
+  public:
+    JsonStreamer(byte subJson) {
+      switch (subJson) {
+        case JSON_PATH_INFO:       add(S_INFO); break;
+        case JSON_PATH_EFFECTS:    add(S_EFFECTS); break;
+        case JSON_PATH_FXDATA:     add(S_FXDATA); break;
+        case JSON_PATH_STATE_INFO: add(S_OPEN_STATE); add(S_STATE); add(S_OPEN_INFO); add(S_INFO); add(S_CLOSE); break;
+        default:                   add(S_OPEN_STATE); add(S_STATE); add(S_OPEN_INFO); add(S_INFO);
+                                   add(S_OPEN_EFFECTS); add(S_EFFECTS); add(S_OPEN_PALETTES); add(S_PALETTES); add(S_CLOSE); break;
+      }
+    }
+
+    // fill the response buffer, returns 0 when done, RESPONSE_TRY_AGAIN while the JSON buffer is locked by a writer
+    size_t fill(uint8_t* buf, size_t maxLen) {
+      size_t len = 0;
+      while (len < maxLen) {
+        if (_pendingPos < _pending.length()) {
+          size_t n = min(maxLen - len, _pending.length() - _pendingPos);
+          memcpy(buf + len, _pending.c_str() + _pendingPos, n);
+          len += n; _pendingPos += n;
+          continue;
+        }
+        _pending = String(); _pendingPos = 0;
+        if (_section >= _numSections) break; // all sections done
+        if (!produce()) return len > 0 ? len : RESPONSE_TRY_AGAIN; // never block async_tcp - AsyncWebServer calls again
+      }
+      return len;
+    }
+
+  private:
+    enum Section : uint8_t { S_OPEN_STATE, S_STATE, S_OPEN_INFO, S_INFO, S_OPEN_EFFECTS, S_EFFECTS, S_FXDATA, S_OPEN_PALETTES, S_PALETTES, S_CLOSE };
+    Section  _sections[10];
+    uint8_t  _numSections = 0;
+    uint8_t  _section = 0;
+    uint16_t _item = 0;      // effect index, or palette string offset / JSON_STREAM_PAL_CHUNK
+    uint16_t _written = 0;   // items in current array
+    bool     _opened = false; // array of current section started
+    String   _pending;
+    size_t   _pendingPos = 0;
+    unsigned long _lockWait = 0; // first failed attempt to lease a JSON document, 0 = none
+
+    void add(Section s) { _sections[_numSections++] = s; }
+    void next() { _section++; _item = 0; }
+
+    // serialize state or info with a short-lived JSON document, returns false if that has to be retried later
+    bool produceDOM(bool info) {
+      JSONBufferLease lease(17, false);
+      if (!lease) {
+        if (_lockWait == 0) _lockWait = millis() | 1;
+        if (millis() - _lockWait < 1100) return false; // same patience as requestJSONBufferLock()
+        _pending = F("{\"error\":3}");
+        _lockWait = 0;
+        return true;
+      }
+      _lockWait = 0;
+      JsonObject root = lease.doc()->to<JsonObject>();
+      if (info) serializeInfo(root); else serializeState(root);
+      _pending.reserve(measureJson(root) + 1);
+      serializeJson(root, _pending);
+      return true;
+    }
+
+    // append a JSON string, escaping quotes, backslashes and control characters (RFC 8259)
+    void appendString(const char* s) {
+      _pending += '"';
+      for (; *s; s++) {
+        uint8_t c = *s;
+        if (c == '"' || c == '\\') { _pending += '\\'; _pending += char(c); }
+        else if (c == '\n') _pending += F("\\n");
+        else if (c == '\r') _pending += F("\\r");
+        else if (c == '\t') _pending += F("\\t");
+        else if (c == '\b') _pending += F("\\b");
+        else if (c == '\f') _pending += F("\\f");
+        else if (c < 0x20) {
+          char esc[7];
+          snprintf_P(esc, sizeof(esc), PSTR("\\u%04x"), c);
+          _pending += esc;
+        }
+        else _pending += char(c);
+      }
+      _pending += '"';
+    }
+
+    // effect names or fxdata entries, a few per call (same entries as serializeModeNames() and serializeModeData())
+    void produceMode(bool fxdata) {
+      if (!_opened) { _pending = "["; _opened = true; return; }
+      char lineBuffer[192];
+      while (_item < strip.getModeCount()) {
+        if (!getModeEntry(_item++, fxdata, lineBuffer, sizeof(lineBuffer))) continue;
+        if (_written++ > 0) _pending += ',';
+        appendString(lineBuffer);
+        if (_pending.length() >= JSON_STREAM_PAL_CHUNK) return; // enough for now
+      }
+      _pending += "]";
+      _opened = false; _written = 0;
+      next();
+    }
+
+    // produce the next piece of output, returns false if the JSON buffer is locked
+    bool produce() {
+      switch (_sections[_section]) {
+        case S_OPEN_STATE:    _pending = F("{\"state\":"); next(); break;
+        case S_STATE:         if (!produceDOM(false)) return false; next(); break;
+        case S_OPEN_INFO:     _pending = F(",\"info\":"); next(); break;
+        case S_INFO:          if (!produceDOM(true)) return false; next(); break;
+        case S_OPEN_EFFECTS:  _pending = F(",\"effects\":"); next(); break;
+        case S_EFFECTS:       produceMode(false); break;
+        case S_FXDATA:        produceMode(true); break;
+        case S_OPEN_PALETTES: _pending = F(",\"palettes\":"); next(); break;
+        case S_PALETTES: {
+          size_t total = strlen_P(JSON_palette_names);
+          size_t pos = size_t(_item) * JSON_STREAM_PAL_CHUNK;
+          if (pos >= total) { next(); break; }
+          char chunk[JSON_STREAM_PAL_CHUNK + 1];
+          size_t n = min(size_t(JSON_STREAM_PAL_CHUNK), total - pos);
+          memcpy_P(chunk, JSON_palette_names + pos, n);
+          chunk[n] = 0;
+          _pending = chunk;
+          _item++;
+          } break;
+        case S_CLOSE:         _pending = "}"; next(); break;
+      }
+      return true;
+    }
+};
+
+static void serveJsonStream(AsyncWebServerRequest* request, byte subJson)
+{
+  std::shared_ptr<JsonStreamer> streamer(new(std::nothrow) JsonStreamer(subJson));
+  if (!streamer) {
+    request->send(503, "application/json", F("{\"error\":3}"));
+    return;
+  }
+  AsyncWebServerResponse *response = request->beginChunkedResponse(F("application/json"),
+    [streamer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      return streamer->fill(buffer, maxLen);
+    });
+  request->send(response);
+}
+
 void serveJson(AsyncWebServerRequest* request)
 {
   byte subJson = 0;
@@ -1476,6 +1722,10 @@ void serveJson(AsyncWebServerRequest* request)
   else if (url.indexOf("palx")  > 0) subJson = JSON_PATH_PALETTES;
   else if (url.indexOf("fxda")  > 0) subJson = JSON_PATH_FXDATA;
   else if (url.indexOf("net") > 0) subJson = JSON_PATH_NETWORKS;
+  else if ((url.indexOf("live") > 0) && request->hasArg(F("rle"))) { // WLEDMM compressed live stream, always available
+    serveLiveStream(request);
+    return;
+  }
   #ifdef WLED_ENABLE_JSONLIVE
   else if (url.indexOf("live")  > 0) {
     serveLiveLeds(request);
@@ -1484,13 +1734,13 @@ void serveJson(AsyncWebServerRequest* request)
   #endif
   else if (url.indexOf(F("eff")) > 0) {
     // this serves just effect names without FX data extensions in names
-    if (requestJSONBufferLock(19)) {
-      AsyncJsonResponse* response = new AsyncJsonResponse(&doc, true);  // array document
+    JSONBufferLease lease(19);
+    if (lease) {
+      AsyncJsonResponse* response = new AsyncJsonResponse(lease.doc(), true);  // array document
       JsonArray lDoc = response->getRoot();
       serializeModeNames(lDoc); // remove WLED-SR extensions from effect names
       response->setLength();
       request->send(response);
-      releaseJSONBufferLock();
     } else {
       request->send(503, "application/json", F("{\"error\":3}"));
     }
@@ -1508,13 +1758,23 @@ void serveJson(AsyncWebServerRequest* request)
     return;
   }
 
-  if (!requestJSONBufferLock(17)) {
+  if (subJson == JSON_PATH_STATE) {
+    serveStateCached(request);
+    return;
+  }
+  if (subJson == 0 || subJson == JSON_PATH_STATE_INFO || subJson == JSON_PATH_INFO || subJson == JSON_PATH_EFFECTS || subJson == JSON_PATH_FXDATA) {
+    serveJsonStream(request, subJson);
+    return;
+  }
+
+  JSONBufferLease lease(17); // WLEDMM read-only - use a pool document so we don't wait for "doc"
+  if (!lease) {
     request->send(503, "application/json", F("{\"error\":3}"));
     return;
   }
-  // releaseJSONBufferLock() will be called when "response" is destroyed (from AsyncWebServer)
+  // the lease will be returned when "response" is destroyed (from AsyncWebServer)
   // make sure you delete "response" if no "request->send(response);" is made
-  LockedJsonResponse *response = new LockedJsonResponse(&doc, subJson==JSON_PATH_FXDATA || subJson==JSON_PATH_EFFECTS); // will clear and convert JsonDocument into JsonArray if necessary
+  LockedJsonResponse *response = new LockedJsonResponse(std::move(lease), subJson==JSON_PATH_FXDATA || subJson==JSON_PATH_EFFECTS); // will clear and convert JsonDocument into JsonArray if necessary
 
   JsonVariant lDoc = response->getRoot();
 
@@ -0,0 +1,202 @@
+#include "wled.h"
+#include <memory>
+
+/*
+ * WLEDMM compressed live LED stream (/json/live?rle and WS live peek with "lvc")
+ *
+ * Pixels are converted to RGB565 and run-length encoded while streaming, so neither HTTP nor WS
+ * need a buffer for the whole frame, and large installations are sent without sub-sampling.
+ *
+ * Stream layout (all multi-byte values little endian):
+ *   header (12 bytes): 'L', 3 (version), segment id (255 = whole strip), flags (bit0: last chunk),
+ *                      width (uint16), height (uint16), first pixel of this chunk (uint32)
+ *   records: 0x00-0x7F: run  - (byte+1) pixels with the following RGB565 color
+ *            0x80-0xFF: copy - ((byte & 0x7F)+1) RGB565 colors follow
+ * HTTP sends one header followed by all records (chunked transfer), WS sends one header per message.
+ */
+
+#define LIVE_HEADER_LEN   12
+#define LIVE_MAX_RECORD   128
+#define LIVE_WS_CHUNK     2048  // max WS message size
+#define LIVE_WS_MAX_QUEUE 8     // don't flood the WS queue
+#define LIVE_BLOCK        64    // pixels read and converted in one go
+
+class LiveEncoder {
+  public:
+    LiveEncoder(int segId) : _segId(segId) {
+      Segment::pinArena(true); // WLEDMM we read seg.ledsrgb from the async task - keep the segment arena from moving it
+      if ((_segId >= 0) && (_segId < int(strip.getSegmentsNum())) && strip.getSegment(_segId).isActive()) {
+        Segment &seg = strip.getSegment(_segId);
+        _width  = seg.is2D() ? seg.virtualWidth() : seg.virtualLength();
+        _height = seg.is2D() ? seg.virtualHeight() : 1;
+      } else {
+        _segId = -1;
+        #ifndef WLED_DISABLE_2D
+        if (strip.isMatrix) { _width = Segment::maxWidth; _height = Segment::maxHeight; }
+        else
+        #endif
+        { _width = strip.getLengthTotal(); _height = 1; }
+      }
+      _total = uint32_t(_width) * _height;
+    }
+    ~LiveEncoder() { Segment::pinArena(false); }
+    LiveEncoder(const LiveEncoder&) = delete;
+    LiveEncoder& operator=(const LiveEncoder&) = delete;
+
+    bool done() const { return _pos >= _total; }
+
+    uint32_t position() const { return _pos; }
+
+    size_t writeHeader(uint8_t* out, uint32_t firstPixel, bool last) const {
+      out[0]  = 'L';
+      out[1]  = 3;
+      out[2]  = (_segId < 0) ? 255 : _segId;
+      out[3]  = last ? 0x01 : 0x00;
+      out[4]  = _width & 0xFF;  out[5] = _width >> 8;
+      out[6]  = _height & 0xFF; out[7] = _height >> 8;
+      out[8]  = firstPixel & 0xFF; out[9] = (firstPixel >> 8) & 0xFF; out[10] = (firstPixel >> 16) & 0xFF; out[11] = firstPixel >> 24;
+      return LIVE_HEADER_LEN;
+    }
+
+    // encode as many records as fit into out[0..maxLen-1], returns number of bytes written
+    size_t encode(uint8_t* out, size_t maxLen) {
+      size_t len = 0;
+      // HTTP chunks are requested asynchronously - segment buffers may have changed since the last call
+      _leds = nullptr;
+      if (_segId >= 0) {
+        Segment &seg = strip.getSegment(_segId);
+        uint16_t w = seg.is2D() ? seg.virtualWidth() : seg.virtualLength();
+        uint16_t h = seg.is2D() ? seg.virtualHeight() : 1;
+        if (!seg.isActive() || (w != _width) || (h != _height)) { _pos = _total; return 0; } // segment changed - end stream
+        _leds = seg.ledsrgb; // read the segment buffer directly if we have one
+      }
+      while ((_pos < _total) && (maxLen - len >= 3)) {
+        uint16_t c = pixel565(_pos);
+        unsigned run = 1;
+        while ((_pos + run < _total) && (run < LIVE_MAX_RECORD) && (pixel565(_pos + run) == c)) run++;
+        // each pixel is read only once - pixel565() serves repeated lookups from the current block
+        if (run > 1) {
+          out[len++] = run - 1;
+          out[len++] = c & 0xFF; out[len++] = c >> 8;
+          _pos += run;
+          continue;
+        }
+        // copy record: collect pixels until the next run starts or the output is full
+        size_t hdr = len++;
+        unsigned count = 0;
+        unsigned maxCount = min(size_t(LIVE_MAX_RECORD), (maxLen - len) / 2);
+        uint16_t next = c;
+        while (count < maxCount) {
+          out[len++] = next & 0xFF; out[len++] = next >> 8;
+          count++;
+          if (_pos + count >= _total) break;
+          uint16_t after = pixel565(_pos + count);
+          if ((_pos + count + 1 < _total) && (pixel565(_pos + count + 1) == after)) break; // a run starts here
+          next = after;
+        }
+        out[hdr] = 0x80 | (count - 1);
+        _pos += count;
+      }
+      return len;
+    }
+
+  private:
+    int       _segId;
+    uint16_t  _width = 0, _height = 0;
+    uint32_t  _total = 0;
+    uint32_t  _pos = 0;
+    const CRGB* _leds = nullptr;
+
+    uint16_t  _blk[LIVE_BLOCK];   // RGB565 of pixels _blkStart .. _blkStart+_blkLen-1
+    uint32_t  _blkStart = 0;
+    unsigned  _blkLen = 0;
+
+    // RGB565 of pixel i (i >= _pos)
+    uint16_t pixel565(uint32_t i) {
+      if (i - _blkStart >= _blkLen) fillBlock(i); // unsigned - also true for i < _blkStart
+      return _blk[i - _blkStart];
+    }
+
+    // new block that starts one pixel before i (the encoder looks back at most one pixel), keeping what we already have
+    void fillBlock(uint32_t i) {
+      uint32_t start = (i > _pos) ? i - 1 : i;
+      unsigned keep = 0;
+      if ((start >= _blkStart) && (start < _blkStart + _blkLen)) {
+        keep = _blkStart + _blkLen - start;
+        memmove(_blk, _blk + (start - _blkStart), keep * sizeof(uint16_t));
+      }
+      uint32_t first = start + keep;
+      unsigned count = min(uint32_t(LIVE_BLOCK - keep), _total - first);
+      uint32_t c[LIVE_BLOCK];
+      if (_leds) {
+        for (unsigned k = 0; k < count; k++) c[k] = RGBW32(_leds[first+k].r, _leds[first+k].g, _leds[first+k].b, 0); // segment buffer - no function call per pixel
+      } else if (_segId >= 0) {
+        Segment &seg = strip.getSegment(_segId);
+        for (unsigned k = 0; k < count; k++)
+          c[k] = (_height > 1) ? seg.getPixelColorXY(int((first+k) % _width), int((first+k) / _width)) : seg.getPixelColor(int(first+k));
+      } else strip.getPixelColorsRestored(first, count, c);
+      for (unsigned k = 0; k < count; k++) _blk[keep + k] = to565(c[k]);
+      _blkStart = start;
+      _blkLen = keep + count;
+    }
+
+    static uint16_t to565(uint32_t c) {
+      // same preview color handling as sendLiveLedsWs()
+      uint8_t w = W(c);
+      uint8_t r, g, b;
+      if (gammaCorrectPreview) {
+        if (w>0) c = color_add(c, RGBW32(w, w, w, 0), false);
+        r = unGamma8(R(c)); g = unGamma8(G(c)); b = unGamma8(B(c));
+      } else {
+        r = qadd8(w, R(c)); g = qadd8(w, G(c)); b = qadd8(w, B(c));
+      }
+      return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+};
+
+// HTTP: /json/live?rle[&seg=n] - chunked response, no buffer for the whole frame
+void serveLiveStream(AsyncWebServerRequest* request) {
+  int segId = request->hasArg(F("seg")) ? request->arg(F("seg")).toInt() : -1;
+  std::shared_ptr<LiveEncoder> enc(new(std::nothrow) LiveEncoder(segId));
+  if (!enc) {
+    request->send(503, "application/json", F("{\"error\":3}"));
+    return;
+  }
+  AsyncWebServerResponse *response = request->beginChunkedResponse(F("application/octet-stream"),
+    [enc](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      if (maxLen < LIVE_HEADER_LEN + 3) return RESPONSE_TRY_AGAIN;
+      if (index == 0) {
+        size_t len = enc->writeHeader(buffer, 0, true);
+        return len + enc->encode(buffer + len, maxLen - len);
+      }
+      return enc->done() ? 0 : enc->encode(buffer, maxLen);
+    });
+  response->addHeader(F("Cache-Control"), F("no-store"));
+  request->send(response);
+}
+
+#ifdef WLED_ENABLE_WEBSOCKETS
+// WS: live peek with compression - one frame is split into messages of max LIVE_WS_CHUNK bytes
+bool sendLiveStreamWs(uint32_t wsClient, int segId) {
+  AsyncWebSocketClient * wsc = ws.client(wsClient);
+  if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
+
+  static uint8_t chunk[LIVE_WS_CHUNK]; // handleWs() runs in the main loop only
+  LiveEncoder enc(segId);
+  while (!enc.done()) {
+    if (wsc->queueLength() >= LIVE_WS_MAX_QUEUE) return true; // client is slow - drop the rest of this frame
+    uint32_t firstPixel = enc.position();
+    size_t len = LIVE_HEADER_LEN + enc.encode(chunk + LIVE_HEADER_LEN, LIVE_WS_CHUNK - LIVE_HEADER_LEN);
+    enc.writeHeader(chunk, firstPixel, enc.done());
+    AsyncWebSocketBuffer wsBuf(len); // exact size - no allocation for the whole frame
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(wsBuf.data());
+    if (!wsBuf || !buffer) {
+      errorFlag = ERR_LOW_WS_MEM;
+      return false; //out of memory
+    }
+    memcpy(buffer, chunk, len);
+    wsc->binary(std::move(wsBuf));
+  }
+  return true;
+}
+#endif
@@ -132,6 +132,11 @@ void OnDataRecv(uint8_t * mac, uint8_t *incomingData, uint8_t len) {
 void OnDataRecv(const uint8_t * mac, const uint8_t *incomingData, int len) {
 #endif
 
+  #ifdef WLED_ENABLE_ESPNOW_SYNC
+  if (espNowSyncReceive(mac, incomingData, len)) return; // WLEDMM sync / pixel packets from other nodes
+  if (!enable_espnow_remote) return;
+  #endif
+
   sprintf (last_signal_src, "%02x%02x%02x%02x%02x%02x",
     mac [0], mac [1], mac [2], mac [3], mac [4], mac [5]);
 
@@ -181,7 +186,12 @@ void OnDataRecv(const uint8_t * mac, const uint8_t *incomingData, int len) {
 }
 
 void handleRemote() {
-  if (enable_espnow_remote) {
+  #ifdef WLED_ENABLE_ESPNOW_SYNC
+  bool espNowWanted = enable_espnow_remote || espNowSyncMode; // WLEDMM ESP-NOW sync shares the receiver
+  #else
+  bool espNowWanted = enable_espnow_remote;
+  #endif
+  if (espNowWanted) {
     if ((esp_now_state == ESP_NOW_STATE_UNINIT) && (interfacesInited || apActive)) { // ESPNOW requires Wifi to be initialized (either STA, or AP Mode) 
       USER_PRINTLN(F("\nInitializing ESP_NOW listener!\n"));
       // Init ESP-NOW
@@ -196,6 +206,9 @@ void handleRemote() {
       
       esp_now_register_recv_cb(OnDataRecv);
       esp_now_state = ESP_NOW_STATE_ON;
+      #ifdef WLED_ENABLE_ESPNOW_SYNC
+      if (espNowSyncMode) espNowSyncInit();
+      #endif
     }
   } else {
     if (esp_now_state == ESP_NOW_STATE_ON) {
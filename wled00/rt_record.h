@@ -0,0 +1,189 @@
+#pragma once
+#ifndef WLED_RT_RECORD_H
+#define WLED_RT_RECORD_H
+
+/*
+ * WLEDMM realtime stream recording format (.wrt) - E1.31 / Art-Net / DDP packets as they arrived
+ *
+ * File:   "WRTR" version(1) 0 0 0, then records
+ * Record: 0 time in ms since start of recording (uint32)   4 protocol (P_E131, P_ARTNET, P_DDP)
+ *         5 slot (bits 0-6, RTREC_NO_SLOT = none) | RTREC_DELTA   6 packet length (uint16)
+ *         8 sender IPv4 (uint32)   12 payload length (uint16)   14 payload
+ * Payload is the packet itself, or with RTREC_DELTA the changes against the previous packet of the same slot:
+ *         skip (uint16), count (uint16), count bytes ... - skip counts from the end of the previous span
+ * Encoder and decoder keep the last packet of each slot, so a stream of mostly static frames shrinks a lot.
+ * All numbers little endian.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define RTREC_MAGIC         "WRTR"
+#define RTREC_VERSION       1
+#define RTREC_FILE_HEADER   8
+#define RTREC_REC_HEADER    14
+#define RTREC_MAX_PACKET    1458   // sizeof(e131_packet_t)
+#define RTREC_DELTA         0x80
+#define RTREC_NO_SLOT       0x7F
+#define RTREC_SPAN_GAP      4      // equal bytes shorter than a span header are copied instead of skipped
+
+struct RtRecord {
+  uint32_t time;
+  uint8_t  protocol;
+  uint8_t  slot;          // including RTREC_DELTA
+  uint16_t length;        // packet
+  uint32_t ip;
+  uint16_t payload;
+
+  static void put16(uint8_t* p, uint32_t v) { p[0] = v; p[1] = v >> 8; }
+  static void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p+2, v >> 16); }
+  static uint32_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+  static uint32_t get32(const uint8_t* p) { return get16(p) | (get16(p+2) << 16); }
+
+  void write(uint8_t* h) const {
+    put32(h, time); h[4] = protocol; h[5] = slot; put16(h+6, length); put32(h+8, ip); put16(h+12, payload);
+  }
+  bool read(const uint8_t* h) {
+    time = get32(h); protocol = h[4]; slot = h[5]; length = get16(h+6); ip = get32(h+8); payload = get16(h+12);
+    return length > 0 && length <= RTREC_MAX_PACKET && payload <= RTREC_MAX_PACKET;
+  }
+
+  static void writeFileHeader(uint8_t* h) { memcpy(h, RTREC_MAGIC, 4); h[4] = RTREC_VERSION; h[5] = h[6] = h[7] = 0; }
+  static bool checkFileHeader(const uint8_t* h) { return memcmp(h, RTREC_MAGIC, 4) == 0 && h[4] == RTREC_VERSION; }
+};
+
+// last packet per slot, shared layout for recording and replay; memory = slots * RTREC_MAX_PACKET bytes
+class RtDeltaCodec {
+  private:
+    static const unsigned MAX_SLOTS = RTREC_NO_SLOT;
+    uint8_t* _mem = nullptr;
+    unsigned _slots = 0;
+    unsigned _victim = 0;          // encoder: next slot to reuse
+    uint32_t _key[MAX_SLOTS];      // encoder only
+    uint16_t _len[MAX_SLOTS];      // 0 = empty
+
+    uint8_t* slot(unsigned s) const { return _mem + s * RTREC_MAX_PACKET; }
+
+  public:
+    void attach(void* mem, unsigned slots) {
+      _mem = static_cast<uint8_t*>(mem);
+      _slots = mem ? (slots < MAX_SLOTS ? slots : MAX_SLOTS) : 0;
+      _victim = 0;
+      memset(_len, 0, sizeof(_len));
+    }
+
+    // encode pkt (stream identified by key) into out (RTREC_MAX_PACKET bytes); fills rec.slot, rec.length and rec.payload
+    void encode(uint32_t key, const uint8_t* pkt, uint16_t len, uint8_t* out, RtRecord &rec) {
+      rec.length = len;
+      unsigned s = 0;
+      while (s < _slots && !(_len[s] && _key[s] == key)) s++;
+      if (s >= _slots) { // new stream
+        rec.slot = RTREC_NO_SLOT;
+        if (_slots == 0) { memcpy(out, pkt, len); rec.payload = len; return; }
+        s = _victim;
+        _victim = (_victim + 1) % _slots;
+      } else if (_len[s] == len) { // same stream, same size: spans of changed bytes
+        const uint8_t* prev = slot(s);
+        size_t o = 0, last = 0, i = 0;
+        bool fits = true;
+        while (fits) {
+          while (i < len && pkt[i] == prev[i]) i++;
+          if (i >= len) break;
+          size_t start = i, end = i, same = 0;
+          while (i < len && same < RTREC_SPAN_GAP) {
+            if (pkt[i] == prev[i]) same++; else { same = 0; end = i + 1; }
+            i++;
+          }
+          i = end;
+          if (o + 4 + (end - start) >= len) { fits = false; break; } // delta would not be smaller
+          RtRecord::put16(out + o, start - last);
+          RtRecord::put16(out + o + 2, end - start);
+          memcpy(out + o + 4, pkt + start, end - start);
+          o += 4 + (end - start);
+          last = end;
+        }
+        if (fits) {
+          memcpy(slot(s), pkt, len);
+          rec.slot = s | RTREC_DELTA;
+          rec.payload = o;
+          return;
+        }
+      }
+      memcpy(slot(s), pkt, len);
+      _key[s] = key;
+      _len[s] = len;
+      memcpy(out, pkt, len);
+      rec.slot = s;
+      rec.payload = len;
+    }
+
+    // rebuild the packet of rec from its payload into out (RTREC_MAX_PACKET bytes); false = corrupt record
+    bool decode(const RtRecord &rec, const uint8_t* payload, uint8_t* out) {
+      unsigned s = rec.slot & ~RTREC_DELTA;
+      if (!(rec.slot & RTREC_DELTA)) {
+        if (rec.payload != rec.length) return false;
+        memcpy(out, payload, rec.length);
+        if (s < _slots) { memcpy(slot(s), payload, rec.length); _len[s] = rec.length; }
+        return true;
+      }
+      if (s >= _slots || _len[s] != rec.length) return false; // missed the start of the stream
+      uint8_t* prev = slot(s);
+      size_t pos = 0;
+      for (size_t o = 0; o < rec.payload; ) {
+        if (o + 4 > rec.payload) return false;
+        pos += RtRecord::get16(payload + o);
+        size_t count = RtRecord::get16(payload + o + 2);
+        o += 4;
+        if (pos + count > rec.length || o + count > rec.payload) return false;
+        memcpy(prev + pos, payload + o, count);
+        pos += count;
+        o += count;
+      }
+      memcpy(out, prev, rec.length);
+      return true;
+    }
+};
+
+// byte ring for one writer and one reader in different tasks
+class RtByteRing {
+  private:
+    uint8_t* _buf = nullptr;
+    size_t   _size = 0;
+    volatile size_t _head = 0;   // written by the producer
+    volatile size_t _tail = 0;   // written by the consumer
+
+  public:
+    void attach(void* mem, size_t size) { _buf = static_cast<uint8_t*>(mem); _size = mem ? size : 0; _head = _tail = 0; }
+    size_t used() const { // either side may call this, the other index is written by the other task
+      size_t h = __atomic_load_n(&_head, __ATOMIC_ACQUIRE), t = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+      return (h + _size - t) % (_size ? _size : 1);
+    }
+    size_t space() const { return _size ? _size - 1 - used() : 0; }
+
+    // both parts or nothing
+    bool push(const uint8_t* a, size_t alen, const uint8_t* b, size_t blen) {
+      if (alen + blen > space()) return false;
+      size_t h = _head;
+      for (int part = 0; part < 2; part++) {
+        const uint8_t* d = part ? b : a;
+        size_t len = part ? blen : alen;
+        size_t first = (len < _size - h) ? len : _size - h;
+        memcpy(_buf + h, d, first);
+        memcpy(_buf, d + first, len - first);
+        h = (h + len) % _size;
+      }
+      __atomic_store_n(&_head, h, __ATOMIC_RELEASE);
+      return true;
+    }
+
+    // contiguous readable bytes at *data
+    size_t peek(const uint8_t** data) const {
+      size_t h = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+      *data = _buf + _tail;
+      return (h >= _tail) ? h - _tail : _size - _tail;
+    }
+    void consume(size_t len) { __atomic_store_n(&_tail, (_tail + len) % _size, __ATOMIC_RELEASE); }
+};
+
+#endif
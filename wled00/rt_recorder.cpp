@@ -0,0 +1,337 @@
+#include "wled.h"
+
+/*
+ * WLEDMM realtime stream recorder - captures E1.31 / Art-Net / DDP input and replays it through the same path
+ *
+ * {"rtrec":{"rec":"/sd/capture.wrt"}} starts recording, {"rtrec":{"play":"/capture.wrt","loop":false,"fast":false}}
+ * replays, {"rtrec":{"stop":true}} ends both. See rt_record.h for the file format.
+ *
+ * Recording: handleE131Packet() (network task) delta-encodes each packet into a ring buffer and never waits -
+ * if the ring is full the packet is counted as dropped. A writer (own task on ESP32, main loop on ESP8266)
+ * moves the ring into the file. The lock only guards the state and the "encoding" flag; encoding and copying
+ * into the ring run outside of it, the ring publishes its head index when a record is complete.
+ * Replay: the main loop feeds the packets into handleE131Packet() at their recorded time; live packets are
+ * ignored meanwhile. With "fast":true packets are fed back to back without rendering in between, and the
+ * time spent in handleE131Packet() is a repeatable benchmark of the receive path.
+ */
+#ifdef WLED_ENABLE_RTREC
+
+#include "rt_record.h"
+
+#ifndef RTREC_RING
+  #ifdef ARDUINO_ARCH_ESP32
+    #define RTREC_RING  32768
+  #else
+    #define RTREC_RING  8192
+  #endif
+#endif
+#ifndef RTREC_SLOTS
+  #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM)
+    #define RTREC_SLOTS 32
+  #elif defined(ARDUINO_ARCH_ESP32)
+    #define RTREC_SLOTS 8
+  #else
+    #define RTREC_SLOTS 2
+  #endif
+#endif
+#define RTREC_PLAY_SLICE_MS 5   // max time per loop() in fast replay
+
+#define RTREC_IDLE    0
+#define RTREC_OPEN    1
+#define RTREC_RECORD  2
+#define RTREC_STOP    3
+#define RTREC_CLOSED  4
+#define RTREC_ERROR   5
+#define RTREC_PLAY    6
+
+static volatile uint8_t rtState = RTREC_IDLE;
+static const char* rtError = nullptr;
+static File        rtFile;                    // writer while recording, main loop while playing
+static char        rtPath[33] = {'\0'};
+static char        rtPending[33] = {'\0'};
+static volatile char rtPendingMode = 0;       // 'r' record, 'p' play
+static volatile bool rtStopReq = false;
+static bool        rtLoop = false, rtFast = false;
+
+static RtByteRing   rtRing;
+static RtDeltaCodec rtCodec;
+static uint8_t*     rtRingMem = nullptr;
+static uint8_t*     rtWork = nullptr;         // RTREC_SLOTS packets for the codec + 2 work buffers
+static unsigned long rtStartMs = 0;
+
+static uint32_t rtPackets = 0, rtDropped = 0, rtRawBytes = 0, rtFileBytes = 0;
+static uint32_t rtUsTotal = 0, rtUsMax = 0;    // replay: time spent in handleE131Packet()
+static bool     rtReplaying = false;           // handleE131Packet() is called by us
+static bool     rtEncoding = false;            // a network task is encoding a packet (guarded by rtMux)
+static RtRecord rtNext;
+static bool     rtHaveNext = false;
+
+#ifdef ARDUINO_ARCH_ESP32
+static TaskHandle_t rtTask = nullptr;
+static portMUX_TYPE rtMux = portMUX_INITIALIZER_UNLOCKED;
+#define RTREC_LOCK()   portENTER_CRITICAL(&rtMux)
+#define RTREC_UNLOCK() portEXIT_CRITICAL(&rtMux)
+#else
+#define RTREC_LOCK()   // ESP8266 UDP callbacks do not interrupt loop()
+#define RTREC_UNLOCK()
+#endif
+
+static uint16_t rtPacketLength(const e131_packet_t* p, byte protocol) {
+  size_t len;
+  if (protocol == P_DDP)         len = 10 + ((p->flags & DDP_TIMECODE_FLAG) ? 4 : 0) + htons(p->dataLen);
+  else if (protocol == P_ARTNET) len = (p->art_opcode == ARTNET_OPCODE_OPPOLL) ? 14 : 18 + htons(p->art_length);
+  else                           len = 125 + htons(p->property_value_count);
+  return min(len, size_t(RTREC_MAX_PACKET));
+}
+
+// one delta stream per sender and universe (DDP: channel offset)
+static uint32_t rtStreamKey(const e131_packet_t* p, uint32_t ip, byte protocol) {
+  uint32_t stream = (protocol == P_DDP) ? htonl(p->channelOffset) : (protocol == P_ARTNET) ? p->art_universe : htons(p->universe);
+  return (uint32_t(protocol) << 24) ^ stream ^ (ip * 2654435761u);
+}
+
+// called first thing in handleE131Packet() - returns false if the packet must be ignored (live input during replay)
+bool rtRecorderPacket(e131_packet_t* p, IPAddress clientIP, byte protocol) {
+  if (rtState == RTREC_PLAY) return rtReplaying;
+  if (rtState != RTREC_RECORD) return true;
+  RtRecord rec;
+  rec.time = millis() - rtStartMs;
+  rec.protocol = protocol;
+  rec.ip = uint32_t(clientIP);
+  uint8_t header[RTREC_REC_HEADER];
+  uint8_t* payload = rtWork + RTREC_SLOTS * RTREC_MAX_PACKET;
+  RTREC_LOCK();
+  bool record = (rtState == RTREC_RECORD) && !rtEncoding; // not stopped meanwhile - the writer waits for us before closing
+  if (record) rtEncoding = true;
+  else if (rtState == RTREC_RECORD) rtDropped++;         // another network task is encoding; the codec did not see this packet
+  RTREC_UNLOCK();
+  if (!record) return true;
+
+  uint16_t len = rtPacketLength(p, protocol);
+  rtCodec.encode(rtStreamKey(p, rec.ip, protocol), p->raw, len, payload, rec);
+  rec.write(header);
+  bool pushed = rtRing.push(header, sizeof(header), payload, rec.payload);
+  if (!pushed) rtCodec.attach(rtWork, RTREC_SLOTS); // the next delta would refer to a packet that is not in the file
+
+  RTREC_LOCK();
+  rtEncoding = false;
+  if (pushed) { rtPackets++; rtRawBytes += len; }
+  else rtDropped++;
+  RTREC_UNLOCK();
+  #ifdef ARDUINO_ARCH_ESP32
+  if (rtTask) xTaskNotifyGive(rtTask);
+  #endif
+  return true;
+}
+
+// writer: open the file, move the ring into it, close it after a stop
+static void rtWriterStep() {
+  switch (rtState) {
+    case RTREC_OPEN: {
+      uint8_t h[RTREC_FILE_HEADER];
+      RtRecord::writeFileHeader(h);
+      rtFile = openMediaFile(rtPath, "w");
+      rtError = rtFile ? nullptr : "cannot create file";
+      if (!rtError && rtFile.write(h, sizeof(h)) != sizeof(h)) { rtError = "write error"; rtFile.close(); }
+      rtFileBytes = sizeof(h);
+      rtStartMs = millis();
+      rtState = rtError ? RTREC_ERROR : RTREC_RECORD;
+      break;
+    }
+    case RTREC_RECORD:
+    case RTREC_STOP: {
+      RTREC_LOCK();
+      bool stopping = (rtState == RTREC_STOP) && !rtEncoding; // read before draining, so nothing pushed before the stop is lost
+      RTREC_UNLOCK();
+      const uint8_t* data;
+      size_t len;
+      while ((len = rtRing.peek(&data)) > 0) {
+        if (!rtError && rtFile.write(data, len) != len) {
+          rtError = "write error (disk full?)";
+          RTREC_LOCK();
+          if (rtState == RTREC_RECORD) rtState = RTREC_STOP;
+          RTREC_UNLOCK();
+        }
+        if (!rtError) rtFileBytes += len;
+        rtRing.consume(len);
+      }
+      if (stopping) {
+        rtFile.close();
+        rtState = RTREC_CLOSED;
+      }
+      break;
+    }
+  }
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+static void rtWriterTask(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(20));
+    rtWriterStep();
+  }
+}
+#endif
+
+static void rtWakeWriter() {
+  #ifdef ARDUINO_ARCH_ESP32
+  if (rtTask) xTaskNotifyGive(rtTask);
+  #else
+  rtWriterStep();
+  #endif
+}
+
+static void rtFreeBuffers() {
+  if (rtRingMem) free(rtRingMem);
+  if (rtWork) free(rtWork);
+  rtRingMem = rtWork = nullptr;
+  rtRing.attach(nullptr, 0);
+  rtCodec.attach(nullptr, 0);
+}
+
+static bool rtAllocBuffers(bool ring) {
+  rtWork = (uint8_t*) tieredMalloc((RTREC_SLOTS + 2) * RTREC_MAX_PACKET, WLED_MEM_COLD, "rt recorder");
+  if (ring) rtRingMem = (uint8_t*) tieredMalloc(RTREC_RING, WLED_MEM_COLD, "rt recorder ring");
+  if (!rtWork || (ring && !rtRingMem)) {
+    rtFreeBuffers();
+    errorFlag = ERR_LOW_MEM;
+    return false;
+  }
+  rtCodec.attach(rtWork, RTREC_SLOTS);
+  if (ring) rtRing.attach(rtRingMem, RTREC_RING);
+  return true;
+}
+
+static void rtStartPlay() {
+  uint8_t h[RTREC_FILE_HEADER];
+  rtFile = openMediaFile(rtPath, "r");
+  rtError = rtFile ? nullptr : "file not found";
+  if (!rtError && (rtFile.read(h, sizeof(h)) != int(sizeof(h)) || !RtRecord::checkFileHeader(h))) rtError = "not a recording";
+  if (!rtError && !rtAllocBuffers(false)) rtError = "not enough memory";
+  if (rtError) {
+    if (rtFile) rtFile.close();
+    USER_PRINTF("RT recorder: %s - %s.\n", rtPath, rtError);
+    return;
+  }
+  rtHaveNext = false;
+  rtStartMs = millis();
+  rtState = RTREC_PLAY;
+  USER_PRINTF("RT recorder: replaying %s%s.\n", rtPath, rtFast ? " (fast)" : "");
+}
+
+// feed recorded packets into handleE131Packet(); false = end of recording
+static bool rtPlayStep() {
+  uint8_t* packet  = rtWork + RTREC_SLOTS * RTREC_MAX_PACKET;
+  uint8_t* payload = packet + RTREC_MAX_PACKET;
+  unsigned long sliceStart = millis();
+  do {
+    if (!rtHaveNext) {
+      uint8_t h[RTREC_REC_HEADER];
+      if (rtFile.read(h, sizeof(h)) != int(sizeof(h))) {
+        if (!rtLoop) return false;
+        rtFile.seek(RTREC_FILE_HEADER);  // from the top
+        rtCodec.attach(rtWork, RTREC_SLOTS);
+        rtStartMs = millis();
+        return true;
+      }
+      if (!rtNext.read(h) || rtFile.read(payload, rtNext.payload) != int(rtNext.payload)) { rtError = "corrupt recording"; return false; }
+      rtHaveNext = true;
+    }
+    if (!rtFast && millis() - rtStartMs < rtNext.time) return true; // not due yet
+    rtHaveNext = false;
+    if (!rtCodec.decode(rtNext, payload, packet)) { rtDropped++; continue; }
+    rtReplaying = true;
+    unsigned long us = micros();
+    handleE131Packet(reinterpret_cast<e131_packet_t*>(packet), IPAddress(rtNext.ip), rtNext.protocol);
+    us = micros() - us;
+    rtReplaying = false;
+    rtUsTotal += us;
+    if (us > rtUsMax) rtUsMax = us;
+    rtPackets++;
+  } while (millis() - sliceStart < RTREC_PLAY_SLICE_MS);
+  return true;
+}
+
+// main loop
+void handleRtRecorder() {
+  switch (rtState) {
+    case RTREC_IDLE: {
+      RTREC_LOCK();
+      char mode = rtPendingMode;
+      if (mode) { strcpy(rtPath, rtPending); rtPendingMode = 0; }
+      RTREC_UNLOCK();
+      rtStopReq = false;
+      if (!mode) return;
+      rtPackets = rtDropped = rtRawBytes = rtFileBytes = rtUsTotal = rtUsMax = 0;
+      rtError = nullptr;
+      if (mode == 'p') { rtStartPlay(); return; }
+      if (!rtAllocBuffers(true)) return;
+      #ifdef ARDUINO_ARCH_ESP32
+      if (!rtTask) xTaskCreatePinnedToCore(rtWriterTask, "rtRecWriter", 3072, nullptr, 1, &rtTask, 0);
+      #endif
+      rtState = RTREC_OPEN;
+      rtWakeWriter();
+      return;
+    }
+    case RTREC_RECORD:
+      if (rtStopReq || rtPendingMode) {
+        RTREC_LOCK();
+        rtState = RTREC_STOP;
+        RTREC_UNLOCK();
+      }
+      #ifndef ARDUINO_ARCH_ESP32
+      rtWriterStep();
+      #endif
+      return;
+    case RTREC_STOP:
+      rtWakeWriter();
+      return;
+    case RTREC_ERROR:
+    case RTREC_CLOSED:
+      if (rtError) USER_PRINTF("RT recorder: %s - %s.\n", rtPath, rtError);
+      else USER_PRINTF("RT recorder: %s - %u packets, %u bytes (%u raw), %u dropped.\n", rtPath, rtPackets, rtFileBytes, rtRawBytes, rtDropped);
+      rtFreeBuffers();
+      rtState = RTREC_IDLE;
+      return;
+    case RTREC_PLAY:
+      if (!rtStopReq && !rtPendingMode && rtPlayStep()) return;
+      rtFile.close();
+      if (rtError) USER_PRINTF("RT recorder: %s - %s.\n", rtPath, rtError);
+      else USER_PRINTF("RT recorder: replayed %u packets, %u us avg, %u us max.\n", rtPackets, rtPackets ? rtUsTotal / rtPackets : 0, rtUsMax);
+      rtFreeBuffers();
+      rtState = RTREC_IDLE;
+      return;
+  }
+}
+
+// {"rtrec":{...}} in a JSON state request - may run in async_tcp context
+void deserializeRtRecorder(JsonObject rec) {
+  if (rec[F("stop")] | false) rtStopReq = true;
+  const char* file = rec[F("rec")];
+  char mode = 'r';
+  if (!file) { file = rec[F("play")]; mode = 'p'; }
+  if (!file || file[0] != '/') return;
+  rtLoop = rec[F("loop")] | false;
+  rtFast = rec[F("fast")] | false;
+  RTREC_LOCK();
+  strlcpy(rtPending, file, sizeof(rtPending));
+  rtPendingMode = mode;
+  RTREC_UNLOCK();
+}
+
+void serializeRtRecorder(JsonObject rec) {
+  bool active = (rtState != RTREC_IDLE);
+  rec[F("rec")]   = (rtState == RTREC_RECORD);
+  rec[F("play")]  = (rtState == RTREC_PLAY);
+  rec[F("file")]  = active ? rtPath : "";
+  rec[F("pkts")]  = rtPackets;
+  rec[F("drop")]  = rtDropped;
+  rec[F("bytes")] = rtFileBytes;
+  rec[F("raw")]   = rtRawBytes;
+  if (rtUsTotal) {
+    rec[F("us")]    = rtPackets ? rtUsTotal / rtPackets : 0; // replay: average time in handleE131Packet()
+    rec[F("usmax")] = rtUsMax;
+  }
+}
+
+#endif
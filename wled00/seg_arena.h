@@ -0,0 +1,166 @@
+#pragma once
+#ifndef WLED_SEG_ARENA_H
+#define WLED_SEG_ARENA_H
+
+/*
+ * WLEDMM segment arena - one pre-allocated block for segment data[] and local ledsrgb[] buffers
+ *
+ * Every buffer is preceded by a small header with its size and the address of the pointer that owns it
+ * (for example &segment.data). Released buffers leave a hole; compact() slides all live buffers down
+ * and writes their new address into the owning pointers, so holes never accumulate like they do on the heap.
+ * - alloc() only takes memory above the last buffer, it never compacts by itself (other buffers may be in use)
+ * - the owner must call rebind() when the owning pointer itself moves (segment copied/moved in memory)
+ * - not thread safe, callers serialize access
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define SEG_ARENA_ALIGN 8   // enough for any struct an effect puts into data[]
+
+class SegmentArena {
+  public:
+    struct Stats {
+      size_t   capacity;    // total bytes
+      size_t   used;        // bytes in live buffers (including headers)
+      size_t   holes;       // bytes in released buffers below the top
+      size_t   free;        // capacity - used
+      size_t   largestFree; // biggest buffer that alloc() can hand out after compact()
+      size_t   largestNow;  // biggest buffer that alloc() can hand out right now
+      unsigned buffers;     // live buffers
+      uint32_t compactions; // compact() calls that moved something
+      uint32_t fails;       // alloc() calls that did not fit
+    };
+
+  private:
+    struct Block {
+      size_t size;          // payload bytes, multiple of SEG_ARENA_ALIGN
+      void*  owner;         // address of the owning pointer, nullptr = hole
+    } __attribute__((aligned(SEG_ARENA_ALIGN)));
+
+    uint8_t* _base = nullptr;
+    size_t   _capacity = 0;
+    size_t   _top = 0;      // end of the last block
+    size_t   _used = 0;
+    unsigned _buffers = 0;
+    uint32_t _compactions = 0;
+    uint32_t _fails = 0;
+
+    static size_t roundUp(size_t len) { return (len + SEG_ARENA_ALIGN - 1) & ~size_t(SEG_ARENA_ALIGN - 1); }
+    Block* blockAt(size_t offset) const { return reinterpret_cast<Block*>(_base + offset); }
+    static Block* blockOf(const void* ptr) { return reinterpret_cast<Block*>(const_cast<uint8_t*>(static_cast<const uint8_t*>(ptr)) - sizeof(Block)); }
+    static void setOwner(void* owner, void* ptr) { memcpy(owner, &ptr, sizeof(void*)); } // owner may be any pointer type
+
+    // drop holes at the end, so the next alloc() can use them again
+    void trimTop() {
+      size_t end = 0;
+      for (size_t pos = 0; pos < _top; pos += sizeof(Block) + blockAt(pos)->size)
+        if (blockAt(pos)->owner) end = pos + sizeof(Block) + blockAt(pos)->size;
+      _top = end;
+    }
+
+  public:
+    // use mem (capacity bytes, aligned to SEG_ARENA_ALIGN) - the arena must be empty
+    bool attach(void* mem, size_t capacity) {
+      if (_buffers > 0) return false;
+      _base = static_cast<uint8_t*>(mem);
+      _capacity = mem ? capacity & ~size_t(SEG_ARENA_ALIGN - 1) : 0;
+      _top = _used = 0;
+      return true;
+    }
+
+    // move all live buffers into mem and update their owners; returns the old memory (caller frees it)
+    void* moveTo(void* mem, size_t capacity) {
+      compact();
+      capacity &= ~size_t(SEG_ARENA_ALIGN - 1);
+      if (!mem || capacity < _top) return nullptr;
+      uint8_t* old = _base;
+      if (_top > 0) memcpy(mem, old, _top);
+      _base = static_cast<uint8_t*>(mem);
+      _capacity = capacity;
+      for (size_t pos = 0; pos < _top; pos += sizeof(Block) + blockAt(pos)->size)
+        setOwner(blockAt(pos)->owner, _base + pos + sizeof(Block));
+      return old;
+    }
+
+    void* base() const { return _base; }
+    size_t capacity() const { return _capacity; }
+    size_t top() const { return _top; }
+    bool empty() const { return _buffers == 0; }
+    bool contains(const void* ptr) const { return _base && ptr >= _base + sizeof(Block) && ptr < _base + _top; }
+    size_t sizeOf(const void* ptr) const { return contains(ptr) ? blockOf(ptr)->size : 0; }
+
+    // zero-initialized buffer of len bytes owned by *owner, or nullptr if it does not fit above the top
+    void* alloc(void* owner, size_t len) {
+      size_t size = roundUp(len);
+      if (!_base || len == 0 || !owner || _top + sizeof(Block) + size > _capacity) { if (len > 0) _fails++; return nullptr; }
+      Block* b = blockAt(_top);
+      b->size  = size;
+      b->owner = owner;
+      uint8_t* ptr = _base + _top + sizeof(Block);
+      memset(ptr, 0, size);
+      _top  += sizeof(Block) + size;
+      _used += sizeof(Block) + size;
+      _buffers++;
+      return ptr;
+    }
+
+    void release(void* ptr) {
+      if (!contains(ptr)) return;
+      Block* b = blockOf(ptr);
+      if (!b->owner) return; // already released
+      b->owner = nullptr;
+      _used -= sizeof(Block) + b->size;
+      _buffers--;
+      if (reinterpret_cast<uint8_t*>(ptr) + b->size == _base + _top) trimTop();
+    }
+
+    // the pointer owning ptr has moved to a new address
+    void rebind(void* ptr, void* owner) {
+      if (contains(ptr) && blockOf(ptr)->owner) blockOf(ptr)->owner = owner;
+    }
+
+    // close all holes; returns the number of bytes reclaimed. Must not run while someone uses a buffer.
+    size_t compact() {
+      size_t dst = 0;
+      for (size_t pos = 0; pos < _top; ) {
+        Block* b = blockAt(pos);
+        size_t len = sizeof(Block) + b->size;
+        if (b->owner) {
+          if (dst != pos) {
+            memmove(_base + dst, _base + pos, len);
+            setOwner(blockAt(dst)->owner, _base + dst + sizeof(Block));
+          }
+          dst += len;
+        }
+        pos += len;
+      }
+      size_t reclaimed = _top - dst;
+      if (reclaimed) _compactions++;
+      _top = dst;
+      return reclaimed;
+    }
+
+    Stats stats() const {
+      Stats s = {};
+      s.capacity = _capacity;
+      s.used     = _used;
+      s.holes    = _top - _used;
+      s.free     = _capacity - _used;
+      s.buffers  = _buffers;
+      s.compactions = _compactions;
+      s.fails    = _fails;
+      size_t tail = _capacity - _top;
+      s.largestFree = s.free > sizeof(Block) ? s.free - sizeof(Block) : 0;
+      s.largestNow  = tail > sizeof(Block) ? tail - sizeof(Block) : 0;
+      return s;
+    }
+
+    // 0 = all free memory is in one piece, 100 = completely scattered
+    static unsigned fragmentation(const Stats& s) {
+      return s.free > 0 ? 100 - unsigned((s.capacity - (s.used + s.holes)) * 100 / s.free) : 0;
+    }
+};
+
+#endif
@@ -0,0 +1,365 @@
+#include "wled.h"
+
+/*
+ * WLEDMM show sequencer - cue lists with millisecond timing
+ *
+ * A cue list maps show time (ms) to a preset or to a state delta (any JSON state object).
+ * Cues are loaded once ({"seq":{"cues":[...]}} or {"seq":{"file":"/show.json"}}), the next SEQ_SLOTS cues are
+ * decoded ahead of time in the main loop (presets are read from flash there), and strip.service() fires them
+ * on the first render tick at or after their time.
+ *
+ * Cue formats: [ms, preset] or {"t":ms, "ps":preset} or {"t":ms, <state delta>, e.g. "bri":40, "seg":[...]}
+ *
+ * Show time sources ("src"):
+ *   SEQ_SRC_INTERNAL  local clock, from "run":true (optionally starting at "pos")
+ *   SEQ_SRC_NTP       time since "at" (unix seconds, plus "atms"), so several controllers run the same show
+ *   SEQ_SRC_EXTERNAL  position sent by a player (audio position, timecode) - {"seq":{"pos":ms,"play":true}} or UDP:
+ *                     'T','C', version, flags (bit 0 = playing), position (uint32 ms, little endian)
+ * After a jump in show time only the last passed cue is applied.
+ */
+#ifdef WLED_ENABLE_SEQUENCER
+
+#define SEQ_VERSION        1
+#define SEQ_MAX_CUES       1000
+#ifndef SEQ_SLOTS
+#define SEQ_SLOTS          2      // cues decoded ahead of time
+#endif
+#ifdef ESP8266
+#define SEQ_DOC_SIZE       2048
+#else
+#define SEQ_DOC_SIZE       8192
+#endif
+#define SEQ_JUMP_MS        2000   // larger steps of show time are handled as seek
+#define SEQ_EXT_SLEW_MS    40     // smaller timecode errors are smoothed out instead of jumping
+#define SEQ_EXT_TIMEOUT_MS 3000   // external position stops advancing when the player goes quiet
+#define SEQ_LOCK_MODULE    24     // requestJSONBufferLock() id
+
+typedef struct SeqCue {
+  uint32_t t;       // show time in ms
+  uint32_t textOfs; // state delta (JSON text) in the table, if no preset
+  uint16_t textLen;
+  uint8_t  ps;      // preset, 0 = state delta
+} SeqCue;
+
+typedef struct SeqTable {
+  uint16_t count;
+  SeqCue*  cues;    // sorted by time
+  char*    text;    // follows the cues in the same allocation
+} SeqTable;
+
+typedef struct SeqSlot {
+  int32_t cue = -1; // cue decoded into doc, -1 = empty
+  bool    ready = false;
+  PSRAMDynamicJsonDocument* doc = nullptr;
+} SeqSlot;
+
+static SeqTable* seqTable = nullptr;            // main loop only
+static SeqTable* seqPending = nullptr;          // new table from deserializeSequencer()
+static char      seqPendingFile[33] = {'\0'};
+static SeqSlot   seqSlots[SEQ_SLOTS];
+
+static volatile bool    seqRunning = false;
+static volatile bool    seqRestart = false;     // re-evaluate show position on next tick
+static volatile uint8_t seqSource = SEQ_SRC_INTERNAL;
+static volatile uint32_t seqLoopMs = 0;         // > 0: show repeats
+static unsigned long seqStartMs = 0;            // SEQ_SRC_INTERNAL
+static int64_t   seqAnchorMs = 0;               // SEQ_SRC_NTP, unix time in ms
+static uint32_t  seqExtPos = 0;                 // SEQ_SRC_EXTERNAL, position at seqExtAt (guarded by seqMux)
+static unsigned long seqExtAt = 0;
+static bool      seqExtPlaying = false;
+static int32_t   seqLastPos = -1;
+static uint16_t  seqNext = 0;                   // next cue to fire
+static int32_t   seqChased = -1;                // cue fired because of a seek, not on time - not counted as lag
+static uint32_t  seqFired = 0, seqLate = 0, seqMaxLag = 0;
+
+static WiFiUDP   seqUdp;
+static bool      seqUdpConnected = false;
+
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE seqMux = portMUX_INITIALIZER_UNLOCKED;
+#define SEQ_LOCK()   portENTER_CRITICAL(&seqMux)
+#define SEQ_UNLOCK() portEXIT_CRITICAL(&seqMux)
+#else
+#define SEQ_LOCK()
+#define SEQ_UNLOCK()
+#endif
+
+// builds a cue table - may run in async_tcp context, only touches its own memory
+static SeqTable* seqBuildTable(JsonArray cues) {
+  size_t count = min(cues.size(), size_t(SEQ_MAX_CUES));
+  size_t textSize = 0;
+  size_t n = 0;
+  for (JsonVariant c : cues) {
+    if (n++ >= count) break;
+    if (c.is<JsonObject>() && c["ps"].isNull()) textSize += measureJson(c);
+  }
+  size_t cuesSize = sizeof(SeqTable) + count * sizeof(SeqCue);
+  SeqTable* table = (SeqTable*) tieredMalloc(cuesSize + textSize + 1, WLED_MEM_COLD, "sequencer");
+  if (!table) { errorFlag = ERR_LOW_MEM; return nullptr; }
+  table->cues = (SeqCue*)((uint8_t*)table + sizeof(SeqTable));
+  table->text = (char*)table + cuesSize;
+  table->count = 0;
+
+  size_t textOfs = 0;
+  n = 0;
+  for (JsonVariant c : cues) {
+    if (n++ >= count) break;
+    SeqCue cue = {0, 0, 0, 0};
+    if (c.is<JsonArray>()) {
+      cue.t  = c[0].as<uint32_t>();
+      cue.ps = c[1] | 0;
+      if (cue.ps == 0 || cue.ps > 250) continue;
+    } else if (c.is<JsonObject>()) {
+      cue.t  = c["t"].as<uint32_t>();
+      cue.ps = c["ps"] | 0;
+      if (!c["ps"].isNull() && (cue.ps == 0 || cue.ps > 250)) continue;
+      if (c["ps"].isNull()) {
+        size_t len = measureJson(c);
+        if (len > UINT16_MAX || textOfs + len > textSize) continue;
+        serializeJson(c, table->text + textOfs, len + 1); // also writes '\0', the extra byte is the next cue's (or the final) one
+        cue.textOfs = textOfs;
+        cue.textLen = len;
+        textOfs += len;
+      }
+    } else continue;
+    // keep sorted - cue lists are written in order, so this is cheap
+    int i = table->count;
+    while (i > 0 && table->cues[i-1].t > cue.t) { table->cues[i] = table->cues[i-1]; i--; }
+    table->cues[i] = cue;
+    table->count++;
+  }
+  return table;
+}
+
+// show position in ms, or -1 if the show has not started (yet)
+static int32_t seqPosition() {
+  int64_t pos;
+  switch (seqSource) {
+    case SEQ_SRC_NTP: {
+      if (toki.getTimeSource() < TOKI_TS_NTP) return -1;  // no reliable wall clock
+      Toki::Time t = toki.getTime();
+      pos = int64_t(t.sec) * 1000 + t.ms - seqAnchorMs;
+      break;
+    }
+    case SEQ_SRC_EXTERNAL: {
+      unsigned long now = millis();
+      SEQ_LOCK();
+      if (seqExtPlaying && now - seqExtAt > SEQ_EXT_TIMEOUT_MS) { // player is gone - hold
+        seqExtPos += SEQ_EXT_TIMEOUT_MS;
+        seqExtAt = now;
+        seqExtPlaying = false;
+      }
+      pos = int64_t(seqExtPos) + (seqExtPlaying ? int64_t(now - seqExtAt) : 0);
+      SEQ_UNLOCK();
+      break;
+    }
+    default:
+      pos = millis() - seqStartMs;
+      break;
+  }
+  if (pos < 0 || pos > INT32_MAX) return -1;
+  if (seqLoopMs > 0) pos %= seqLoopMs;
+  return int32_t(pos);
+}
+
+// show position for other modules (fseq player), -1 = sequencer stopped
+int32_t sequencerPosition() {
+  return seqRunning ? seqPosition() : -1;
+}
+
+// new position from a player: small errors are smoothed (network jitter), big ones are jumps
+// called from the main loop (timecode packets) and from async_tcp (JSON)
+static void seqSetExternal(uint32_t pos, bool playing) {
+  unsigned long now = millis();
+  SEQ_LOCK();
+  int32_t predicted = int32_t(seqExtPos + (seqExtPlaying ? now - seqExtAt : 0));
+  int32_t err = int32_t(pos) - predicted;
+  if (seqExtPlaying && playing && abs(err) <= SEQ_EXT_SLEW_MS) pos = predicted + err / 4;
+  seqExtPos = pos;
+  seqExtAt = now;
+  seqExtPlaying = playing;
+  SEQ_UNLOCK();
+}
+
+static void seqSeek(int32_t pos) {
+  unsigned i = 0;
+  if (seqTable) while (i < seqTable->count && int32_t(seqTable->cues[i].t) <= pos) i++;
+  seqNext = (i > 0) ? i - 1 : 0; // chase: the last passed cue fires right away
+  seqChased = (i > 0) ? int32_t(seqNext) : -1;
+}
+
+static void seqClearSlots() {
+  for (unsigned i = 0; i < SEQ_SLOTS; i++) { seqSlots[i].cue = -1; seqSlots[i].ready = false; }
+}
+
+// decode a cue into its slot; presets need flash access, so not from strip.service() unless we must
+static bool seqPrepare(unsigned idx) {
+  SeqSlot& slot = seqSlots[idx % SEQ_SLOTS];
+  const SeqCue& cue = seqTable->cues[idx];
+  if (!slot.doc) slot.doc = new(std::nothrow) PSRAMDynamicJsonDocument(SEQ_DOC_SIZE);
+  if (!slot.doc) return false;
+  slot.cue = idx;
+  slot.ready = false;
+  if (cue.ps == 0) {
+    if (deserializeJson(*slot.doc, seqTable->text + cue.textOfs, cue.textLen)) return false;
+    slot.doc->remove("t");
+  } else {
+    #ifdef ARDUINO_ARCH_ESP32
+    unsigned long start = millis();
+    while (strip.isUpdating() && millis() - start < FRAMETIME_FIXED) delay(1); // accessing FS during sendout causes glitches
+    #endif
+    if (!readObjectFromFileUsingId("/presets.json", cue.ps, slot.doc)) return false;
+    if (slot.doc->overflowed() || !(*slot.doc)["win"].isNull()) return false; // too big, or HTTP API preset - applyPreset() will do
+    slot.doc->remove("ps"); // no recursion
+  }
+  slot.ready = !slot.doc->overflowed();
+  return slot.ready;
+}
+
+static void seqFire(unsigned idx, int32_t pos) {
+  const SeqCue& cue = seqTable->cues[idx];
+  SeqSlot& slot = seqSlots[idx % SEQ_SLOTS];
+  if (int32_t(idx) != seqChased) {
+    uint32_t lag = pos - cue.t;
+    if (lag > seqMaxLag) seqMaxLag = lag;
+  } else seqChased = -1; // a chased cue is late by design
+  seqFired++;
+  if (slot.cue != int32_t(idx) || !slot.ready) {
+    seqLate++;
+    if (cue.ps > 0) { applyPreset(cue.ps, CALL_MODE_NO_NOTIFY); slot.cue = -1; return; } // the slow way
+    if (!seqPrepare(idx)) { slot.cue = -1; return; }
+  }
+  JsonObject state = slot.doc->as<JsonObject>();
+  deserializeState(state, CALL_MODE_NO_NOTIFY, cue.ps);
+  if (cue.ps > 0) currentPreset = cue.ps;
+  slot.cue = -1;
+  slot.ready = false;
+}
+
+// strip.service(), on the render tick before effects draw
+void sequencerService() {
+  if (!seqRunning || !seqTable || seqTable->count == 0) return;
+  int32_t pos = seqPosition();
+  if (pos < 0) return;
+  if (seqRestart || seqLastPos < 0 || pos < seqLastPos || pos - seqLastPos > SEQ_JUMP_MS) seqSeek(pos);
+  seqRestart = false;
+  seqLastPos = pos;
+  if (seqNext >= seqTable->count || int32_t(seqTable->cues[seqNext].t) > pos) return;
+  if (!tryJSONBufferLock(SEQ_LOCK_MODULE)) return; // someone else holds the JSON buffer - fire on the next tick instead of waiting
+  while (seqNext < seqTable->count && int32_t(seqTable->cues[seqNext].t) <= pos) seqFire(seqNext++, pos);
+  releaseJSONBufferLock();
+  if (seqNext >= seqTable->count && seqLoopMs == 0 && seqSource == SEQ_SRC_INTERNAL) seqRunning = false; // show is over
+}
+
+void initSequencer() {
+  seqUdpConnected = false;
+  if (seqPort == 0) return;
+  seqUdpConnected = seqUdp.begin(seqPort);
+}
+
+static void seqLoadFile(const char* file) {
+  if (!requestJSONBufferLock(SEQ_LOCK_MODULE)) return;
+  if (readObjectFromFile(file, nullptr, &doc)) {
+    JsonArray cues = doc.is<JsonArray>() ? doc.as<JsonArray>() : doc[F("cues")].as<JsonArray>();
+    SeqTable* table = seqBuildTable(cues);
+    if (table) {
+      if (seqTable) free(seqTable);
+      seqTable = table;
+      seqClearSlots();
+      seqRestart = true;
+      USER_PRINTF("Sequencer: %u cues from %s.\n", table->count, file);
+    }
+  } else USER_PRINTF("Sequencer: could not read %s.\n", file);
+  releaseJSONBufferLock();
+}
+
+// main loop: new cue lists, timecode packets, decode the next cues
+void handleSequencer() {
+  SEQ_LOCK();
+  SeqTable* table = seqPending;
+  seqPending = nullptr;
+  char file[sizeof(seqPendingFile)];
+  strcpy(file, seqPendingFile);
+  seqPendingFile[0] = '\0';
+  SEQ_UNLOCK();
+  if (table) {
+    if (seqTable) free(seqTable);
+    seqTable = table;
+    seqClearSlots();
+    seqRestart = true;
+  }
+  if (file[0]) seqLoadFile(file);
+
+  if (seqUdpConnected) {
+    uint8_t buf[8];
+    int size;
+    while ((size = seqUdp.parsePacket()) > 0) {
+      int len = seqUdp.read(buf, min(size, int(sizeof(buf))));
+      if (size > len) seqUdp.flush();
+      if (len < 8 || buf[0] != 'T' || buf[1] != 'C' || buf[2] != SEQ_VERSION) continue;
+      if (seqSource != SEQ_SRC_EXTERNAL) continue;
+      seqSetExternal(uint32_t(buf[4]) | (uint32_t(buf[5]) << 8) | (uint32_t(buf[6]) << 16) | (uint32_t(buf[7]) << 24), buf[3] & 0x01);
+    }
+  }
+
+  if (!seqRunning || !seqTable) return;
+  for (unsigned k = 0; k < SEQ_SLOTS; k++) {
+    unsigned idx = seqNext + k;
+    if (idx >= seqTable->count) break;
+    if (seqSlots[idx % SEQ_SLOTS].cue == int32_t(idx)) continue;
+    if (seqTable->cues[idx].ps > 0) {
+      if (!requestJSONBufferLock(SEQ_LOCK_MODULE)) break; // fileDoc and the preset file are shared
+      seqPrepare(idx);
+      releaseJSONBufferLock();
+    } else seqPrepare(idx);
+  }
+}
+
+// {"seq":{...}} in a JSON state request - may run in async_tcp context
+void deserializeSequencer(JsonObject seq) {
+  JsonArray cues = seq[F("cues")];
+  if (!cues.isNull()) {
+    SeqTable* table = seqBuildTable(cues);
+    SEQ_LOCK();
+    SeqTable* old = seqPending;
+    seqPending = table;
+    SEQ_UNLOCK();
+    if (old) free(old);
+  }
+  const char* file = seq[F("file")];
+  if (file && file[0] == '/') {
+    SEQ_LOCK();
+    strlcpy(seqPendingFile, file, sizeof(seqPendingFile));
+    SEQ_UNLOCK();
+  }
+  uint8_t src = seq[F("src")] | uint8_t(seqSource);
+  if (src <= SEQ_SRC_EXTERNAL) seqSource = src;
+  seqLoopMs = seq[F("len")] | uint32_t(seqLoopMs);
+  if (!seq[F("at")].isNull()) seqAnchorMs = int64_t(seq[F("at")].as<uint32_t>()) * 1000 + (seq[F("atms")] | 0);
+
+  int32_t pos = seq[F("pos")] | -1;
+  if (pos >= 0) {
+    if (seqSource == SEQ_SRC_EXTERNAL) seqSetExternal(pos, seq[F("play")] | true);
+    else seqStartMs = millis() - pos;
+  }
+  if (!seq[F("run")].isNull()) {
+    bool run = seq[F("run")];
+    if (run && !seqRunning && pos < 0 && seqSource == SEQ_SRC_INTERNAL) seqStartMs = millis(); // start from the top
+    seqRunning = run;
+    seqRestart = true;
+  }
+}
+
+void serializeSequencer(JsonObject seq) {
+  seq[F("run")] = seqRunning;
+  seq[F("src")] = seqSource;
+  seq[F("pos")] = seqLastPos;
+  seq[F("cue")] = seqNext;
+  seq["n"]      = seqTable ? seqTable->count : 0;
+  seq[F("len")] = seqLoopMs;
+  seq[F("fired")] = seqFired;
+  seq[F("late")]  = seqLate;   // cues that were not decoded ahead of time
+  seq[F("lag")]   = seqMaxLag; // max ms between cue time and the tick that fired it (cues chased after a seek excluded)
+}
+
+#endif
@@ -96,7 +96,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     }
 
     uint8_t colorOrder, type, skip, awmode, channelSwap, artnet_outputs, artnet_fps_limit;
-    uint16_t length, start, artnet_leds_per_output;
+    uint16_t length, artnet_leds_per_output;
+    pixel_index_t start;
     uint8_t pins[5] = {255, 255, 255, 255, 255};
 
     autoSegments = request->hasArg(F("MS"));
@@ -337,6 +338,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     t = request->arg(F("UR")).toInt();
     if ((t>=0) && (t<30)) udpNumRetries = t;
+    syncDelta = request->hasArg(F("UD"));
 
 
     nodeListEnabled = request->hasArg(F("NL"));
@@ -357,6 +359,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     if (t >= 0  && t <= 150) DMXSegmentSpacing = t;
     t = request->arg(F("PY")).toInt();
     if (t >= 0  && t <= 200) e131Priority = t;
+    t = request->arg(F("MM")).toInt();
+    if (t >= DMX_MERGE_OFF && t <= DMX_MERGE_LTP) e131MergeMode = t;
     t = request->arg(F("DM")).toInt();
     if (t >= DMX_MODE_DISABLED && t <= DMX_MODE_PRESET) DMXMode = t;
     t = request->arg(F("ET")).toInt();
@@ -1,4 +1,7 @@
 #include "wled.h"
+#ifdef WLED_ENABLE_ESPNOW_SYNC
+#include "espnow_sync.h"
+#endif
 
 /*
  * UDP sync notifier / Realtime / Hyperion / TPM2.NET
@@ -10,9 +13,59 @@
 #define UDP_IN_MAXSIZE 1472
 #define PRESUMED_NETWORK_DELAY 3 //how many ms could it take on avg to reach the receiver? This will be added to transmitted times
 
+// one segment in a sync notification (UDP_SEG_SIZE bytes), shared by the legacy and the delta protocol
+static void packSyncSegment(byte* out, const Segment& selseg, uint8_t id)
+{
+  out[0 ] = id;
+  out[1 ] = selseg.start >> 8;
+  out[2 ] = selseg.start & 0xFF;
+  out[3 ] = selseg.stop >> 8;
+  out[4 ] = selseg.stop & 0xFF;
+  out[5 ] = selseg.grouping;
+  out[6 ] = selseg.spacing;
+  out[7 ] = selseg.offset >> 8;
+  out[8 ] = selseg.offset & 0xFF;
+  out[9 ] = selseg.options & 0x8F; //only take into account selected, mirrored, on, reversed, reverse_y (for 2D); ignore freeze, reset, transitional
+  out[10] = selseg.opacity;
+  out[11] = selseg.mode;
+  out[12] = selseg.speed;
+  out[13] = selseg.intensity;
+  out[14] = selseg.palette;
+  out[15] = R(selseg.colors[0]);
+  out[16] = G(selseg.colors[0]);
+  out[17] = B(selseg.colors[0]);
+  out[18] = W(selseg.colors[0]);
+  out[19] = R(selseg.colors[1]);
+  out[20] = G(selseg.colors[1]);
+  out[21] = B(selseg.colors[1]);
+  out[22] = W(selseg.colors[1]);
+  out[23] = R(selseg.colors[2]);
+  out[24] = G(selseg.colors[2]);
+  out[25] = B(selseg.colors[2]);
+  out[26] = W(selseg.colors[2]);
+  out[27] = selseg.cct;
+  out[28] = (selseg.options>>8) & 0xFF; //mirror_y, transpose, 2D mapping & sound
+  out[29] = selseg.custom1;
+  out[30] = selseg.custom2;
+  out[31] = selseg.custom3 | (selseg.check1<<5) | (selseg.check2<<6) | (selseg.check3<<7);
+  out[32] = selseg.startY >> 8;
+  out[33] = selseg.startY & 0xFF;
+  out[34] = selseg.stopY >> 8;
+  out[35] = selseg.stopY & 0xFF;
+}
+
+#ifndef WLED_DISABLE_SYNC_DELTA
+static void notifyDelta(byte callMode, bool followUp);
+#endif
+
 void notify(byte callMode, bool followUp)
 {
-  if (!udpConnected) return;
+  #ifdef WLED_ENABLE_ESPNOW_SYNC
+  bool sendEspNow = (espNowSyncMode & ESPNOW_SYNC_NOTIFY); // WLEDMM ESP-NOW always gets the full notification (no ACKs there)
+  #else
+  const bool sendEspNow = false;
+  #endif
+  if (!udpConnected && !sendEspNow) return;
   if (!syncGroups) return;
   switch (callMode)
   {
@@ -26,6 +79,11 @@ void notify(byte callMode, bool followUp)
     case CALL_MODE_ALEXA:         if (!notifyAlexa)  return; break;
     default: return;
   }
+  bool sendUdp = udpConnected;
+  #ifndef WLED_DISABLE_SYNC_DELTA
+  if (syncDelta && udpConnected) { notifyDelta(callMode, followUp); sendUdp = false; } // WLEDMM only changed segments, ACKed by receivers
+  #endif
+  if (!sendUdp && !sendEspNow) return;
   byte udpOut[WLEDPACKETSIZE];
   Segment& mainseg = strip.getMainSegment();
   udpOut[0] = 0; //0: wled notifier protocol 1: WARLS protocol
@@ -95,43 +153,7 @@ void notify(byte callMode, bool followUp)
   for (size_t i = 0; i < nsegs; i++) {
     Segment &selseg = strip.getSegment(i);
     if (!selseg.isActive()) continue;
-    uint16_t ofs = 41 + s*UDP_SEG_SIZE; //start of segment offset byte
-    udpOut[0 +ofs] = s;
-    udpOut[1 +ofs] = selseg.start >> 8;
-    udpOut[2 +ofs] = selseg.start & 0xFF;
-    udpOut[3 +ofs] = selseg.stop >> 8;
-    udpOut[4 +ofs] = selseg.stop & 0xFF;
-    udpOut[5 +ofs] = selseg.grouping;
-    udpOut[6 +ofs] = selseg.spacing;
-    udpOut[7 +ofs] = selseg.offset >> 8;
-    udpOut[8 +ofs] = selseg.offset & 0xFF;
-    udpOut[9 +ofs] = selseg.options & 0x8F; //only take into account selected, mirrored, on, reversed, reverse_y (for 2D); ignore freeze, reset, transitional
-    udpOut[10+ofs] = selseg.opacity;
-    udpOut[11+ofs] = selseg.mode;
-    udpOut[12+ofs] = selseg.speed;
-    udpOut[13+ofs] = selseg.intensity;
-    udpOut[14+ofs] = selseg.palette;
-    udpOut[15+ofs] = R(selseg.colors[0]);
-    udpOut[16+ofs] = G(selseg.colors[0]);
-    udpOut[17+ofs] = B(selseg.colors[0]);
-    udpOut[18+ofs] = W(selseg.colors[0]);
-    udpOut[19+ofs] = R(selseg.colors[1]);
-    udpOut[20+ofs] = G(selseg.colors[1]);
-    udpOut[21+ofs] = B(selseg.colors[1]);
-    udpOut[22+ofs] = W(selseg.colors[1]);
-    udpOut[23+ofs] = R(selseg.colors[2]);
-    udpOut[24+ofs] = G(selseg.colors[2]);
-    udpOut[25+ofs] = B(selseg.colors[2]);
-    udpOut[26+ofs] = W(selseg.colors[2]);
-    udpOut[27+ofs] = selseg.cct;
-    udpOut[28+ofs] = (selseg.options>>8) & 0xFF; //mirror_y, transpose, 2D mapping & sound
-    udpOut[29+ofs] = selseg.custom1;
-    udpOut[30+ofs] = selseg.custom2;
-    udpOut[31+ofs] = selseg.custom3 | (selseg.check1<<5) | (selseg.check2<<6) | (selseg.check3<<7);
-    udpOut[32+ofs] = selseg.startY >> 8;
-    udpOut[33+ofs] = selseg.startY & 0xFF;
-    udpOut[34+ofs] = selseg.stopY >> 8;
-    udpOut[35+ofs] = selseg.stopY & 0xFF;
+    packSyncSegment(udpOut + 41 + s*UDP_SEG_SIZE, selseg, s);
     ++s;
   }
 
@@ -141,10 +163,14 @@ void notify(byte callMode, bool followUp)
   IPAddress broadcastIp;
   broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
 
-  if (0 != notifierUdp.beginPacket(broadcastIp, udpPort)) { // WLEDMM beginPacket == 0 --> error
+  #ifdef WLED_ENABLE_ESPNOW_SYNC
+  if (sendEspNow) espNowSyncSend(ESPNOW_MSG_SYNC, udpOut, WLEDPACKETSIZE);
+  #endif
+  if (sendUdp && 0 != notifierUdp.beginPacket(broadcastIp, udpPort)) { // WLEDMM beginPacket == 0 --> error
     notifierUdp.write(udpOut, WLEDPACKETSIZE);
     notifierUdp.endPacket();
   }
+  if (!sendUdp && udpConnected) return; // WLEDMM notifyDelta() did the bookkeeping
   notificationSentCallMode = callMode;
   notificationSentTime = millis();
   notificationCount = followUp ? notificationCount + 1 : 0;
@@ -233,6 +259,389 @@ void sendTPM2Ack() {
   }
 }
 
+// apply one segment of a sync notification (see packSyncSegment())
+static void applySyncSegment(const byte* in, byte version, bool applyEffects, bool someSel)
+{
+  uint8_t id = in[0];
+  if (id >= strip.getSegmentsNum()) return;
+  Segment& selseg = strip.getSegment(id);
+  if (!selseg.isActive() || !selseg.isSelected()) return; //do not apply to non selected segments
+
+  uint16_t startY = 0, start  = (in[1] << 8 | in[2]);
+  uint16_t stopY  = 1, stop   = (in[3] << 8 | in[4]);
+  uint16_t offset = (in[7] << 8 | in[8]);
+  if (!receiveSegmentOptions) {
+    selseg.setUp(start, stop, selseg.grouping, selseg.spacing, offset, startY, stopY);
+    return;
+  }
+  //for (size_t j = 1; j<4; j++) selseg.setOption(j, (in[9] >> j) & 0x01); //only take into account mirrored, on, reversed; ignore selected
+  selseg.options = (selseg.options & 0x0071U) | (in[9] & 0x0E); // ignore selected, freeze, reset & transitional
+  selseg.setOpacity(in[10]);
+  if (applyEffects) {
+    strip.setMode(id,  in[11]);
+    selseg.speed     = in[12];
+    selseg.intensity = in[13];
+    selseg.palette   = in[14];
+  }
+  if (receiveNotificationColor || !someSel) {
+    selseg.setColor(0, RGBW32(in[15],in[16],in[17],in[18]));
+    selseg.setColor(1, RGBW32(in[19],in[20],in[21],in[22]));
+    selseg.setColor(2, RGBW32(in[23],in[24],in[25],in[26]));
+    selseg.setCCT(in[27]);
+  }
+  if (version > 11) {
+    // when applying synced options ignore selected as it may be used as indicator of which segments to sync
+    // freeze, reset should never be synced
+    // LSB to MSB: select, reverse, on, mirror, freeze, reset, reverse_y, mirror_y, transpose, map1d2d (3), ssim (2), set (2)
+    selseg.options = (selseg.options & 0b0000000000110001U) | (in[28]<<8) | (in[9] & 0b11001110U); // ignore selected, freeze, reset
+    if (applyEffects) {
+      selseg.custom1 = in[29];
+      selseg.custom2 = in[30];
+      selseg.custom3 = in[31] & 0x1F;
+      selseg.check1  = (in[31]>>5) & 0x1;
+      selseg.check2  = (in[31]>>6) & 0x1; // WLEDMM was check1 three times
+      selseg.check3  = (in[31]>>7) & 0x1;
+    }
+    startY = (in[32] << 8 | in[33]);
+    stopY  = (in[34] << 8 | in[35]);
+  }
+  if (receiveSegmentBounds) {
+    selseg.setUp(start, stop, in[5], in[6], offset, startY, stopY);
+  } else {
+    selseg.setUp(selseg.start, selseg.stop, in[5], in[6], selseg.offset, selseg.startY, selseg.stopY);
+  }
+}
+
+// adjust system time, but only if sender is more accurate than self. in: time source, unix time (4 bytes), ms (2 bytes)
+static void applySyncTime(const byte* in, bool timebaseUpdated)
+{
+  Toki::Time tm;
+  tm.sec = (in[1] << 24) | (in[2] << 16) | (in[3] << 8) | (in[4]);
+  tm.ms = (in[5] << 8) | (in[6]);
+  if (in[0] > toki.getTimeSource()) { //if sender's time source is more accurate
+    toki.adjust(tm, PRESUMED_NETWORK_DELAY); //adjust trivially for network delay
+    uint8_t ts = TOKI_TS_UDP;
+    if (in[0] > 99) ts = TOKI_TS_UDP_NTP;
+    else if (in[0] >= TOKI_TS_SEC) ts = TOKI_TS_UDP_SEC;
+    toki.setTime(tm, ts);
+  } else if (timebaseUpdated && toki.getTimeSource() > 99) { //if we both have good times, get a more accurate timebase
+    Toki::Time myTime = toki.getTime();
+    uint32_t diff = toki.msDifference(tm, myTime);
+    strip.timebase -= PRESUMED_NETWORK_DELAY; //no need to presume, use difference between NTP times at send and receive points
+    if (toki.isLater(tm, myTime)) {
+      strip.timebase += diff;
+    } else {
+      strip.timebase -= diff;
+    }
+  }
+}
+
+#ifndef WLED_DISABLE_SYNC_DELTA
+/*
+ * WLEDMM delta sync: only segments that changed since the last notification are sent, with a revision number.
+ * Receivers acknowledge every revision (unicast), the sender repeats a packet only while known receivers have not
+ * acknowledged it. A receiver that missed a revision asks for the full state.
+ *
+ * DELTA (broadcast): type, version, call mode, sync groups, revision (uint32), flags, bri, nightlight minutes,
+ *                    transition (uint16), effect time (uint32), time source, unix time (uint32), ms (uint16),
+ *                    main segment id, number of segments, segment size, segments (see packSyncSegment())
+ * ACK (unicast):     type, version, revision (uint32), flags (bit0: send full state)
+ */
+#define UDP_SYNC_DELTA        0xD5
+#define UDP_SYNC_ACK          0xD6
+#define UDP_DELTA_VERSION     1
+#define UDP_DELTA_HEADER      27
+#define UDP_DELTA_SIZE        (UDP_DELTA_HEADER + MAX_NUM_SEGMENTS*UDP_SEG_SIZE)
+#define UDP_DELTA_F_FULL      0x01  // packet contains all active segments
+#define UDP_DELTA_F_NL        0x02  // nightlight active
+#define UDP_ACK_F_NEEDFULL    0x01
+#define UDP_DELTA_PEERS       16
+#define UDP_DELTA_PEER_AGE    60000 // forget receivers that did not ACK for one minute
+#define UDP_DELTA_RETRY_MS    100
+#define UDP_DELTA_MIN_RETRIES 3
+
+typedef struct {
+  uint32_t      ip;
+  uint32_t      revision;   // sender: last acknowledged revision, receiver: last applied revision
+  unsigned long lastSeen;
+} SyncDeltaPeer;
+
+static byte          deltaOut[UDP_DELTA_SIZE];                 // last packet, kept for retransmission
+static size_t        deltaOutLen = 0;
+static uint32_t      deltaRevision = 0;
+static byte          deltaLastSent[MAX_NUM_SEGMENTS][UDP_SEG_SIZE]; // what receivers have seen
+static bool          deltaLastValid[MAX_NUM_SEGMENTS] = {false};
+static SyncDeltaPeer deltaReceivers[UDP_DELTA_PEERS];          // nodes that ACK our packets
+static SyncDeltaPeer deltaSenders[UDP_DELTA_PEERS];            // nodes we receive from
+
+static SyncDeltaPeer* findSyncPeer(SyncDeltaPeer* peers, uint32_t ip, bool create) {
+  SyncDeltaPeer* oldest = &peers[0];
+  for (unsigned i = 0; i < UDP_DELTA_PEERS; i++) {
+    if (peers[i].ip == ip) return &peers[i];
+    if (!oldest->ip) continue; // free slot found
+    if (!peers[i].ip || (peers[i].lastSeen < oldest->lastSeen)) oldest = &peers[i];
+  }
+  if (!create) return nullptr;
+  oldest->ip = ip;
+  oldest->revision = 0;
+  oldest->lastSeen = millis();
+  return oldest;
+}
+
+static size_t buildDeltaPacket(byte* out, byte callMode, bool full, bool commit) {
+  out[0] = UDP_SYNC_DELTA;
+  out[1] = UDP_DELTA_VERSION;
+  out[2] = callMode;
+  out[3] = syncGroups;
+  out[4] = deltaRevision & 0xFF; out[5] = (deltaRevision >> 8) & 0xFF; out[6] = (deltaRevision >> 16) & 0xFF; out[7] = deltaRevision >> 24;
+  out[8] = (full ? UDP_DELTA_F_FULL : 0) | (nightlightActive ? UDP_DELTA_F_NL : 0);
+  out[9] = bri;
+  out[10] = nightlightDelayMins;
+  out[11] = transitionDelay & 0xFF; out[12] = transitionDelay >> 8;
+  uint32_t t = millis() + strip.timebase;
+  out[13] = (t >> 24) & 0xFF; out[14] = (t >> 16) & 0xFF; out[15] = (t >> 8) & 0xFF; out[16] = t & 0xFF;
+  out[17] = toki.getTimeSource();  // same layout as applySyncTime()
+  Toki::Time tm = toki.getTime();
+  out[18] = (tm.sec >> 24) & 0xFF; out[19] = (tm.sec >> 16) & 0xFF; out[20] = (tm.sec >> 8) & 0xFF; out[21] = tm.sec & 0xFF;
+  out[22] = (tm.ms >> 8) & 0xFF; out[23] = tm.ms & 0xFF;
+  out[24] = strip.getMainSegmentId();
+  out[26] = UDP_SEG_SIZE;
+
+  size_t n = 0;
+  for (size_t i = 0; i < strip.getSegmentsNum() && i < MAX_NUM_SEGMENTS; i++) {
+    Segment &selseg = strip.getSegment(i);
+    if (!selseg.isActive()) { if (commit) deltaLastValid[i] = false; continue; }
+    byte* seg = out + UDP_DELTA_HEADER + n*UDP_SEG_SIZE;
+    packSyncSegment(seg, selseg, i);
+    if (!full && deltaLastValid[i] && memcmp(seg, deltaLastSent[i], UDP_SEG_SIZE) == 0) continue; // unchanged
+    if (commit) { memcpy(deltaLastSent[i], seg, UDP_SEG_SIZE); deltaLastValid[i] = true; }
+    n++;
+  }
+  out[25] = n;
+  return UDP_DELTA_HEADER + n*UDP_SEG_SIZE;
+}
+
+static void notifyDelta(byte callMode, bool followUp) {
+  if (!followUp) {
+    deltaRevision++;
+    deltaOutLen = buildDeltaPacket(deltaOut, callMode, false, true);
+  }
+  IPAddress broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+  if (0 != notifierUdp.beginPacket(broadcastIp, udpPort)) {
+    notifierUdp.write(deltaOut, deltaOutLen);
+    notifierUdp.endPacket();
+  }
+  notificationSentCallMode = callMode;
+  notificationSentTime = millis();
+  notificationCount = followUp ? notificationCount + 1 : 0;
+}
+
+// repeat the last packet only while known receivers are missing it
+static void handleDeltaRetransmit() {
+  if (!deltaOutLen || (millis() - notificationSentTime) < UDP_DELTA_RETRY_MS) return;
+  bool anyReceiver = false, missing = false;
+  for (unsigned i = 0; i < UDP_DELTA_PEERS; i++) {
+    if (!deltaReceivers[i].ip || (millis() - deltaReceivers[i].lastSeen > UDP_DELTA_PEER_AGE)) continue;
+    anyReceiver = true;
+    if (deltaReceivers[i].revision != deltaRevision) missing = true;
+  }
+  if (!anyReceiver) { // nobody has answered yet (e.g. older WLED-MM versions) - fall back to blind retransmissions
+    if ((notificationCount < udpNumRetries) && ((millis()-notificationSentTime) > 250)) notify(notificationSentCallMode, true);
+    return;
+  }
+  if (missing && (notificationCount < max(udpNumRetries, uint8_t(UDP_DELTA_MIN_RETRIES)))) notify(notificationSentCallMode, true);
+}
+
+static void sendDeltaAck(IPAddress ip, uint32_t revision, bool needFull) {
+  byte ack[7] = { UDP_SYNC_ACK, UDP_DELTA_VERSION, byte(revision & 0xFF), byte((revision >> 8) & 0xFF), byte((revision >> 16) & 0xFF), byte(revision >> 24), byte(needFull ? UDP_ACK_F_NEEDFULL : 0) };
+  if (0 != notifierUdp.beginPacket(ip, udpPort)) {
+    notifierUdp.write(ack, sizeof(ack));
+    notifierUdp.endPacket();
+  }
+}
+
+static void handleDeltaPacket(const byte* in, size_t len, IPAddress remoteIP) {
+  if (len < 7 || in[1] != UDP_DELTA_VERSION) return;
+  uint32_t revision = in[2] | (in[3] << 8) | (in[4] << 16) | (uint32_t(in[5]) << 24);
+
+  if (in[0] == UDP_SYNC_ACK) {
+    if (!syncDelta) return;
+    SyncDeltaPeer* peer = findSyncPeer(deltaReceivers, uint32_t(remoteIP), true);
+    peer->revision = revision;
+    peer->lastSeen = millis();
+    if (in[6] & UDP_ACK_F_NEEDFULL) { // receiver missed something - send everything, to this receiver only
+      static byte fullOut[UDP_DELTA_SIZE];
+      size_t fullLen = buildDeltaPacket(fullOut, notificationSentCallMode, true, false);
+      if (0 != notifierUdp.beginPacket(remoteIP, udpPort)) {
+        notifierUdp.write(fullOut, fullLen);
+        notifierUdp.endPacket();
+      }
+    }
+    return;
+  }
+
+  // UDP_SYNC_DELTA
+  if (len < UDP_DELTA_HEADER || in[26] != UDP_SEG_SIZE || len < UDP_DELTA_HEADER + size_t(in[25])*UDP_SEG_SIZE) return;
+  if (!(receiveGroups & in[3])) return;
+  revision = in[4] | (in[5] << 8) | (in[6] << 16) | (uint32_t(in[7]) << 24);
+  SyncDeltaPeer* sender = findSyncPeer(deltaSenders, uint32_t(remoteIP), false);
+  bool known = (sender != nullptr);
+  if (!known) sender = findSyncPeer(deltaSenders, uint32_t(remoteIP), true);
+  sender->lastSeen = millis();
+  bool full = in[8] & UDP_DELTA_F_FULL;
+  if (known && revision == sender->revision && !full) { sendDeltaAck(remoteIP, revision, false); return; } // repeated packet
+  // a gap means we lost segment changes - apply this one and ask for everything (a sender reboot restarts at revision 1)
+  bool needFull = !full && (!known || ((revision != sender->revision + 1) && (revision != 1)));
+  sender->revision = revision;
+  sendDeltaAck(remoteIP, revision, needFull);
+
+  if (realtimeMode || !receiveNotifications) return;
+  if (millis() - notificationSentTime < 1000) return; //ignore notification if received within a second after sending a notification ourselves
+
+  bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
+  bool applyEffects = (receiveNotificationEffects || !someSel);
+  uint8_t numSegs = in[25];
+  const byte* segs = in + UDP_DELTA_HEADER;
+
+  if (numSegs > 0 && applyEffects && currentPlaylist >= 0) unloadPlaylist();
+  if (receiveSegmentOptions || receiveSegmentBounds) {
+    for (size_t i = 0; i < numSegs; i++) applySyncSegment(segs + i*UDP_SEG_SIZE, 12, applyEffects, someSel);
+  } else {
+    // simple sync: main segment of the sender applies to all selected segments
+    for (size_t i = 0; i < numSegs; i++) {
+      const byte* seg = segs + i*UDP_SEG_SIZE;
+      if (seg[0] != in[24]) continue;
+      if (receiveNotificationColor || !someSel) {
+        strip.setColor(0, RGBW32(seg[15], seg[16], seg[17], seg[18]));
+        strip.setColor(1, RGBW32(seg[19], seg[20], seg[21], seg[22]));
+        strip.setColor(2, RGBW32(seg[23], seg[24], seg[25], seg[26]));
+        if (strip.hasCCTBus()) strip.setCCT(seg[27]);
+      }
+      if (applyEffects) {
+        for (size_t s = 0; s < strip.getSegmentsNum(); s++) {
+          Segment& selseg = strip.getSegment(s);
+          if (!selseg.isActive() || !selseg.isSelected()) continue;
+          selseg.setMode(seg[11]);
+          selseg.speed = seg[12];
+          selseg.intensity = seg[13];
+          selseg.setPalette(seg[14]);
+        }
+      }
+    }
+  }
+  if (numSegs > 0) stateChanged = true;
+
+  if (applyEffects) {
+    uint32_t t = (in[13] << 24) | (in[14] << 16) | (in[15] << 8) | (in[16]);
+    strip.timebase = t + PRESUMED_NETWORK_DELAY - millis();
+  }
+  applySyncTime(in + 17, applyEffects);
+  transitionDelayTemp = in[11] | (in[12] << 8);
+  nightlightActive = in[8] & UDP_DELTA_F_NL;
+  if (nightlightActive) nightlightDelayMins = in[10];
+  if (receiveNotificationBrightness || !someSel) bri = in[9];
+  stateUpdated(CALL_MODE_NOTIFICATION);
+}
+#endif
+
+// wled notifier packet (protocol 0) - WLEDMM also used for notifications received via ESP-NOW
+static void handleNotifierPacket(const byte* udpIn)
+{
+  //ignore notification if received within a second after sending a notification ourselves
+  if (millis() - notificationSentTime < 1000) return;
+  if (udpIn[1] > 199) return; //do not receive custom versions
+
+  //compatibilityVersionByte:
+  byte version = udpIn[11];
+
+  // if we are not part of any sync group ignore message
+  if (version < 9 || version > 199) {
+    // legacy senders are treated as if sending in sync group 1 only
+    if (!(receiveGroups & 0x01)) return;
+  } else if (!(receiveGroups & udpIn[36])) return;
+
+  bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
+
+  //apply colors from notification to main segment, only if not syncing full segments
+  if ((receiveNotificationColor || !someSel) && (version < 11 || !receiveSegmentOptions)) {
+    // primary color, only apply white if intended (version > 0)
+    strip.setColor(0, RGBW32(udpIn[3], udpIn[4], udpIn[5], (version > 0) ? udpIn[10] : 0));
+    if (version > 1) {
+      strip.setColor(1, RGBW32(udpIn[12], udpIn[13], udpIn[14], udpIn[15])); // secondary color
+    }
+    if (version > 6) {
+      strip.setColor(2, RGBW32(udpIn[20], udpIn[21], udpIn[22], udpIn[23])); // tertiary color
+      if (version > 9 && version < 200 && udpIn[37] < 255) { // valid CCT/Kelvin value
+        uint16_t cct = udpIn[38];
+        if (udpIn[37] > 0) { //Kelvin
+          cct |= (udpIn[37] << 8);
+        }
+        strip.setCCT(cct);
+      }
+    }
+  }
+
+  bool timebaseUpdated = false;
+  //apply effects from notification
+  bool applyEffects = (receiveNotificationEffects || !someSel);
+  if (version < 200)
+  {
+    if (applyEffects && currentPlaylist >= 0) unloadPlaylist();
+    if (version > 10 && (receiveSegmentOptions || receiveSegmentBounds)) {
+      uint8_t numSrcSegs = udpIn[39];
+      for (size_t i = 0; i < numSrcSegs; i++) {
+        uint16_t ofs = 41 + i*udpIn[40]; //start of segment offset byte
+        if (udpIn[0 +ofs] > strip.getSegmentsNum()) break;
+        applySyncSegment(udpIn + ofs, version, applyEffects, someSel);
+      }
+      stateChanged = true;
+    }
+
+    // simple effect sync, applies to all selected segments
+    if (applyEffects && (version < 11 || !receiveSegmentOptions)) {
+      for (size_t i = 0; i < strip.getSegmentsNum(); i++) {
+        Segment& seg = strip.getSegment(i);
+        if (!seg.isActive() || !seg.isSelected()) continue;
+        seg.setMode(udpIn[8]);
+        seg.speed = udpIn[9];
+        if (version > 2) seg.intensity = udpIn[16];
+        if (version > 4) seg.setPalette(udpIn[19]);
+      }
+      stateChanged = true;
+    }
+
+    if (applyEffects && version > 5) {
+      uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
+      t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
+      t -= millis();
+      strip.timebase = t;
+      timebaseUpdated = true;
+    }
+  }
+
+  //adjust system time, but only if sender is more accurate than self
+  if (version > 7 && version < 200) applySyncTime(udpIn + 29, timebaseUpdated);
+
+  if (version > 3)
+  {
+    transitionDelayTemp = ((udpIn[17] << 0) & 0xFF) + ((udpIn[18] << 8) & 0xFF00);
+  }
+
+  nightlightActive = udpIn[6];
+  if (nightlightActive) nightlightDelayMins = udpIn[7];
+
+  if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
+  stateUpdated(CALL_MODE_NOTIFICATION);
+}
+
+// WLEDMM sync notification received by another transport (ESP-NOW)
+void handleSyncPacket(const byte* data, size_t len)
+{
+  if (len < 41 || data[0] != 0 || realtimeMode || !receiveNotifications) return;
+  if (len < 41 + size_t(data[39]) * data[40]) return; // segments incomplete
+  handleNotifierPacket(data);
+}
+
 #ifdef ARDUINO_ARCH_ESP32
 // WLEDMM don't use dynamic arrays for receiving UDP. ESP32 has enough RAM, and handleNotifications() is only called from main loop, so one static buffer should be enough.
 static uint8_t lbuf[UDP_IN_MAXSIZE+1];
@@ -245,6 +654,10 @@ void handleNotifications()
   IPAddress localIP;
 
   //send second notification if enabled
+  #ifndef WLED_DISABLE_SYNC_DELTA
+  if (udpConnected && syncDelta) handleDeltaRetransmit(); // WLEDMM repeat only what receivers did not ACK
+  else
+  #endif
   if(udpConnected && (notificationCount < udpNumRetries) && ((millis()-notificationSentTime) > 250)){
     notify(notificationSentCallMode,true);
   }
@@ -314,9 +727,9 @@ void handleNotifications()
   }
 
 #ifdef ARDUINO_ARCH_ESP32
-  if (!(receiveNotifications || receiveDirect)) {notifierUdp.flush(); notifier2Udp.flush(); return;}
+  if (!(receiveNotifications || receiveDirect || syncDelta)) {notifierUdp.flush(); notifier2Udp.flush(); return;} // WLEDMM delta sync needs ACKs
 #else
-  if (!(receiveNotifications || receiveDirect)) {return;}
+  if (!(receiveNotifications || receiveDirect || syncDelta)) {return;}
 #endif
 
   localIP = Network.localIP();
@@ -367,162 +780,18 @@ void handleNotifications()
     return;
   }
 
+  #ifndef WLED_DISABLE_SYNC_DELTA
+  // WLEDMM delta sync and ACKs
+  if (!isSupp && (udpIn[0] == UDP_SYNC_DELTA || udpIn[0] == UDP_SYNC_ACK)) {
+    handleDeltaPacket(udpIn, len, notifierUdp.remoteIP());
+    return;
+  }
+  #endif
+
   //wled notifier, ignore if realtime packets active
   if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
   {
-    //ignore notification if received within a second after sending a notification ourselves
-    if (millis() - notificationSentTime < 1000) return;
-    if (udpIn[1] > 199) return; //do not receive custom versions
-
-    //compatibilityVersionByte:
-    byte version = udpIn[11];
-
-    // if we are not part of any sync group ignore message
-    if (version < 9 || version > 199) {
-      // legacy senders are treated as if sending in sync group 1 only
-      if (!(receiveGroups & 0x01)) return;
-    } else if (!(receiveGroups & udpIn[36])) return;
-
-    bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
-
-    //apply colors from notification to main segment, only if not syncing full segments
-    if ((receiveNotificationColor || !someSel) && (version < 11 || !receiveSegmentOptions)) {
-      // primary color, only apply white if intended (version > 0)
-      strip.setColor(0, RGBW32(udpIn[3], udpIn[4], udpIn[5], (version > 0) ? udpIn[10] : 0));
-      if (version > 1) {
-        strip.setColor(1, RGBW32(udpIn[12], udpIn[13], udpIn[14], udpIn[15])); // secondary color
-      }
-      if (version > 6) {
-        strip.setColor(2, RGBW32(udpIn[20], udpIn[21], udpIn[22], udpIn[23])); // tertiary color
-        if (version > 9 && version < 200 && udpIn[37] < 255) { // valid CCT/Kelvin value
-          uint16_t cct = udpIn[38];
-          if (udpIn[37] > 0) { //Kelvin
-            cct |= (udpIn[37] << 8);
-          }
-          strip.setCCT(cct);
-        }
-      }
-    }
-
-    bool timebaseUpdated = false;
-    //apply effects from notification
-    bool applyEffects = (receiveNotificationEffects || !someSel);
-    if (version < 200)
-    {
-      if (applyEffects && currentPlaylist >= 0) unloadPlaylist();
-      if (version > 10 && (receiveSegmentOptions || receiveSegmentBounds)) {
-        uint8_t numSrcSegs = udpIn[39];
-        for (size_t i = 0; i < numSrcSegs; i++) {
-          uint16_t ofs = 41 + i*udpIn[40]; //start of segment offset byte
-          uint8_t id = udpIn[0 +ofs];
-          if (id > strip.getSegmentsNum()) break;
-
-          Segment& selseg = strip.getSegment(id);
-          if (!selseg.isActive() || !selseg.isSelected()) continue; //do not apply to non selected segments
-
-          uint16_t startY = 0, start  = (udpIn[1+ofs] << 8 | udpIn[2+ofs]);
-          uint16_t stopY  = 1, stop   = (udpIn[3+ofs] << 8 | udpIn[4+ofs]);
-          uint16_t offset = (udpIn[7+ofs] << 8 | udpIn[8+ofs]);
-          if (!receiveSegmentOptions) {
-            selseg.setUp(start, stop, selseg.grouping, selseg.spacing, offset, startY, stopY);
-            continue;
-          }
-          //for (size_t j = 1; j<4; j++) selseg.setOption(j, (udpIn[9 +ofs] >> j) & 0x01); //only take into account mirrored, on, reversed; ignore selected
-          selseg.options = (selseg.options & 0x0071U) | (udpIn[9 +ofs] & 0x0E); // ignore selected, freeze, reset & transitional
-          selseg.setOpacity(udpIn[10+ofs]);
-          if (applyEffects) {
-            strip.setMode(id,  udpIn[11+ofs]);
-            selseg.speed     = udpIn[12+ofs];
-            selseg.intensity = udpIn[13+ofs];
-            selseg.palette   = udpIn[14+ofs];
-          }
-          if (receiveNotificationColor || !someSel) {
-            selseg.setColor(0, RGBW32(udpIn[15+ofs],udpIn[16+ofs],udpIn[17+ofs],udpIn[18+ofs]));
-            selseg.setColor(1, RGBW32(udpIn[19+ofs],udpIn[20+ofs],udpIn[21+ofs],udpIn[22+ofs]));
-            selseg.setColor(2, RGBW32(udpIn[23+ofs],udpIn[24+ofs],udpIn[25+ofs],udpIn[26+ofs]));
-            selseg.setCCT(udpIn[27+ofs]);
-          }
-          if (version > 11) {
-            // when applying synced options ignore selected as it may be used as indicator of which segments to sync
-            // freeze, reset should never be synced
-            // LSB to MSB: select, reverse, on, mirror, freeze, reset, reverse_y, mirror_y, transpose, map1d2d (3), ssim (2), set (2)
-            selseg.options = (selseg.options & 0b0000000000110001U) | (udpIn[28+ofs]<<8) | (udpIn[9 +ofs] & 0b11001110U); // ignore selected, freeze, reset
-            if (applyEffects) {
-              selseg.custom1 = udpIn[29+ofs];
-              selseg.custom2 = udpIn[30+ofs];
-              selseg.custom3 = udpIn[31+ofs] & 0x1F;
-              selseg.check1  = (udpIn[31+ofs]>>5) & 0x1;
-              selseg.check1  = (udpIn[31+ofs]>>6) & 0x1;
-              selseg.check1  = (udpIn[31+ofs]>>7) & 0x1;
-            }
-            startY = (udpIn[32+ofs] << 8 | udpIn[33+ofs]);
-            stopY  = (udpIn[34+ofs] << 8 | udpIn[35+ofs]);
-          }
-          if (receiveSegmentBounds) {
-            selseg.setUp(start, stop, udpIn[5+ofs], udpIn[6+ofs], offset, startY, stopY);
-          } else {
-            selseg.setUp(selseg.start, selseg.stop, udpIn[5+ofs], udpIn[6+ofs], selseg.offset, selseg.startY, selseg.stopY);
-          }
-        }
-        stateChanged = true;
-      }
-
-      // simple effect sync, applies to all selected segments
-      if (applyEffects && (version < 11 || !receiveSegmentOptions)) {
-        for (size_t i = 0; i < strip.getSegmentsNum(); i++) {
-          Segment& seg = strip.getSegment(i);
-          if (!seg.isActive() || !seg.isSelected()) continue;
-          seg.setMode(udpIn[8]);
-          seg.speed = udpIn[9];
-          if (version > 2) seg.intensity = udpIn[16];
-          if (version > 4) seg.setPalette(udpIn[19]);
-        }
-        stateChanged = true;
-      }
-
-      if (applyEffects && version > 5) {
-        uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
-        t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
-        t -= millis();
-        strip.timebase = t;
-        timebaseUpdated = true;
-      }
-    }
-
-    //adjust system time, but only if sender is more accurate than self
-    if (version > 7 && version < 200)
-    {
-      Toki::Time tm;
-      tm.sec = (udpIn[30] << 24) | (udpIn[31] << 16) | (udpIn[32] << 8) | (udpIn[33]);
-      tm.ms = (udpIn[34] << 8) | (udpIn[35]);
-      if (udpIn[29] > toki.getTimeSource()) { //if sender's time source is more accurate
-        toki.adjust(tm, PRESUMED_NETWORK_DELAY); //adjust trivially for network delay
-        uint8_t ts = TOKI_TS_UDP;
-        if (udpIn[29] > 99) ts = TOKI_TS_UDP_NTP;
-        else if (udpIn[29] >= TOKI_TS_SEC) ts = TOKI_TS_UDP_SEC;
-        toki.setTime(tm, ts);
-      } else if (timebaseUpdated && toki.getTimeSource() > 99) { //if we both have good times, get a more accurate timebase
-        Toki::Time myTime = toki.getTime();
-        uint32_t diff = toki.msDifference(tm, myTime);
-        strip.timebase -= PRESUMED_NETWORK_DELAY; //no need to presume, use difference between NTP times at send and receive points
-        if (toki.isLater(tm, myTime)) {
-          strip.timebase += diff;
-        } else {
-          strip.timebase -= diff;
-        }
-      }
-    }
-
-    if (version > 3)
-    {
-      transitionDelayTemp = ((udpIn[17] << 0) & 0xFF) + ((udpIn[18] << 8) & 0xFF00);
-    }
-
-    nightlightActive = udpIn[6];
-    if (nightlightActive) nightlightDelayMins = udpIn[7];
-
-    if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
-    stateUpdated(CALL_MODE_NOTIFICATION);
+    handleNotifierPacket(udpIn);
     return;
   }
 
@@ -649,9 +918,9 @@ void handleNotifications()
 }
 
 
-void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
+void setRealtimePixel(pixel_index_t i, byte r, byte g, byte b, byte w)
 {
-  uint16_t pix = i + arlsOffset;
+  unsigned pix = i + arlsOffset;
   if (pix < strip.getLengthTotal()) {
     if (!arlsDisableGammaCorrection && gammaCorrectCol) {
       r = gamma8(r);
@@ -781,6 +1050,54 @@ void sendSysInfoUDP()
 static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
 static const byte   ART_NET_HEADER[12] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
 
+// WLEDMM E1.31 (sACN) output
+// universes are numbered from WLED_E131_OUT_UNIVERSE, with the same outputs / LEDs per output layout as Art-Net.
+// If the bus IP is a multicast address (239.x.x.x), each universe goes to its own group 239.255.<hi>.<lo>.
+#ifndef WLED_E131_OUT_UNIVERSE
+#define WLED_E131_OUT_UNIVERSE      1
+#endif
+#ifndef WLED_E131_OUT_PRIORITY
+#define WLED_E131_OUT_PRIORITY      100   // sACN default priority (0..200)
+#endif
+#ifndef WLED_E131_OUT_SYNC_UNIVERSE
+#define WLED_E131_OUT_SYNC_UNIVERSE 0     // 0 = no universe synchronization
+#endif
+#define E131_OUT_HEADER_LEN  126          // root + framing + DMP layer, including the DMX start code
+#define E131_OUT_SYNC_LEN    49
+static const byte   E131_ROOT_HEADER[16] PROGMEM = {0x00,0x10,0x00,0x00,0x41,0x53,0x43,0x2d,0x45,0x31,0x2e,0x31,0x37,0x00,0x00,0x00}; // preamble, postamble, "ASC-E1.17"
+
+static inline void e131Put16(byte* p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; } // network byte order
+
+static inline IPAddress e131Destination(IPAddress client, uint16_t universe) {
+  if (client[0] != 239) return client; // unicast
+  return IPAddress(239, 255, universe >> 8, universe & 0xFF);
+}
+
+// fills everything that does not change from packet to packet (length fields, sequence and universe are patched before sending)
+static void e131BuildTemplate(byte* packet, bool sync) {
+  memset(packet, 0, E131_OUT_HEADER_LEN);
+  memcpy_P(packet, E131_ROOT_HEADER, sizeof(E131_ROOT_HEADER));
+  packet[21] = sync ? 0x08 : 0x04;                        // root vector: VECTOR_ROOT_E131_EXTENDED / VECTOR_ROOT_E131_DATA
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  memcpy_P(packet+22, PSTR("WLEDMMsACN"), 10);            // CID: constant per device
+  memcpy(packet+32, mac, 6);
+  if (sync) {
+    packet[43] = 0x01;                                    // VECTOR_E131_EXTENDED_SYNCHRONIZATION
+    e131Put16(packet+45, WLED_E131_OUT_SYNC_UNIVERSE);
+    e131Put16(packet+16, 0x7000 | (E131_OUT_SYNC_LEN - 16));
+    e131Put16(packet+38, 0x7000 | (E131_OUT_SYNC_LEN - 38));
+    return;
+  }
+  packet[43] = 0x02;                                      // VECTOR_E131_DATA_PACKET
+  strlcpy((char*)packet+44, serverDescription, 64);       // source name
+  packet[108] = WLED_E131_OUT_PRIORITY;
+  e131Put16(packet+109, WLED_E131_OUT_SYNC_UNIVERSE);
+  packet[117] = 0x02;                                     // VECTOR_DMP_SET_PROPERTY
+  packet[118] = 0xA1;                                     // address & data type
+  e131Put16(packet+121, 0x0001);                          // address increment
+}
+
 #if defined(ARDUINO_ARCH_ESP32P4)
 extern "C" {
   int p4_mul16x16(uint8_t* outpacket, uint8_t* brightness, uint16_t num_loops, uint8_t* pixelbuffer);
@@ -861,13 +1178,19 @@ uint8_t IRAM_ATTR_YN realtimeBroadcast(uint8_t type, IPAddress client, uint16_t
         /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
         /*9*/ddpUdp.write(0xFF & (packetSize     ));
 
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
+        if (bri == 255) {
+          // WLEDMM buffer was already scaled by the bus output pass - send the whole slice in one call
+          ddpUdp.write(buffer + bufferOffset, packetSize);
+          bufferOffset += packetSize;
+        } else {
+          // write the colors, the write write(const uint8_t *buffer, size_t size)
+          // function is just a loop internally too
+          for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
+            ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
+            ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
+            ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
+            if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
+          }
         }
 
         if (!ddpUdp.endPacket()) {
@@ -881,6 +1204,76 @@ uint8_t IRAM_ATTR_YN realtimeBroadcast(uint8_t type, IPAddress client, uint16_t
 
     case 1: //E1.31
     {
+      // WLEDMM sACN sender - pacing like Art-Net below
+      static unsigned long e131limiter = micros()+(1000000/fps_limit);
+      while (e131limiter > micros()) {
+        delayMicroseconds(100);
+      }
+      unsigned long timer = micros();
+
+      static byte *e131_packet = nullptr;
+      static byte  e131_sync[E131_OUT_SYNC_LEN];
+      static byte  e131SequenceNumber = 0;
+      if (e131_packet == nullptr) {
+        #ifdef ESP32
+        e131_packet = (byte *) heap_caps_calloc_prefer(E131_OUT_HEADER_LEN + 512, sizeof(byte), 2, MALLOC_CAP_DEFAULT, MALLOC_CAP_SPIRAM);
+        #else
+        e131_packet = (byte *) calloc(E131_OUT_HEADER_LEN + 512, sizeof(byte));
+        #endif
+        if (e131_packet == nullptr) return 1; // out of memory
+        e131BuildTemplate(e131_packet, false);
+        e131BuildTemplate(e131_sync, true);
+      }
+
+      AsyncUDP e131udp;
+
+      const uint_fast16_t E131_CHANNELS_PER_PACKET = isRGBW?512:510; // whole pixels per universe
+      const uint_fast16_t channelCount = length * (isRGBW?4:3);
+      uint_fast16_t bufferOffset = 0;
+      uint_fast16_t universe = WLED_E131_OUT_UNIVERSE;
+      e131SequenceNumber++;
+
+      for (uint_fast16_t hardware_output = 0; hardware_output < outputs && bufferOffset < channelCount; hardware_output++) {
+        uint_fast16_t channels_remaining = min(uint_fast16_t(leds_per_output * (isRGBW?4:3)), uint_fast16_t(channelCount - bufferOffset));
+
+        while (channels_remaining > 0) {
+          uint_fast16_t packetSize = min(channels_remaining, E131_CHANNELS_PER_PACKET);
+          channels_remaining -= packetSize;
+          size_t packetLen = E131_OUT_HEADER_LEN + packetSize;
+
+          // patch the parts that change
+          e131Put16(e131_packet+16,  0x7000 | (packetLen - 16));  // root layer length
+          e131Put16(e131_packet+38,  0x7000 | (packetLen - 38));  // framing layer length
+          e131_packet[111] = e131SequenceNumber;
+          e131Put16(e131_packet+113, universe);
+          e131Put16(e131_packet+115, 0x7000 | (packetLen - 115)); // DMP layer length
+          e131Put16(e131_packet+123, packetSize + 1);             // property values incl. start code
+
+          if (bri == 255) {
+            memcpy(e131_packet+E131_OUT_HEADER_LEN, buffer+bufferOffset, packetSize);
+          } else {
+            for (uint_fast16_t i = 0; i < packetSize; i++) e131_packet[E131_OUT_HEADER_LEN+i] = scale8(buffer[bufferOffset+i], bri);
+          }
+          bufferOffset += packetSize;
+
+          if (!e131udp.writeTo(e131_packet, packetLen, e131Destination(client, universe), E131_DEFAULT_PORT)) {
+            DEBUG_PRINTLN(F("E1.31 e131udp.writeTo() returned an error"));
+            return 1;
+          }
+          universe++;
+        }
+      }
+
+      #if WLED_E131_OUT_SYNC_UNIVERSE > 0
+      // receivers hold the frame until all universes have arrived
+      e131_sync[44] = e131SequenceNumber;
+      if (!e131udp.writeTo(e131_sync, E131_OUT_SYNC_LEN, e131Destination(client, WLED_E131_OUT_SYNC_UNIVERSE), E131_DEFAULT_PORT)) {
+        DEBUG_PRINTLN(F("E1.31 sync e131udp.writeTo() returned an error"));
+        return 1;
+      }
+      #endif
+
+      e131limiter = timer + (1000000/fps_limit);
     } break;
     case 2: //Art-Net
     {
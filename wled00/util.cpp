@@ -213,13 +213,48 @@ bool isAsterisksOnly(const char* str, byte maxLen)
 
 
 //threading/network callback details: https://github.com/Aircoookie/WLED/pull/2336#discussion_r762276994
-bool requestJSONBufferLock(uint8_t module)
+// WLEDMM per-module usage statistics (see serializeJSONBufferStats())
+static struct {
+  uint16_t locks;   // global "doc" acquired
+  uint16_t leases;  // pool document used
+  uint16_t fails;   // error 3
+  uint16_t maxWait; // ms
+} jsonLockStats[JSON_LOCK_MODULES] = {{0}};
+
+static inline uint8_t jsonStatsIndex(uint8_t module) { return module < JSON_LOCK_MODULES ? module : 0; }
+
+#ifdef ARDUINO_ARCH_ESP32
+// WLEDMM block on a semaphore instead of spinning on delay(1) - the waiting task does not steal CPU time from the lock holder
+static StaticSemaphore_t jsonBufferSemBuffer;
+static SemaphoreHandle_t jsonBufferSem = nullptr;
+static portMUX_TYPE jsonPoolMux = portMUX_INITIALIZER_UNLOCKED;
+
+static SemaphoreHandle_t getJSONBufferSem() {
+  if (jsonBufferSem == nullptr) {
+    portENTER_CRITICAL(&jsonPoolMux);
+    if (jsonBufferSem == nullptr) jsonBufferSem = xSemaphoreCreateCountingStatic(1, 1, &jsonBufferSemBuffer); // no malloc
+    portEXIT_CRITICAL(&jsonPoolMux);
+  }
+  return jsonBufferSem;
+}
+#endif
+
+// WLEDMM timeout 0 = try once, without counting or reporting a failure
+static bool lockJSONBuffer(uint8_t module, unsigned timeout)
 {
   unsigned long now = millis();
-
-  while (jsonBufferLock && millis()-now < 1100) delay(1); // wait for fraction for buffer lock
-
-  if (jsonBufferLock) {
+  uint8_t idx = jsonStatsIndex(module);
+
+#ifdef ARDUINO_ARCH_ESP32
+  bool locked = (xSemaphoreTake(getJSONBufferSem(), pdMS_TO_TICKS(timeout)) == pdTRUE);
+#else
+  while (jsonBufferLock && millis()-now < timeout) delay(1); // wait for fraction for buffer lock
+  bool locked = !jsonBufferLock;
+#endif
+
+  if (!locked) {
+    if (timeout == 0) return false; // caller retries later
+    jsonLockStats[idx].fails++;
     USER_PRINT(F("ERROR: Locking JSON buffer failed! (still locked by "));
     USER_PRINT(jsonBufferLock);
     USER_PRINTLN(")");
@@ -227,6 +262,8 @@ bool requestJSONBufferLock(uint8_t module)
   }
 
   jsonBufferLock = module ? module : 255;
+  jsonLockStats[idx].locks++;
+  jsonLockStats[idx].maxWait = max(jsonLockStats[idx].maxWait, uint16_t(millis() - now));
   DEBUG_PRINT(F("JSON buffer locked. ("));
   DEBUG_PRINT(jsonBufferLock);
   DEBUG_PRINTLN(")");
@@ -235,6 +272,17 @@ bool requestJSONBufferLock(uint8_t module)
   return true;
 }
 
+bool requestJSONBufferLock(uint8_t module)
+{
+  return lockJSONBuffer(module, 1100);
+}
+
+// WLEDMM for the loop: take the lock only if nobody (writer or pool reader) holds it, never wait
+bool tryJSONBufferLock(uint8_t module)
+{
+  return lockJSONBuffer(module, 0);
+}
+
 
 void releaseJSONBufferLock()
 {
@@ -243,6 +291,251 @@ void releaseJSONBufferLock()
   DEBUG_PRINTLN(")");
   fileDoc = nullptr;
   jsonBufferLock = 0;
+#ifdef ARDUINO_ARCH_ESP32
+  xSemaphoreGive(getJSONBufferSem()); // counting semaphore with max 1 - a second release is harmless
+#endif
+}
+
+
+// WLEDMM pool of JSON documents for read-only users
+// returns slot number (0 = global "doc", 1..WLED_JSON_POOL_SIZE = pool) or -1 if nothing could be acquired
+#if WLED_JSON_POOL_SIZE > 0
+static JsonDocument* jsonPool[WLED_JSON_POOL_SIZE] = {nullptr};
+static volatile bool jsonPoolBusy[WLED_JSON_POOL_SIZE] = {false};
+static uint8_t jsonReaders = 0; // pool users currently holding the JSON lock together (guarded by jsonPoolMux)
+
+// readers share the JSON lock: the first one takes it, the last one gives it back. Writers (requestJSONBufferLock)
+// still get it exclusively, so state is never serialized while a request is changing it.
+static bool requestJSONReadLock(uint8_t module, bool wait) {
+  unsigned long now = millis();
+  uint8_t idx = jsonStatsIndex(module);
+  do {
+    bool joined = false;
+    portENTER_CRITICAL(&jsonPoolMux);
+    if (jsonReaders > 0) { jsonReaders++; joined = true; }
+    portEXIT_CRITICAL(&jsonPoolMux);
+    if (!joined && (xSemaphoreTake(getJSONBufferSem(), wait ? pdMS_TO_TICKS(10) : 0) == pdTRUE)) {
+      portENTER_CRITICAL(&jsonPoolMux);
+      jsonReaders++;
+      portEXIT_CRITICAL(&jsonPoolMux);
+      joined = true;
+    }
+    if (joined) {
+      jsonLockStats[idx].maxWait = max(jsonLockStats[idx].maxWait, uint16_t(millis() - now));
+      return true;
+    }
+  } while (wait && (millis() - now < 1100));
+  if (!wait) return false; // caller retries later
+  jsonLockStats[idx].fails++;
+  USER_PRINT(F("ERROR: Locking JSON buffer for reading failed! (still locked by "));
+  USER_PRINT(jsonBufferLock);
+  USER_PRINTLN(")");
+  return false;
+}
+
+static void releaseJSONReadLock() {
+  portENTER_CRITICAL(&jsonPoolMux);
+  bool last = (jsonReaders > 0) && (--jsonReaders == 0);
+  portEXIT_CRITICAL(&jsonPoolMux);
+  if (last) xSemaphoreGive(getJSONBufferSem());
+}
+
+static inline bool jsonPoolKeep() {
+  #if defined(BOARD_HAS_PSRAM) && (defined(WLED_USE_PSRAM) || defined(WLED_USE_PSRAM_JSON))
+  return psramFound(); // keep PSRAM documents, give RAM back to the heap
+  #else
+  return false;
+  #endif
+}
+#endif
+
+// wait = false: give up at once when a writer holds the lock (for callers that can retry, like chunked responses)
+int8_t leaseJSONBuffer(uint8_t module, JsonDocument** leasedDoc, bool wait)
+{
+  *leasedDoc = nullptr;
+#if WLED_JSON_POOL_SIZE > 0
+  for (int i = 0; i < WLED_JSON_POOL_SIZE; i++) {
+    bool claimed = false;
+    portENTER_CRITICAL(&jsonPoolMux);
+    if (!jsonPoolBusy[i]) { jsonPoolBusy[i] = true; claimed = true; }
+    portEXIT_CRITICAL(&jsonPoolMux);
+    if (!claimed) continue;
+
+    if (jsonPool[i] == nullptr && (jsonPoolKeep() || ESP.getMaxAllocHeap() > JSON_BUFFER_SIZE + MIN_HEAP_SIZE)) {
+      jsonPool[i] = new(std::nothrow) PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+      if (jsonPool[i] && jsonPool[i]->capacity() == 0) { delete jsonPool[i]; jsonPool[i] = nullptr; } // allocation failed
+    }
+    if (jsonPool[i] == nullptr) { jsonPoolBusy[i] = false; break; } // low memory - use global doc
+    if (!requestJSONReadLock(module, wait)) { jsonPoolBusy[i] = false; return -1; } // a writer holds the lock
+    jsonPool[i]->clear();
+    jsonLockStats[jsonStatsIndex(module)].leases++;
+    *leasedDoc = jsonPool[i];
+    return i + 1;
+  }
+#endif
+  // pool exhausted (or not available) - wait for the global doc
+  if (!lockJSONBuffer(module, wait ? 1100 : 0)) return -1;
+  *leasedDoc = &doc;
+  return 0;
+}
+
+void returnJSONBuffer(int8_t slot)
+{
+  if (slot == 0) { releaseJSONBufferLock(); return; }
+#if WLED_JSON_POOL_SIZE > 0
+  if (slot < 1 || slot > WLED_JSON_POOL_SIZE) return;
+  int i = slot - 1;
+  if (!jsonPoolKeep() && jsonPool[i]) { delete jsonPool[i]; jsonPool[i] = nullptr; }
+  jsonPoolBusy[i] = false;
+  releaseJSONReadLock();
+#endif
+}
+
+// WLEDMM JSON buffer statistics for /json/info: pool size, pool documents in use, and [module, locks, leases, fails, max wait ms] per module
+void serializeJSONBufferStats(JsonObject root)
+{
+  root[F("pool")] = WLED_JSON_POOL_SIZE;
+  unsigned busy = 0;
+#if WLED_JSON_POOL_SIZE > 0
+  for (int i = 0; i < WLED_JSON_POOL_SIZE; i++) if (jsonPoolBusy[i]) busy++;
+#endif
+  root[F("busy")] = busy;
+  root[F("lock")] = jsonBufferLock;
+  JsonArray mods = root.createNestedArray(F("mod"));
+  for (unsigned m = 0; m < JSON_LOCK_MODULES; m++) {
+    if (jsonLockStats[m].locks == 0 && jsonLockStats[m].leases == 0 && jsonLockStats[m].fails == 0) continue;
+    JsonArray e = mods.createNestedArray();
+    e.add(m); e.add(jsonLockStats[m].locks); e.add(jsonLockStats[m].leases); e.add(jsonLockStats[m].fails); e.add(jsonLockStats[m].maxWait);
+  }
+}
+
+
+// WLEDMM memory placement: large buffers say how often they are touched (WLED_MEM_HOT/WARM/COLD), this decides where they go.
+// On boards without PSRAM everything stays in the normal heap. The owner names are only used for the startup report.
+#define MEM_PLACEMENT_SLOTS 24
+static struct {
+  const char* owner;
+  uint8_t  tier;
+  uint16_t count;
+  uint32_t internal; // bytes, including reallocations
+  uint32_t psram;
+} memPlacement[MEM_PLACEMENT_SLOTS] = {{nullptr}};
+
+// allocations happen in the loop, async_tcp and the audio/DMX tasks
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE memPlacementMux = portMUX_INITIALIZER_UNLOCKED;
+#define MEM_PLACEMENT_LOCK()   portENTER_CRITICAL(&memPlacementMux)
+#define MEM_PLACEMENT_UNLOCK() portEXIT_CRITICAL(&memPlacementMux)
+#else
+#define MEM_PLACEMENT_LOCK()    // ESP8266 callbacks do not interrupt loop()
+#define MEM_PLACEMENT_UNLOCK()
+#endif
+
+static void notePlacement(const char* owner, uint8_t tier, size_t size, bool inPsram) {
+  MEM_PLACEMENT_LOCK();
+  for (unsigned i = 0; i < MEM_PLACEMENT_SLOTS; i++) {
+    if (memPlacement[i].owner && strcmp(memPlacement[i].owner, owner) != 0) continue;
+    memPlacement[i].owner = owner;
+    memPlacement[i].tier  = tier;
+    memPlacement[i].count++;
+    if (inPsram) memPlacement[i].psram += size; else memPlacement[i].internal += size;
+    break;
+  }
+  MEM_PLACEMENT_UNLOCK();
+}
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM)
+static bool tieredWantsPsram(size_t size, uint8_t tier) {
+  if (!psramFound()) return false;
+  if (tier == WLED_MEM_COLD) return true;
+  size_t reserve = (tier == WLED_MEM_HOT) ? WLED_MEM_HOT_RESERVE : WLED_MEM_WARM_RESERVE;
+  return heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) < size + reserve;
+}
+#define MEM_CAPS(psram) ((psram) ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT))
+#endif
+
+void* tieredMalloc(size_t size, uint8_t tier, const char* owner) {
+  if (size == 0) return nullptr;
+  void* ptr = nullptr;
+  bool inPsram = false;
+  #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM)
+  if (psramFound()) {
+    inPsram = tieredWantsPsram(size, tier);
+    ptr = heap_caps_malloc(size, MEM_CAPS(inPsram));
+    if (!ptr) { inPsram = !inPsram; ptr = heap_caps_malloc(size, MEM_CAPS(inPsram)); } // better the wrong place than nothing
+  } else
+  #endif
+  ptr = malloc(size);
+  if (ptr) notePlacement(owner, tier, size, inPsram);
+  return ptr;
+}
+
+void* tieredCalloc(size_t count, size_t size, uint8_t tier, const char* owner) {
+  void* ptr = tieredMalloc(count * size, tier, owner);
+  if (ptr) memset(ptr, 0, count * size);
+  return ptr;
+}
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+// same for SIMD buffers that must start on an "align" boundary - release them with free() as usual
+void* tieredAlignedCalloc(size_t align, size_t count, size_t size, uint8_t tier, const char* owner) {
+  size_t len = count * size;
+  if (len == 0) return nullptr;
+  bool inPsram = false;
+  uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+  #if defined(BOARD_HAS_PSRAM)
+  if (psramFound()) { inPsram = tieredWantsPsram(len, tier); caps = MEM_CAPS(inPsram); }
+  #endif
+  void* ptr = heap_caps_aligned_alloc(align, len, caps);
+  #if defined(BOARD_HAS_PSRAM)
+  if (!ptr && psramFound()) { inPsram = !inPsram; ptr = heap_caps_aligned_alloc(align, len, MEM_CAPS(inPsram)); }
+  #endif
+  if (ptr) {
+    memset(ptr, 0, len);
+    notePlacement(owner, tier, len, inPsram);
+  }
+  return ptr;
+}
+#endif
+
+void* tieredRealloc(void* ptr, size_t size, uint8_t tier, const char* owner) {
+  if (ptr == nullptr) return tieredMalloc(size, tier, owner);
+  if (size == 0) { free(ptr); return nullptr; }
+  void* newPtr = nullptr;
+  bool inPsram = false;
+  #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM)
+  if (psramFound()) {
+    inPsram = tieredWantsPsram(size, tier);
+    newPtr = heap_caps_realloc(ptr, size, MEM_CAPS(inPsram)); // moves the buffer if it is in the wrong place
+    if (!newPtr) { inPsram = !inPsram; newPtr = heap_caps_realloc(ptr, size, MEM_CAPS(inPsram)); }
+  } else
+  #endif
+  newPtr = realloc(ptr, size);
+  if (newPtr) notePlacement(owner, tier, size, inPsram);
+  else free(ptr);
+  return newPtr;
+}
+
+// startup report - what went where
+void printMemoryPlacement() {
+  static const char tierNames[][5] = {"hot", "warm", "cold"};
+  USER_PRINTLN(F("\nMemory placement  tier  count   internal     PSRAM"));
+  for (unsigned i = 0; i < MEM_PLACEMENT_SLOTS; i++) {
+    MEM_PLACEMENT_LOCK();
+    auto entry = memPlacement[i]; // consistent copy - no printing inside the critical section
+    MEM_PLACEMENT_UNLOCK();
+    if (!entry.owner) break;
+    USER_PRINTF("  %-15s %-5s %5u %10u %9u\n", entry.owner, tierNames[min(entry.tier, uint8_t(2))],
+                entry.count, entry.internal, entry.psram);
+  }
+  #if defined(ARDUINO_ARCH_ESP32)
+  USER_PRINTF("  free internal %u (largest block %u)", heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT), heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+  #if defined(BOARD_HAS_PSRAM)
+  if (psramFound()) USER_PRINTF(", free PSRAM %u", ESP.getFreePsram());
+  #endif
+  USER_PRINTLN();
+  #endif
+  USER_FLUSH();
 }
 
 
@@ -252,17 +545,9 @@ uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLe
 {
   if (src == JSON_mode_names || src == nullptr) {
     if (mode < strip.getModeCount()) {
-      char lineBuffer[256] = { '\0' };
-      //strcpy_P(lineBuffer, (const char*)pgm_read_dword(&(WS2812FX::_modeData[mode])));
-      strncpy_P(lineBuffer, strip.getModeData(mode), sizeof(lineBuffer)/sizeof(char)-1);
-      lineBuffer[sizeof(lineBuffer)/sizeof(char)-1] = '\0'; // terminate string
-      size_t len = strlen(lineBuffer);
-      size_t j = 0;
-      for (; j < maxLen && j < len; j++) {
-        if (lineBuffer[j] == '\0' || lineBuffer[j] == '@') break;
-        dest[j] = lineBuffer[j];
-      }
-      dest[j] = 0; // terminate string
+      size_t len = min(strip.getModeNameLen(mode), maxLen); // WLEDMM name length is precomputed
+      strncpy_P(dest, strip.getModeData(mode), len);
+      dest[len] = 0; // terminate string
       return strlen(dest);
     } else return 0;
   }
@@ -382,6 +667,9 @@ uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxL
 // extracts mode parameter defaults from last section of mode data (e.g. "Juggle@!,Trail;!,!,;!;sx=16,ix=240,1d")
 int16_t extractModeDefaults(uint8_t mode, const char *segVar)
 {
+  int16_t value = strip.getModeDefault(mode, segVar); // WLEDMM precomputed when the effect was added
+  if (value != -2) return value;
+  // key is not indexed - parse effect data string
   if (mode < strip.getModeCount()) {
     char lineBuffer[256] = { '\0' };
     strncpy_P(lineBuffer, strip.getModeData(mode), sizeof(lineBuffer)/sizeof(char)-1);
@@ -480,6 +768,8 @@ um_data_t* simulateSound(uint8_t simulationId)
   static uint16_t volumeRaw;
   static float    my_magnitude;
   static uint16_t zeroCrossingCount = 0; // number of zero crossings in the current batch of 512 samples
+  static float    beatBpm;
+  static uint8_t  beatPhase, beatConfidence, beatCount;
 
   //arrays
   uint8_t *fftResult;
@@ -494,7 +784,7 @@ um_data_t* simulateSound(uint8_t simulationId)
     // NOTE!!!
     // This may change as AudioReactive usermod may change
     um_data = new um_data_t;
-    um_data->u_size = 12;
+    um_data->u_size = 16;
     um_data->u_type = new um_types_t[um_data->u_size];
     um_data->u_data = new void*[um_data->u_size];
     um_data->u_data[0] = &volumeSmth;
@@ -509,6 +799,10 @@ um_data_t* simulateSound(uint8_t simulationId)
     um_data->u_data[9]  = &volumeSmth;    // dummy (soundPressure)
     um_data->u_data[10] = &volumeSmth;    // dummy (agcSensitivity)
     um_data->u_data[11] = &zeroCrossingCount;
+    um_data->u_data[12] = &beatBpm;
+    um_data->u_data[13] = &beatPhase;
+    um_data->u_data[14] = &beatConfidence;
+    um_data->u_data[15] = &beatCount;
   } else {
     // get arrays from um_data
     fftResult =  (uint8_t*)um_data->u_data[2];
@@ -576,6 +870,10 @@ um_data_t* simulateSound(uint8_t simulationId)
   my_magnitude = 10000.0f / 8.0f; //no idea if 10000 is a good value for FFT_Magnitude ???
   if (volumeSmth < 1 ) my_magnitude = 0.001f;             // noise gate closed - mute
   zeroCrossingCount = floorf(FFT_MajorPeak / 36.0f); // 9Khz max frequency => 255 zero crossings
+  beatBpm        = 120.0f;                   // steady 120 BPM beat
+  beatPhase      = (ms % 500) * 256 / 500;
+  beatConfidence = 255;
+  beatCount      = ms / 500;
 
   return um_data;
 }
@@ -135,6 +135,21 @@ void WLED::loop()
   if (!suspendStripService) {
   #endif
     handleNotifications();
+    #ifdef WLED_ENABLE_FRAMESYNC
+    handleFrameSync();
+    #endif
+    #ifdef WLED_ENABLE_ESPNOW_SYNC
+    handleEspNowSync();
+    #endif
+    #ifdef WLED_ENABLE_SEQUENCER
+    handleSequencer();
+    #endif
+    #ifdef WLED_ENABLE_FSEQ
+    handleFseqPlayer();
+    #endif
+    #ifdef WLED_ENABLE_RTREC
+    handleRtRecorder();
+    #endif
     handleTransitions();
   #if defined(ARDUINO_ARCH_ESP32) && defined(WLEDMM_PROTECT_SERVICE)  // WLEDMM end 
   }
@@ -885,6 +900,7 @@ void WLED::setup()
   USER_PRINTLN(F("\n"));
 #endif
 
+  printMemoryPlacement(); // WLEDMM what went where
   USER_PRINT(F("Free heap ")); USER_PRINTLN(ESP.getFreeHeap());USER_PRINTLN();
   USER_PRINTLN(F("WLED initialization done.\n"));
   delay(50);
@@ -962,6 +978,12 @@ void WLED::initAP(bool resetAP)
     if (udpPort2 > 0 && udpPort2 != ntpLocalPort && udpPort2 != udpPort && udpPort2 != udpRgbPort) {
       udp2Connected = notifier2Udp.begin(udpPort2);
     }
+    #ifdef WLED_ENABLE_FRAMESYNC
+    initFrameSync();
+    #endif
+    #ifdef WLED_ENABLE_SEQUENCER
+    initSequencer();
+    #endif
     e131.begin(false, e131Port, e131Universe, E131_MAX_UNIVERSE_COUNT);
     ddp.begin(false, DDP_DEFAULT_PORT);
 
@@ -1227,6 +1249,12 @@ void WLED::initInterfaces()
     if (udpConnected && udpPort2 != udpPort && udpPort2 != udpRgbPort)
       udp2Connected = notifier2Udp.begin(udpPort2);
   }
+  #ifdef WLED_ENABLE_FRAMESYNC
+  initFrameSync();
+  #endif
+  #ifdef WLED_ENABLE_SEQUENCER
+  initSequencer();
+  #endif
   if (ntpEnabled)
     ntpConnected = ntpUdp.begin(ntpLocalPort);
 
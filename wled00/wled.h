@@ -423,6 +423,16 @@ WLED_GLOBAL bool irApplyToAllSelected _INIT(true); //apply IR to all selected se
 WLED_GLOBAL uint16_t udpPort    _INIT(21324); // WLED notifier default port
 WLED_GLOBAL uint16_t udpPort2   _INIT(65506); // WLED notifier supplemental port
 WLED_GLOBAL uint16_t udpRgbPort _INIT(19446); // Hyperion port
+#ifdef WLED_ENABLE_FRAMESYNC
+WLED_GLOBAL byte     frameSyncMode _INIT(FRAMESYNC_OFF); // WLEDMM frame-locked rendering across controllers
+WLED_GLOBAL uint16_t frameSyncPort _INIT(21330);
+#endif
+#ifdef WLED_ENABLE_SEQUENCER
+WLED_GLOBAL uint16_t seqPort _INIT(21331);       // WLEDMM show sequencer timecode (0 = off)
+#endif
+#ifdef WLED_ENABLE_ESPNOW_SYNC
+WLED_GLOBAL byte     espNowSyncMode _INIT(0);    // WLEDMM ESP-NOW transport for sync and pixels (ESPNOW_SYNC_* bits)
+#endif
 
 WLED_GLOBAL uint8_t syncGroups    _INIT(0x01);                    // sync groups this instance syncs (bit mapped)
 WLED_GLOBAL uint8_t receiveGroups _INIT(0x01);                    // sync receive groups this instance belongs to (bit mapped)
@@ -437,6 +447,7 @@ WLED_GLOBAL bool notifyAlexa  _INIT(false);                       // send notifi
 WLED_GLOBAL bool notifyMacro  _INIT(false);                       // send notification for macro
 WLED_GLOBAL bool notifyHue    _INIT(true);                        // send notification if Hue light changes
 WLED_GLOBAL uint8_t udpNumRetries _INIT(0);                       // Number of times a UDP sync message is retransmitted. Increase to increase reliability
+WLED_GLOBAL bool    syncDelta _INIT(false);                           // WLEDMM send only changed segments, repeat until ACKed (WLED-MM receivers only)
 
 WLED_GLOBAL bool alexaEnabled _INIT(false);                       // enable device discovery by Amazon Echo
 WLED_GLOBAL char alexaInvocationName[33] _INIT("Light");          // speech control name of device. Choose something voice-to-text can understand
@@ -474,6 +485,7 @@ WLED_GLOBAL uint16_t DMXSegmentSpacing _INIT(0);                  // Number of v
 //WLED_GLOBAL byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT]; // to detect packet loss // WLEDMM move into e131.cpp - array is not used anywhere else
 WLED_GLOBAL bool e131Multicast _INIT(false);                      // multicast or unicast
 WLED_GLOBAL bool e131SkipOutOfSequence _INIT(false);              // freeze instead of flickering
+WLED_GLOBAL byte e131MergeMode _INIT(DMX_MERGE_OFF);              // WLEDMM merge several E1.31/Art-Net sources (HTP/LTP) per universe
 WLED_GLOBAL uint16_t pollReplyCount _INIT(0);                     // count number of replies for ArtPoll node report
 
 // mqtt
@@ -681,6 +693,7 @@ WLED_GLOBAL bool useMainSegmentOnly _INIT(false);
 
 WLED_GLOBAL unsigned long lastInterfaceUpdate _INIT(0);
 WLED_GLOBAL byte interfaceUpdateCallMode _INIT(CALL_MODE_INIT);
+WLED_GLOBAL volatile uint32_t stateRevision _INIT(1); // WLEDMM incremented on every state update (cache validation, "rev" in WS messages)
 
 // alexa udp
 WLED_GLOBAL String escapedMac;
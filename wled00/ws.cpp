@@ -7,7 +7,28 @@
 
 static volatile uint16_t wsLiveClientId = 0;        // WLEDMM added "static"
 static volatile unsigned long wsLastLiveTime = 0;   // WLEDMM
-//uint8_t* wsFrameBuffer = nullptr;
+static bool wsLiveCompressed = false;               // WLEDMM client requested compressed live stream ("lvc")
+static int  wsLiveSegment = -1;                     // WLEDMM segment to stream, -1 = whole strip ("lvseg")
+
+// WLEDMM clients that requested delta updates ({"delta":true}) only get changed state fields and segments on broadcast
+#define WS_TRACKED_CLIENTS 16   // more than DEFAULT_MAX_WS_CLIENTS
+#define WS_DELTA_KEYS      24   // top-level state keys
+typedef struct { uint32_t id; bool delta; bool resync; } WsTrackedClient; // resync: a delta was lost, next broadcast is a full one
+static WsTrackedClient wsClients[WS_TRACKED_CLIENTS] = {{0, false, false}};
+static uint8_t  wsDeltaClients = 0;
+static bool     wsDeltaReset = true;                         // next delta is relative to an empty state
+static struct { uint32_t key; uint32_t value; } wsKeyHash[WS_DELTA_KEYS];
+static uint32_t wsSegHash[MAX_NUM_SEGMENTS];                 // 0 = segment did not exist
+
+// client table is changed by async_tcp (connect / disconnect / subscribe) while sendDataWs() walks it in the loop
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE wsClientsMux = portMUX_INITIALIZER_UNLOCKED;
+#define WS_CLIENTS_LOCK()   portENTER_CRITICAL(&wsClientsMux)
+#define WS_CLIENTS_UNLOCK() portEXIT_CRITICAL(&wsClientsMux)
+#else
+#define WS_CLIENTS_LOCK()   // ESP8266 async callbacks do not interrupt loop()
+#define WS_CLIENTS_UNLOCK()
+#endif
 
 #if !defined(ARDUINO_ARCH_ESP32) || defined(WLEDMM_FASTPATH)   // WLEDMM
 #define WS_LIVE_INTERVAL_MAX 120
@@ -17,15 +38,337 @@ static volatile unsigned long wsLastLiveTime = 0;   // WLEDMM
 #define WS_LIVE_INTERVAL_MIN 40
 #endif
 
+static void wsTrackClient(uint32_t id, bool connected, bool delta = false) {
+  WS_CLIENTS_LOCK();
+  int slot = -1;
+  for (int i = 0; i < WS_TRACKED_CLIENTS; i++) {
+    if (wsClients[i].id == id) { slot = i; break; }
+    if (slot < 0 && wsClients[i].id == 0) slot = i;
+  }
+  if (slot >= 0) { // table full - client only gets full updates (if there are no delta clients)
+    if (!connected) { wsClients[slot].id = 0; wsClients[slot].delta = false; }
+    else {
+      if (delta && (wsClients[slot].id != id || !wsClients[slot].delta)) wsDeltaReset = true; // new subscriber starts from a full snapshot
+      wsClients[slot].id = id; wsClients[slot].delta = delta;
+    }
+    wsClients[slot].resync = false;
+    wsDeltaClients = 0;
+    for (int i = 0; i < WS_TRACKED_CLIENTS; i++) if (wsClients[i].id && wsClients[i].delta) wsDeltaClients++;
+  }
+  WS_CLIENTS_UNLOCK();
+}
+
+static void wsSetResync(uint32_t id, bool resync) {
+  WS_CLIENTS_LOCK();
+  for (int i = 0; i < WS_TRACKED_CLIENTS; i++) if (wsClients[i].id == id) wsClients[i].resync = resync;
+  WS_CLIENTS_UNLOCK();
+}
+
+// serialized state fields and segments that changed since the last broadcast, empty if nothing changed
+// (hash tables are only used from the loop)
+static String buildStateDelta(JsonObject state, bool reset) {
+  if (reset) {
+    memset(wsKeyHash, 0, sizeof(wsKeyHash));
+    memset(wsSegHash, 0, sizeof(wsSegHash));
+  }
+  String out;
+  bool changed = false;
+  out.reserve(256);
+  out = F("{\"rev\":"); out += uint32_t(stateRevision); out += F(",\"delta\":true,\"state\":{");
+  bool first = true;
+  for (JsonPair kv : state) {
+    if (strcmp_P(kv.key().c_str(), PSTR("seg")) == 0) continue;
+    uint32_t key = 2166136261UL; // FNV-1a of key name
+    for (const char* c = kv.key().c_str(); *c; c++) key = (key ^ uint8_t(*c)) * 16777619UL;
+    uint32_t value = hashJson(kv.value());
+    int slot = -1;
+    for (int i = 0; i < WS_DELTA_KEYS; i++) {
+      if (wsKeyHash[i].key == key) { slot = i; break; }
+      if (slot < 0 && wsKeyHash[i].key == 0) slot = i;
+    }
+    if (slot >= 0 && wsKeyHash[slot].key == key && wsKeyHash[slot].value == value) continue; // unchanged
+    if (slot >= 0) { wsKeyHash[slot].key = key; wsKeyHash[slot].value = value; }
+    if (!first) out += ',';
+    out += '"'; out += kv.key().c_str(); out += F("\":");
+    serializeJson(kv.value(), out);
+    first = false; changed = true;
+  }
+  // segments by id, removed segments are sent as {"id":n,"stop":0} (same as JSON API)
+  bool seen[MAX_NUM_SEGMENTS] = {false};
+  bool firstSeg = true;
+  for (JsonObject seg : state["seg"].as<JsonArray>()) {
+    unsigned id = seg["id"] | 0;
+    if (id >= MAX_NUM_SEGMENTS) continue;
+    seen[id] = true;
+    uint32_t value = hashJson(seg) | 1; // never 0
+    if (wsSegHash[id] == value) continue;
+    wsSegHash[id] = value;
+    out += firstSeg ? (first ? F("\"seg\":[") : F(",\"seg\":[")) : F(",");
+    serializeJson(seg, out);
+    firstSeg = false; changed = true;
+  }
+  for (unsigned id = 0; id < MAX_NUM_SEGMENTS; id++) {
+    if (seen[id] || wsSegHash[id] == 0) continue;
+    wsSegHash[id] = 0;
+    out += firstSeg ? (first ? F("\"seg\":[") : F(",\"seg\":[")) : F(",");
+    out += F("{\"id\":"); out += id; out += F(",\"stop\":0}");
+    firstSeg = false; changed = true;
+  }
+  if (!firstSeg) out += ']';
+  out += F("}}");
+  return changed ? out : String();
+}
+
+static bool wsSendCopy(uint32_t id, const char* data, size_t len) {
+  AsyncWebSocketClient * wsc = ws.client(id);
+  if (!wsc || len < 1 || wsc->queueIsFull()) return false; // message would be dropped
+  AsyncWebSocketBuffer buffer(len);
+  if (!buffer || !buffer.data()) {
+    errorFlag = ERR_LOW_WS_MEM;
+    return false; //out of memory
+  }
+  memcpy(buffer.data(), data, len);
+  wsc->text(std::move(buffer));
+  return true;
+}
+
+// WLEDMM reassembly of messages that arrive in several frames or packets
+#ifndef WS_MAX_MESSAGE
+#define WS_MAX_MESSAGE  (JSON_BUFFER_SIZE/2)  // largest message we accept
+#endif
+#define WS_MSG_TIMEOUT  2000                  // ms - an unfinished message from another client is discarded after this time
+static uint8_t* wsMsgBuffer = nullptr;
+static size_t   wsMsgLen = 0;
+static size_t   wsMsgCap = 0;
+static uint32_t wsMsgClient = 0;
+static unsigned long wsMsgTime = 0;
+
+static void* wsMsgAlloc(size_t size) {
+  return tieredMalloc(size, WLED_MEM_COLD, "ws messages");
+}
+
+static void wsMsgFree() {
+  if (wsMsgBuffer) free(wsMsgBuffer);
+  wsMsgBuffer = nullptr;
+  wsMsgLen = 0;
+  wsMsgCap = 0;
+  wsMsgClient = 0;
+}
+
+// handle one complete JSON text message
+static void wsHandleJson(AsyncWebSocketClient * client, uint8_t *data, size_t len)
+{
+  bool verboseResponse = false;
+  if (!requestJSONBufferLock(11)) {
+    client->text(F("{\"error\":3}")); // ERR_NOBUF
+    return;
+  }
+
+  DeserializationError error = deserializeJson(doc, data, len);
+  JsonObject root = doc.as<JsonObject>();
+  if (error || root.isNull()) {
+    releaseJSONBufferLock();
+    return;
+  }
+  if (root["v"] && root.size() == 1) {
+    //if the received value is just "{"v":true}", send only to this client
+    verboseResponse = true;
+  } else if (root.containsKey("lv")) {
+    wsLiveClientId = root["lv"] ? client->id() : 0;
+    wsLiveCompressed = root["lvc"] | false;
+    wsLiveSegment = root["lvseg"] | -1;
+  } else if (root.containsKey("delta")) {
+    wsTrackClient(client->id(), true, root["delta"] | false);
+    verboseResponse = true; // full snapshot to start from
+  } else {
+    verboseResponse = deserializeState(root);
+  }
+  releaseJSONBufferLock(); // will clean fileDoc
+
+  if (!interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
+    if (verboseResponse) {
+      sendDataWs(client);
+    } else {
+      // we have to send something back otherwise WS connection closes
+      client->text(F("{\"success\":true}"));
+    }
+    // force broadcast in 500ms after updating client
+    //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
+  }
+}
+
+/*
+ * WLEDMM binary control messages (single frame, first byte is the opcode) - decoded without JSON
+ *   0x01 bri:      bri
+ *   0x02 segment:  seg id (255 = main segment), then (field, value lo, value hi) triplets - see WSB_F_*
+ *   0x03 colors:   seg id (255 = main segment), then up to 3 colors as r,g,b,w
+ *   0x04 preset:   preset id
+ *   0x05 live:     on, compressed, seg id (255 = whole strip)
+ *   0x7F bench:    iterations (lo, hi) - only with WLEDMM_WSBIN_BENCHMARK, replies {"bench":{...}}
+ * Errors are answered with the usual {"error":n} text message, success is not answered.
+ */
+#define WSB_OP_BRI      0x01
+#define WSB_OP_SEGMENT  0x02
+#define WSB_OP_COLORS   0x03
+#define WSB_OP_PRESET   0x04
+#define WSB_OP_LIVE     0x05
+#define WSB_OP_BENCH    0x7F
+
+#define WSB_F_ON        0
+#define WSB_F_OPACITY   1
+#define WSB_F_FX        2   // effect, keep slider values
+#define WSB_F_FXDEF     3   // effect, load effect defaults
+#define WSB_F_SPEED     4
+#define WSB_F_INTENSITY 5
+#define WSB_F_C1        6
+#define WSB_F_C2        7
+#define WSB_F_C3        8
+#define WSB_F_PALETTE   9
+#define WSB_F_CCT       10
+#define WSB_F_O1        11
+#define WSB_F_O2        12
+#define WSB_F_O3        13
+
+static Segment* wsbSegment(uint8_t id) {
+  if (id == 255) id = strip.getMainSegmentId();
+  if (id >= strip.getSegmentsNum() || !strip.getSegment(id).isActive()) return nullptr;
+  return &strip.getSegment(id);
+}
+
+static bool wsbSetField(Segment &seg, uint8_t field, uint16_t value16) {
+  uint8_t value = min(value16, uint16_t(255)); // 8-bit fields - same limits as the JSON API
+  switch (field) {
+    case WSB_F_ON:        seg.setOption(SEG_OPTION_ON, value16); break;
+    case WSB_F_OPACITY:   seg.setOpacity(value); break;
+    case WSB_F_FX:
+    case WSB_F_FXDEF:     if (value16 < strip.getModeCount() && value16 != seg.mode) {
+                            if (currentPlaylist >= 0) unloadPlaylist();
+                            seg.setMode(value16, field == WSB_F_FXDEF);
+                          } break;
+    case WSB_F_SPEED:     if (seg.speed != value)     { seg.speed = value;     stateChanged = true; } break;
+    case WSB_F_INTENSITY: if (seg.intensity != value) { seg.intensity = value; stateChanged = true; } break;
+    case WSB_F_C1:        if (seg.custom1 != value)   { seg.custom1 = value;   stateChanged = true; } break;
+    case WSB_F_C2:        if (seg.custom2 != value)   { seg.custom2 = value;   stateChanged = true; } break;
+    case WSB_F_C3:        if (seg.custom3 != min(value, uint8_t(31))) { seg.custom3 = min(value, uint8_t(31)); stateChanged = true; } break;
+    case WSB_F_PALETTE:   if (seg.getLightCapabilities() & 1) seg.setPalette(value); break; // ignore palette for White and On/Off segments
+    case WSB_F_CCT:       seg.setCCT(value16); break; // 0-255 or Kelvin
+    case WSB_F_O1:        if (seg.check1 != bool(value16)) { seg.check1 = bool(value16); stateChanged = true; } break;
+    case WSB_F_O2:        if (seg.check2 != bool(value16)) { seg.check2 = bool(value16); stateChanged = true; } break;
+    case WSB_F_O3:        if (seg.check3 != bool(value16)) { seg.check3 = bool(value16); stateChanged = true; } break;
+    default: return false;
+  }
+  return true;
+}
+
+static byte wsbApplyOp(const uint8_t *data, size_t len, uint32_t clientId);
+
+// returns ERR_NONE or error code for {"error":n}
+// state changes take the JSON buffer lock and keep strip.service() out, same as deserializeState()
+static byte wsbApply(const uint8_t *data, size_t len, uint32_t clientId) {
+  if (len < 2) return ERR_JSON;
+  if (data[0] != WSB_OP_BRI && data[0] != WSB_OP_SEGMENT && data[0] != WSB_OP_COLORS) return wsbApplyOp(data, len, clientId); // no segment access
+  JSONBufferGuard guard(11);
+  if (!guard) return ERR_NOBUF;
+  suspendStripService = true; // temporarily lock out strip updates
+  if (strip.isServicing()) strip.waitUntilIdle();
+  byte err = wsbApplyOp(data, len, clientId);
+  suspendStripService = false;
+  return err;
+}
+
+static byte wsbApplyOp(const uint8_t *data, size_t len, uint32_t clientId) {
+  Segment *seg;
+  switch (data[0]) {
+    case WSB_OP_BRI:
+      bri = data[1];
+      break;
+    case WSB_OP_SEGMENT:
+      if (!(seg = wsbSegment(data[1]))) return ERR_JSON;
+      for (size_t i = 2; i + 3 <= len; i += 3) {
+        if (!wsbSetField(*seg, data[i], data[i+1] | (data[i+2] << 8))) return ERR_JSON;
+      }
+      break;
+    case WSB_OP_COLORS:
+      if (!(seg = wsbSegment(data[1]))) return ERR_JSON;
+      for (size_t i = 2, slot = 0; i + 4 <= len && slot < NUM_COLORS; i += 4, slot++) {
+        seg->setColor(slot, RGBW32(data[i], data[i+1], data[i+2], data[i+3]));
+      }
+      if (seg->mode == FX_MODE_STATIC) strip.trigger(); //instant refresh
+      break;
+    case WSB_OP_PRESET:
+      applyPreset(data[1], CALL_MODE_DIRECT_CHANGE); // async load from file system
+      return ERR_NONE;
+    case WSB_OP_LIVE:
+      wsLiveClientId   = data[1] ? clientId : 0;
+      wsLiveCompressed = (len > 2) && data[2];
+      wsLiveSegment    = (len > 3 && data[3] != 255) ? data[3] : -1;
+      return ERR_NONE;
+    default:
+      return ERR_JSON;
+  }
+  stateUpdated(CALL_MODE_DIRECT_CHANGE);
+  return ERR_NONE;
+}
+
+#ifdef WLEDMM_WSBIN_BENCHMARK
+// WLEDMM compare binary and JSON path for the same (unchanged) value, so no notifications are sent
+static void wsbBenchmark(AsyncWebSocketClient * client, uint16_t iterations) {
+  iterations = constrain(iterations, 1, 2000);
+  Segment &seg = strip.getMainSegment();
+  uint8_t msg[5] = { WSB_OP_SEGMENT, 255, WSB_F_SPEED, seg.speed, 0 };
+  char json[48];
+  snprintf_P(json, sizeof(json), PSTR("{\"seg\":{\"id\":%u,\"sx\":%u}}"), strip.getMainSegmentId(), seg.speed);
+
+  unsigned long t0 = micros();
+  for (unsigned i = 0; i < iterations; i++) wsbApply(msg, sizeof(msg), client->id());
+  unsigned long tBin = micros() - t0;
+
+  unsigned long tJson = 0;
+  unsigned long tLock = 0;
+  for (unsigned i = 0; i < iterations; i++) {
+    t0 = micros();
+    if (!requestJSONBufferLock(11)) break;
+    unsigned long t1 = micros();
+    deserializeJson(doc, json);
+    deserializeState(doc.as<JsonObject>());
+    releaseJSONBufferLock();
+    tLock += t1 - t0;
+    tJson += micros() - t0;
+  }
+
+  char reply[128];
+  snprintf_P(reply, sizeof(reply), PSTR("{\"bench\":{\"n\":%u,\"bin\":%lu,\"json\":%lu,\"lock\":%lu}}"), iterations, tBin, tJson, tLock);
+  USER_PRINTF("WS binary benchmark: %u x set speed: binary %lu us, JSON %lu us (lock %lu us)\n", iterations, tBin, tJson, tLock);
+  client->text(reply);
+}
+#endif
+
+static void wsHandleBinary(AsyncWebSocketClient * client, uint8_t *data, size_t len)
+{
+  if (len < 1) return;
+  #ifdef WLEDMM_WSBIN_BENCHMARK
+  if (data[0] == WSB_OP_BENCH) { wsbBenchmark(client, (len > 2) ? (data[1] | (data[2] << 8)) : 100); return; }
+  #endif
+  byte err = wsbApply(data, len, client->id());
+  if (err != ERR_NONE) {
+    char reply[16];
+    snprintf_P(reply, sizeof(reply), PSTR("{\"error\":%u}"), err);
+    client->text(reply);
+  }
+}
+
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
   if(type == WS_EVT_CONNECT){
     //client connected
     DEBUG_PRINTLN(F("WS client connected."));
+    wsTrackClient(client->id(), true);
     sendDataWs(client);
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
     if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    if (client->id() == wsMsgClient) wsMsgFree();
+    wsTrackClient(client->id(), false);
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     DEBUG_PRINTLN(F("WS event data."));
@@ -41,59 +384,50 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           client->text(F("pong"));
           return;
         }
-
-        bool verboseResponse = false;
-        if (!requestJSONBufferLock(11)) {
-          client->text(F("{\"error\":3}")); // ERR_NOBUF
+        wsHandleJson(client, data, len);
+      } else if (info->opcode == WS_BINARY) {
+        wsHandleBinary(client, data, len); // WLEDMM
+      }
+    } else {
+      //message is comprised of multiple frames or the frame is split into multiple packets
+      // WLEDMM reassemble up to WS_MAX_MESSAGE bytes (one message at a time)
+      if (info->index == 0 && info->num == 0) {
+        if (wsMsgBuffer && wsMsgClient != client->id() && millis() - wsMsgTime < WS_MSG_TIMEOUT) {
+          if (info->message_opcode == WS_TEXT) client->text(F("{\"error\":3}")); // another client is sending - try again
           return;
         }
-
-        DeserializationError error = deserializeJson(doc, data, len);
-        JsonObject root = doc.as<JsonObject>();
-        if (error || root.isNull()) {
-          releaseJSONBufferLock();
+        wsMsgFree();
+        if (info->message_opcode != WS_TEXT) return; // binary messages are not reassembled
+        if (info->final && info->len > WS_MAX_MESSAGE) {
+          client->text(F("{\"error\":9}")); // too large
           return;
         }
-        if (root["v"] && root.size() == 1) {
-          //if the received value is just "{"v":true}", send only to this client
-          verboseResponse = true;
-        } else if (root.containsKey("lv")) {
-          wsLiveClientId = root["lv"] ? client->id() : 0;
-        } else {
-          verboseResponse = deserializeState(root);
-        }
-        releaseJSONBufferLock(); // will clean fileDoc
-
-        if (!interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
-          if (verboseResponse) {
-            sendDataWs(client);
-          } else {
-            // we have to send something back otherwise WS connection closes
-            client->text(F("{\"success\":true}"));
-          }
-          // force broadcast in 500ms after updating client
-          //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
+        // single frame split into packets: we know the size, otherwise reserve the maximum
+        wsMsgCap = info->final ? info->len : WS_MAX_MESSAGE;
+        wsMsgClient = client->id();
+        wsMsgTime = millis();
+        wsMsgBuffer = (uint8_t*)wsMsgAlloc(wsMsgCap);
+        if (!wsMsgBuffer) {
+          client->text(F("{\"error\":3}")); // ERR_NOBUF
+          return;
         }
       }
-    } else {
-      //message is comprised of multiple frames or the frame is split into multiple packets
-      //if(info->index == 0){
-        //if (!wsFrameBuffer && len < 4096) wsFrameBuffer = new uint8_t[4096];
-      //}
-
-      //if (wsFrameBuffer && len < 4096 && info->index + info->)
-      //{
+      if (!wsMsgBuffer || wsMsgClient != client->id()) return; // not the message we are collecting (or dropped)
 
-      //}
+      if (wsMsgLen + len > wsMsgCap) {
+        wsMsgFree();
+        client->text(F("{\"error\":9}")); // too large - dropped
+        return;
+      }
+      memcpy(wsMsgBuffer + wsMsgLen, data, len);
+      wsMsgLen += len;
+      wsMsgTime = millis();
 
-      if((info->index + len) == info->len){
-        if(info->final){
-          if(info->message_opcode == WS_TEXT) {
-            client->text(F("{\"error\":9}")); //we do not handle split packets right now
-          }
-        }
+      if (info->final && (info->index + len) == info->len) {
+        DEBUG_PRINTF("WS multipart message complete (%u bytes).\n", wsMsgLen);
+        wsHandleJson(client, wsMsgBuffer, wsMsgLen); // strings in doc may point into wsMsgBuffer - free after handling
+        wsMsgFree();
       }
-      DEBUG_PRINTLN(F("WS multipart message."));
     }
   } else if(type == WS_EVT_ERROR){
     //error was received from the other end
@@ -111,7 +445,8 @@ void sendDataWs(AsyncWebSocketClient * client)
   DEBUG_PRINTF("sendDataWs\n");
   if (!ws.count()) return;
 
-  if (!requestJSONBufferLock(12)) {
+  JSONBufferLease lease(12); // WLEDMM read-only - use a pool document so we don't wait for "doc"
+  if (!lease) {
     if (client) {
       client->text(F("{\"error\":3}")); // ERR_NOBUF
     } else {
@@ -119,11 +454,13 @@ void sendDataWs(AsyncWebSocketClient * client)
     }
     return;
   }
+  JsonDocument& doc = *lease.doc();
 
   JsonObject state = doc.createNestedObject("state");
   serializeState(state);
   JsonObject info  = doc.createNestedObject("info");
   serializeInfo(info);
+  doc[F("rev")] = uint32_t(stateRevision); // WLEDMM
 
   size_t len = measureJson(doc);
   DEBUG_PRINTF("JSON buffer size: %u for WS request (%u).\n", doc.memoryUsage(), len);
@@ -148,7 +485,7 @@ void sendDataWs(AsyncWebSocketClient * client)
   size_t heap2 = 0; // ESP32 variants do not have the same issue and will work without checking heap allocation
   #endif
   if (!buffer || heap1-heap2<len) {
-    releaseJSONBufferLock();
+    lease.release();
     USER_PRINTLN(F("WS buffer allocation failed."));
     ws.closeAll(1013); //code 1013 = temporary overload, try again later
     ws.cleanupClients(0); //disconnect all clients to release memory
@@ -161,12 +498,29 @@ void sendDataWs(AsyncWebSocketClient * client)
   if (client) {
     client->text(std::move(buffer));
     DEBUG_PRINTLN(F("to a single client."));
+  } else if (wsDeltaClients > 0) {
+    // WLEDMM some clients only want changes - send one by one, from a snapshot of the client table
+    WsTrackedClient clients[WS_TRACKED_CLIENTS];
+    WS_CLIENTS_LOCK();
+    memcpy(clients, wsClients, sizeof(clients));
+    bool reset = wsDeltaReset;
+    wsDeltaReset = false;
+    WS_CLIENTS_UNLOCK();
+    String delta = buildStateDelta(state, reset);
+    for (unsigned i = 0; i < WS_TRACKED_CLIENTS; i++) {
+      if (clients[i].id == 0) continue;
+      if (!clients[i].delta) wsSendCopy(clients[i].id, (const char *)buffer.data(), len);
+      else if (clients[i].resync) {
+        // a previous delta was lost - the hashes are ahead of this client, so it gets everything again
+        if (wsSendCopy(clients[i].id, (const char *)buffer.data(), len)) wsSetResync(clients[i].id, false);
+      }
+      else if (delta.length() > 0 && !wsSendCopy(clients[i].id, delta.c_str(), delta.length())) wsSetResync(clients[i].id, true);
+    }
+    DEBUG_PRINTLN(F("to multiple clients (delta)."));
   } else {
     ws.textAll(std::move(buffer));
     DEBUG_PRINTLN(F("to multiple clients."));
   }
-
-  releaseJSONBufferLock();
 }
 
 // WLEDMM function to recover full-bright pixel (based on code from upstream alt-buffer, which is based on code from NeoPixelBrightnessBus)
@@ -286,7 +640,7 @@ static bool sendLiveLedsWs(uint32_t wsClient)  // WLEDMM added "static"
 
 void handleWs()
 {
-  if ((millis() - wsLastLiveTime) > (unsigned long)(max(WS_LIVE_INTERVAL_MIN, min((strip.getLengthTotal()/80), WS_LIVE_INTERVAL_MAX)))) //WLEDMM dynamic nr of peek frames per second
+  if ((millis() - wsLastLiveTime) > (unsigned long)(max(WS_LIVE_INTERVAL_MIN, min(int(strip.getLengthTotal()/80), WS_LIVE_INTERVAL_MAX)))) //WLEDMM dynamic nr of peek frames per second
   {
     #ifdef ESP8266
     ws.cleanupClients(3);
@@ -294,7 +648,7 @@ void handleWs()
     ws.cleanupClients();
     #endif
     bool success = true;
-    if (wsLiveClientId) success = sendLiveLedsWs(wsLiveClientId);
+    if (wsLiveClientId) success = wsLiveCompressed ? sendLiveStreamWs(wsLiveClientId, wsLiveSegment) : sendLiveLedsWs(wsLiveClientId);
     wsLastLiveTime = millis();
     if (!success) wsLastLiveTime -= 20; //try again in 20ms if failed due to non-empty WS queue
   }